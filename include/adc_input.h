@@ -0,0 +1,27 @@
+#ifndef ADC_INPUT_H_
+#define ADC_INPUT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "engine.h"
+
+#define ADC_SAMPLE_RATE_DEFAULT_HZ  20000
+
+// Frames per half of the circular DMA buffer, handed to the engine as a block.
+#define INPUT_BLOCK_FRAMES          32
+
+// Starts timer-triggered circular conversion of all five inputs at
+// AUDIO_OVERSAMPLE times rate_hz; audio is decimated back to rate_hz frames.
+// An input thread decimates and analyses every block as it completes.
+void StartInputSampling(uint32_t rate_hz);
+
+// Copies the most recently completed block into inputs[INPUT_BLOCK_FRAMES]
+// and the audio features as of its end. Never blocks, the same block is
+// repeated until the next one lands.
+void GetInputBlock(engine_inputs_t* inputs, engine_audio_features_t* audio);
+
+// Blocks the input thread did not get to before the DMA came back around to them.
+uint32_t GetInputOverruns(void);
+
+#endif  // ADC_INPUT_H_
@@ -0,0 +1,15 @@
+#ifndef APP_H_
+#define APP_H_
+
+#include <stdbool.h>
+
+// Puts every mode and output stage in its start state. Call once before the first AppStep().
+void AppInit(void);
+
+// One pass of the main loop: read an input block, render it, add blanking and
+// dwell points, slew limit it and write every output block that fills up
+// through the platform layer. A static scene that holds is built once into a
+// frame and looped by the platform instead. Returns false when the input has ended.
+bool AppStep(void);
+
+#endif  // APP_H_
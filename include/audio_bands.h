@@ -0,0 +1,50 @@
+#ifndef AUDIO_BANDS_H_
+#define AUDIO_BANDS_H_
+
+#include <stdint.h>
+
+#include "fixed_point.h"
+
+/*
+ * Band levels of the audio inputs for the modes to follow, from a bank of
+ * Goertzel filters on the mono mix. Each sample costs every band one
+ * multiply-accumulate. A band reads out after each block of its own
+ * length, two periods of its centre, so the bank is constant Q. Levels
+ * are log, smoothed with the same attack and release in every band. The
+ * blocks are rectangular, so a tone an octave or more from a band can
+ * still show in it, at most 13 dB down. The filters are generated by
+ * resources/audio/make_band_filters.py.
+ *
+ * Samples are 12-bit ADC counts.
+ */
+
+#define AUDIO_BANDS             8
+#define AUDIO_BANDS_COEF_BITS   30
+// Amplitude taken as 0 dB, a full-scale sine, and the octaves below it that map onto the levels.
+#define AUDIO_BANDS_FULL_SCALE_LOG2 11
+#define AUDIO_BANDS_RANGE_LOG2      10
+
+typedef struct audiobandfilter {
+    int32_t coef;               // 2 cos(2 PI centre / rate), Q30
+    uint16_t length;            // Samples per block
+    int16_t length_log2_q8;     // log2(length / 2), which turns the block's power into an amplitude
+    q15_t attack;               // Smoothing coefficients per block, towards a higher level
+    q15_t release;              // and a lower one
+} audio_band_filter_t;
+
+extern const audio_band_filter_t g_audio_band_filters[AUDIO_BANDS];
+
+typedef struct audiobands {
+    int32_t s1[AUDIO_BANDS];
+    int32_t s2[AUDIO_BANDS];
+    uint16_t count[AUDIO_BANDS];    // Samples into the current block
+    // Smoothed, Q15 over AUDIO_BANDS_RANGE_LOG2 octaves.
+    q15_t level[AUDIO_BANDS];
+} audio_bands_t;
+
+void AudioBandsInit(audio_bands_t* bands);
+
+// Runs one frame of the audio inputs, in ADC counts, through every band.
+void AudioBandsPush(audio_bands_t* bands, const int16_t left, const int16_t right);
+
+#endif  // AUDIO_BANDS_H_
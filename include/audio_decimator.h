@@ -0,0 +1,52 @@
+#ifndef AUDIO_DECIMATOR_H_
+#define AUDIO_DECIMATOR_H_
+
+#include <stdint.h>
+
+/*
+ * Fixed-point decimator for one oversampled audio channel. The ADC scans
+ * at AUDIO_OVERSAMPLE times the frame rate. A CIC filter (order
+ * AUDIO_CIC_ORDER) takes that down by AUDIO_CIC_DECIMATION. A symmetric
+ * FIR then takes the last factor of 2, low-passing at about a third of the
+ * frame rate and making up the CIC droop. resources/audio/make_decimator_fir.py
+ * generates the taps and prints the response.
+ *
+ * Samples in and out are 12-bit ADC counts. The filter runs on their
+ * offset from ADC_IN_MIDPOINT, so a silent input comes out at the midpoint.
+ */
+
+#define AUDIO_OVERSAMPLE        4
+#define AUDIO_CIC_ORDER         3
+#define AUDIO_CIC_DECIMATION    2
+#define AUDIO_FIR_DECIMATION    (AUDIO_OVERSAMPLE / AUDIO_CIC_DECIMATION)
+#define AUDIO_FIR_TAPS          31
+#define AUDIO_FIR_HALF_TAPS     ((AUDIO_FIR_TAPS + 1) / 2)
+#define AUDIO_FIR_COEF_BITS     15
+// CIC gain AUDIO_CIC_DECIMATION ^ AUDIO_CIC_ORDER, a power of two.
+#define AUDIO_CIC_GAIN_BITS     3
+
+_Static_assert(AUDIO_FIR_DECIMATION == 2, "The FIR taps are designed for decimation by 2");
+_Static_assert((1 << AUDIO_CIC_GAIN_BITS) == AUDIO_CIC_DECIMATION * AUDIO_CIC_DECIMATION * AUDIO_CIC_DECIMATION,
+               "AUDIO_CIC_GAIN_BITS out of date");
+
+extern const int16_t g_audio_fir_taps[AUDIO_FIR_HALF_TAPS];
+
+typedef struct audiodecimator {
+    // Integrators and combs wrap modulo 2^32, which the CIC cancels out exactly.
+    uint32_t integrator[AUDIO_CIC_ORDER];
+    uint32_t comb[AUDIO_CIC_ORDER];
+    // CIC outputs, each written twice so the FIR reads AUDIO_FIR_TAPS in a row from head.
+    int16_t history[2 * AUDIO_FIR_TAPS];
+    int head;
+} audio_decimator_t;
+
+void AudioDecimatorInit(audio_decimator_t* decimator);
+
+/*
+ * Filters AUDIO_OVERSAMPLE consecutive ADC samples of the channel, stride
+ * apart in samples (the channel count of an interleaved DMA buffer), into
+ * one frame's sample.
+ */
+int16_t AudioDecimate(audio_decimator_t* decimator, const uint16_t* samples, const int stride);
+
+#endif  // AUDIO_DECIMATOR_H_
@@ -0,0 +1,84 @@
+#ifndef BEAT_TRACKER_H_
+#define BEAT_TRACKER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "audio_bands.h"
+#include "fixed_point.h"
+#include "trig_lut.h"
+
+/*
+ * Onsets, tempo and beat phase from the band levels of audio_bands.h.
+ *
+ * Every BEAT_HOP frames the onset function is the rise of the band levels
+ * since the last hop, summed over the bands (spectral flux on the bank).
+ * An onset is a rise over twice its running mean plus BEAT_ONSET_FLOOR,
+ * then no other for BEAT_REFRACTORY_HOPS. The rise above the mean feeds a
+ * leaky autocorrelation over the lags of 60..180 BPM. Its peak, weighted
+ * towards 120 BPM against octave errors and refined between lags, sets
+ * the beat period, once it stands BEAT_ACF_PEAK times over the average.
+ *
+ * The beat phase is an oscillator at that period, a full turn a beat and
+ * 0 on the beat. Every hop a comb finds where in the period the onset
+ * history of the last BEAT_COMB_BEATS beats is strongest. Within an eighth
+ * of a beat of the phase, it pulls the phase in. Further off, it restarts
+ * the phase while unlocked, and is taken for off-beats once locked. The
+ * tracker locks after BEAT_LOCK_BEATS beats running where the phase held
+ * to the comb on its own, and beats are only flagged while locked.
+ */
+
+#define BEAT_HOP                256     // Frames, 12.8ms at 20kHz
+#define BEAT_HISTORY            256     // Hops of onset function kept, a power of two
+#define BEAT_MIN_LAG            26      // Hops, 180 BPM at 20kHz
+#define BEAT_MAX_LAG            78      // Hops, 60 BPM at 20kHz
+#define BEAT_NUM_LAGS           (BEAT_MAX_LAG - BEAT_MIN_LAG + 1)
+#define BEAT_PRIOR_LAG          39      // 120 BPM
+#define BEAT_ACF_DECAY_BITS     7       // Autocorrelation forgets over ~1.6s
+#define BEAT_MEAN_BITS          5       // Onset function mean over ~0.4s
+#define BEAT_ONSET_FLOOR        6144    // Q15 band level summed rise, about 11 dB
+#define BEAT_REFRACTORY_HOPS    8
+#define BEAT_COMB_BEATS         3       // Periods of onset history the beat phase is set from
+#define BEAT_COMB_PEAK          6       // Comb peak over its average offset, to set the phase at all
+#define BEAT_ACF_PEAK           4       // Autocorrelation peak over its average lag, to set the period
+#define BEAT_LOCK_BEATS         4
+#define BEAT_LOCK_MAX           6
+
+_Static_assert((BEAT_HISTORY & (BEAT_HISTORY - 1)) == 0, "BEAT_HISTORY is a ring of a power of two");
+_Static_assert(BEAT_COMB_BEATS * BEAT_MAX_LAG < BEAT_HISTORY, "Every comb period must be in the history");
+
+typedef struct beattracker {
+    q15_t previous[AUDIO_BANDS];    // Band levels at the last hop
+    int32_t mean;                   // Of the onset function
+    int16_t history[BEAT_HISTORY];  // Onset function above its mean, per hop
+    uint16_t head;
+    int32_t acf[BEAT_NUM_LAGS];
+    uint16_t hop_frames;
+    uint16_t refractory;
+    uint32_t period_q8;             // Beat period in hops, Q8
+    phase_t phase;
+    phase_t increment;              // Per frame
+    int16_t lock;
+    uint16_t missed_hops;           // Since the last beat, the comb disagreed with the phase
+    // Of the last frame pushed.
+    bool onset;
+    bool beat;
+    uint32_t onsets;
+    uint32_t beats;
+} beat_tracker_t;
+
+void BeatTrackerInit(beat_tracker_t* tracker);
+
+// One frame's band levels, as AudioBandsPush() left them.
+void BeatTrackerPush(beat_tracker_t* tracker, const q15_t* band_levels);
+
+// Beat period in frames, Q8.
+static inline uint32_t BeatTrackerPeriodQ8(const beat_tracker_t* tracker) {
+    return tracker->period_q8 * BEAT_HOP;
+}
+
+static inline bool BeatTrackerLocked(const beat_tracker_t* tracker) {
+    return tracker->lock >= BEAT_LOCK_BEATS;
+}
+
+#endif  // BEAT_TRACKER_H_
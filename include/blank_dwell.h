@@ -0,0 +1,76 @@
+#ifndef BLANK_DWELL_H_
+#define BLANK_DWELL_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "engine.h"
+
+/*
+ * Output-stage blanking and dwell. Looks at each point with its neighbours
+ * and repeats it where the galvos or the laser need time:
+ *   pre_blank    dark copies of the first lit point after a blanked move,
+ *                so the galvos settle before the laser turns on.
+ *   post_blank   dark copies of the last lit point before a blanked move,
+ *                so the laser is off before the galvos leave.
+ *   corner_dwell lit copies of a point where a lit path turns by more than
+ *                the corner angle, so the corner is drawn sharp.
+ * A point is dark when all three colour channels are 0. The window is the
+ * previous, current and next point, so the stream is delayed by one point.
+ * Positions are clamped to 0..LASER_POS_MAX on the way in, as the slew stage
+ * does.
+ */
+
+// Most copies of any one kind added to a single point.
+#define BLANK_DWELL_MAX_REPEAT      8
+// Points one input point can expand to: pre, the point, then post or dwell.
+#define BLANK_DWELL_MAX_EMIT        (2 * BLANK_DWELL_MAX_REPEAT + 1)
+
+#define BLANK_DWELL_DEFAULT_PRE     2
+#define BLANK_DWELL_DEFAULT_POST    2
+#define BLANK_DWELL_DEFAULT_DWELL   3
+// cos(60 deg): turns sharper than 60 degrees get a dwell.
+#define BLANK_DWELL_DEFAULT_CORNER  ((q15_t)(Q15_MAX / 2))
+
+typedef struct blankdwellconfig {
+    bool enabled;
+    int16_t pre_blank;      // All counts clamped to 0..BLANK_DWELL_MAX_REPEAT
+    int16_t post_blank;
+    int16_t corner_dwell;
+    q15_t corner_cos;       // Cosine of the turn angle above which a corner dwells
+} blank_dwell_config_t;
+
+typedef struct blankdwellpoint {
+    int16_t x;
+    int16_t y;
+    int16_t r;
+    int16_t g;
+    int16_t b;
+} blank_dwell_point_t;
+
+typedef struct blankdwell {
+    blank_dwell_config_t config;
+    // Window: last distinct position emitted, and the point waiting for its successor.
+    bool have_previous;
+    bool have_current;
+    blank_dwell_point_t previous;
+    blank_dwell_point_t current;
+    // Points decided on but not yet written because the output block filled.
+    blank_dwell_point_t queue[BLANK_DWELL_MAX_EMIT];
+    int16_t queue_head;
+    int16_t queue_count;
+    uint32_t points_in;
+    uint32_t points_out;
+} blank_dwell_t;
+
+void BlankDwellInit(blank_dwell_t* stage, const blank_dwell_config_t* config);
+
+/*
+ * Feeds in->x[first..n) through the stage, appending to out until it holds
+ * out_size points. Returns how many input points were consumed; points still
+ * queued when the output block fills go out on the next call.
+ */
+int BlankDwellBlock(blank_dwell_t* stage, const engine_output_block_t* in, int first, const int n,
+                    engine_output_block_t* out, int* out_count, const int out_size);
+
+#endif  // BLANK_DWELL_H_
@@ -0,0 +1,116 @@
+#ifndef COMPACT_SHOW_H_
+#define COMPACT_SHOW_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Compact show format for animations kept in flash. About 2-4 bytes a point
+ * against 10 for raw 16-bit XY+RGB (8 for ILDA format 5).
+ *
+ *   header   "PHCS", version, 0, num_frames (u16 LE)
+ *   offsets  num_frames x u32 LE, each frame's position in the blob
+ *   frame    varint num_points (at least 1), then colour runs until every
+ *            point is read
+ *   run      varint (length << 1 | lit), then R, G, B bytes if lit,
+ *            then length points
+ *   point    varint zigzag dx, varint zigzag dy from the previous point,
+ *            from (0, 0) for a frame's first point
+ *
+ * Varints are 7 bits a byte, low bits first. Positions are 12-bit DAC
+ * counts, colours 8 bits a channel played as 12-bit PWM levels.
+ *
+ * CompactShowOpen() walks every frame with bounds checks, after which
+ * CompactNextPoint() decodes without any: a few loads and adds per point,
+ * no allocation, cheap enough for the output ISR.
+ */
+
+#define COMPACT_SHOW_HEADER_SIZE    8
+#define COMPACT_SHOW_VERSION        1
+// 12-bit DAC counts, CompactShowOpen() rejects points outside 0..COMPACT_SHOW_POS_MAX.
+#define COMPACT_SHOW_POS_MAX        4095
+
+typedef struct compactshow {
+    const uint8_t* data;
+    size_t size;
+    uint16_t num_frames;    // 0 if the blob is not a valid compact show
+} compact_show_t;
+
+typedef struct compactcursor {
+    const uint8_t* at;
+    uint16_t points_left;   // In the current frame
+    uint16_t run_left;      // In the current colour run
+    int16_t x;
+    int16_t y;
+    int16_t r;
+    int16_t g;
+    int16_t b;
+} compact_cursor_t;
+
+typedef struct compactpoint {
+    int16_t x;
+    int16_t y;
+    int16_t r;
+    int16_t g;
+    int16_t b;
+} compact_point_t;
+
+/*
+ * Checks the header and decodes every frame with bounds checks. Returns
+ * false, leaving num_frames 0, if the blob is truncated or malformed.
+ */
+bool CompactShowOpen(compact_show_t* show, const uint8_t* data, const size_t size);
+
+// Moves the cursor to the first point of a frame, frame < num_frames.
+void CompactShowSeek(const compact_show_t* show, compact_cursor_t* cursor, const uint16_t frame);
+
+static inline uint32_t CompactReadVarint(const uint8_t** at) {
+    uint32_t value = 0;
+    unsigned shift = 0;
+    uint8_t byte;
+    do {
+        byte = *(*at)++;
+        value |= (uint32_t)(byte & 0x7Fu) << shift;
+        shift += 7;
+    } while (byte & 0x80u);
+    return value;
+}
+
+static inline int16_t CompactUnzigzag(const uint32_t value) {
+    return (int16_t)((value >> 1) ^ (0u - (value & 1u)));
+}
+
+// 8-bit colour to 12-bit PWM level, 255 -> 4095 exactly.
+static inline int16_t CompactColorLevel(const uint8_t value) {
+    return (int16_t)((value << 4) | (value >> 4));
+}
+
+// Decodes the next point of the frame. Returns false at the end of the frame.
+static inline bool CompactNextPoint(compact_cursor_t* cursor, compact_point_t* point) {
+    if (cursor->points_left == 0) {
+        return false;
+    }
+    if (cursor->run_left == 0) {
+        const uint32_t run = CompactReadVarint(&cursor->at);
+        cursor->run_left = (uint16_t)(run >> 1);
+        const bool lit = (run & 1u) != 0;
+        cursor->r = lit ? CompactColorLevel(cursor->at[0]) : 0;
+        cursor->g = lit ? CompactColorLevel(cursor->at[1]) : 0;
+        cursor->b = lit ? CompactColorLevel(cursor->at[2]) : 0;
+        cursor->at += lit ? 3 : 0;
+    }
+    cursor->x += CompactUnzigzag(CompactReadVarint(&cursor->at));
+    cursor->y += CompactUnzigzag(CompactReadVarint(&cursor->at));
+    --cursor->run_left;
+    --cursor->points_left;
+
+    point->x = cursor->x;
+    point->y = cursor->y;
+    point->r = cursor->r;
+    point->g = cursor->g;
+    point->b = cursor->b;
+    return true;
+}
+
+#endif  // COMPACT_SHOW_H_
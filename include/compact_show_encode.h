@@ -0,0 +1,35 @@
+#ifndef COMPACT_SHOW_ENCODE_H_
+#define COMPACT_SHOW_ENCODE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "compact_show.h"
+
+/*
+ * Host side writer for the compact show format, see compact_show.h. Frames
+ * are added in order into a caller's buffer; colours are 12-bit PWM levels
+ * and keep their top 8 bits, which CompactColorLevel() restores exactly for
+ * anything that came from an 8-bit source such as ILDA.
+ */
+
+typedef struct compactencoder {
+    uint8_t* out;
+    size_t capacity;
+    size_t size;
+    uint16_t num_frames;
+    uint16_t frame;         // Frames written so far
+    bool overflow;
+} compact_encoder_t;
+
+void CompactEncoderInit(compact_encoder_t* encoder, uint8_t* out, const size_t capacity, const uint16_t num_frames);
+
+// Appends the next frame, of at least one point. Positions are clamped to
+// 0..COMPACT_SHOW_POS_MAX.
+void CompactEncodeFrame(compact_encoder_t* encoder, const compact_point_t* points, const uint16_t n);
+
+// Returns the size of the show, or 0 if it did not fit or frames are missing.
+size_t CompactEncoderFinish(const compact_encoder_t* encoder);
+
+#endif  // COMPACT_SHOW_ENCODE_H_
@@ -1,10 +1,47 @@
 #ifndef DAC_MCP4822_H_
 #define DAC_MCP4822_H_
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #define DAC_OUT_MAX ((int16_t)0xFFF)
 
+// Command bits: channel select (15), 1x gain (13), active (12).
+#define DAC_CMD_GAIN_1X      (1 << 13)
+#define DAC_CMD_ACTIVE       (1 << 12)
+#define DAC_CMD_CH1          ((1 << 15) | DAC_CMD_GAIN_1X | DAC_CMD_ACTIVE)
+#define DAC_CMD_CH2          (DAC_CMD_GAIN_1X | DAC_CMD_ACTIVE)
+
+// Called from the SPI ISR right after LDAC falls, in a locked context.
+typedef void (*dac_latch_hook_t)(void);
+
 void InitDac(void);
 
+// Registers a hook to run on every LDAC latch, NULL to disable.
+void SetDacLatchHook(dac_latch_hook_t hook);
+
+// Clamps value to 0..DAC_OUT_MAX and merges the command bits. Written with
+// selects only so it compiles branch-free (USAT on Cortex-M3, min/max on host).
+static inline uint16_t DacCommandWord(int16_t value, const uint16_t cmd_bits) {
+  value = value < 0 ? 0 : value;
+  value = value > DAC_OUT_MAX ? DAC_OUT_MAX : value;
+  return (uint16_t)value | cmd_bits;
+}
+
+// Builds the 16-bit MCP4822 command word (1x gain, active) for one channel.
+uint16_t MakeCommandPacket(int16_t value, const bool is_left);
+
+// True once the last word pair has been latched and another can be queued.
+bool DacIdle(void);
+
+// Queues a pre-encoded ch1/ch2 word pair on SPI2/DMA. Returns false if the
+// previous pair is still in flight. Must be called from a locked or ISR context.
+bool TransmitWordsI(const uint16_t* words);
+
+// As TransmitWordsI() but encodes the two samples first.
+bool TransmitSamplesI(const int16_t ch1_out, const int16_t ch2_out);
+
+// Thread-context wrapper, waits for any pair in flight before queueing.
 void TransmitSamples(const int16_t ch1_out, const int16_t ch2_out);
 
 #endif  // DAC_MCP4822_H_
\ No newline at end of file
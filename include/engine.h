@@ -1,13 +1,80 @@
 #ifndef ENGINE_H_
 #define ENGINE_H_
 
+#include <stdbool.h>
 #include <stdint.h>
 
+#include "fixed_point.h"
+#include "audio_bands.h"
+#include "beat_tracker.h"
+#include "compact_show.h"
+#include "ilda.h"
+#include "spectrum.h"
+#include "trig_lut.h"
+
+// Selects the arithmetic of the amplitude envelopes, see engine_amp_t. 1 is
+// Q30, leaving no soft-float call per point; 0 is float, the reference the
+// host build checks the engine against, see engine_float.c.
+#ifndef ENGINE_FIXED_POINT
+#define ENGINE_FIXED_POINT 1
+#endif
+
 #define LASER_POS_MAX 4095
 #define LASER_MIDPOINT (LASER_POS_MAX/2)
 #define ADC_IN_MAX 4095
 #define ADC_IN_MIDPOINT  (ADC_IN_MAX / 2)
 #define AUDIO_IN_LEFT_MAX
+#define LASER_PWM_MAX 4095
+
+// Generator modes, each owns an equal slice of the middle CV range.
+#define ENGINE_NUM_MODES 9
+
+// CV counts either side of a mode boundary over which the two neighbouring
+// modes are rendered and crossfaded.
+#define ENGINE_CROSSFADE_HALF_WIDTH 64
+
+// Mode selection defaults, see mode_selector_config_t.
+#define ENGINE_MODE_HYSTERESIS_DEFAULT  24
+#define ENGINE_MODE_SETTLE_DEFAULT      4
+#define ENGINE_MODE_DEADBAND_DEFAULT    2
+
+// Largest block RunEngineBlock() renders per call.
+#define ENGINE_MAX_BLOCK 32
+
+// Longest closed loop a static scene may render as a frame, and the CV bits
+// dropped when deciding whether the scene has changed.
+#define ENGINE_FRAME_MAX_POINTS 256
+#define ENGINE_FRAME_CV_SHIFT 5
+
+/*
+ * What the engine hears in the audio inputs, one per block as of its last
+ * frame. Onsets, beats and spectra are running counts, a mode steps by the
+ * ones since the last block it drew.
+ */
+typedef struct engineaudiofeatures {
+    q15_t bands[AUDIO_BANDS];       // See audio_bands.h
+    phase_t beat_phase;             // See beat_tracker.h
+    uint32_t onsets;
+    uint32_t beats;                 // Only counted while the beat tracker is locked
+    q15_t spectrum[SPECTRUM_NUM_CHANNELS][SPECTRUM_NUM_BANDS];  // Of the last finished spectrum, see spectrum.h
+    uint32_t spectra;
+} engine_audio_features_t;
+
+/*
+ * The band bank, beat tracker and spectrum analyzer. They have to hear every
+ * frame the ADC delivers once, in order, so the platform runs them on the
+ * input side as the blocks arrive and hands the features on with the latest
+ * block. The engine may skip blocks while the output stages stretch a block
+ * into several, or repeat one, or draw another mode, and tempo, onsets and
+ * spectra still follow real time.
+ */
+typedef struct engineaudioanalyzer {
+    audio_bands_t bands;
+    beat_tracker_t tracker;
+    spectrum_analyzer_t spectrum;
+    engine_audio_features_t features;   // As of the last frame analysed
+    uint32_t frames;                    // Analysed so far
+} engine_audio_analyzer_t;
 
 typedef struct engineinputs {
     int16_t audio_in_left;
@@ -25,6 +92,18 @@ typedef struct engineoutputs {
     int16_t laser_pwm_output_b;
 } engine_outputs_t;
 
+/*
+ * A block of rendered points as struct-of-arrays, so per-channel passes
+ * (mixing, packing) run over contiguous int16_t and vectorize.
+ */
+typedef struct engineoutputblock {
+    int16_t x[ENGINE_MAX_BLOCK];
+    int16_t y[ENGINE_MAX_BLOCK];
+    int16_t r[ENGINE_MAX_BLOCK];
+    int16_t g[ENGINE_MAX_BLOCK];
+    int16_t b[ENGINE_MAX_BLOCK];
+} engine_output_block_t;
+
 typedef struct normalized_inputs {
     float audio_in_left;
     float audio_in_right;
@@ -41,6 +120,183 @@ typedef struct normalized_outputs {
     float laser_pwm_output_b;
 } normalized_outputs_t;
 
-void RunEngine(engine_inputs_t* inputs, engine_outputs_t* outputs);
+/*
+ * Amplitude envelopes are the only fractional state the modes keep. They are
+ * Q30 in the fixed-point build so they can overshoot 1.0 like the float ones.
+ */
+#if ENGINE_FIXED_POINT
+typedef q30_t engine_amp_t;
+#else
+typedef float engine_amp_t;
+#endif
+
+// Per-mode state, one struct per stateful mode.
+typedef struct modestateaudiomono {
+    int16_t x_value;
+} mode_state_audio_mono_t;
+
+typedef struct modestatespinningcoin {
+    phase_t t;
+    phase_t color_phase;
+    engine_amp_t amplitude;
+    bool rising;
+} mode_state_spinning_coin_t;
+
+typedef struct modestatespiral {
+    phase_t t;
+    engine_amp_t amplitude;
+    bool rising;
+} mode_state_spiral_t;
+
+typedef struct modestatemessedupspiral {
+    phase_t t;
+    engine_amp_t amplitude;
+    int16_t color;
+} mode_state_messed_up_spiral_t;
+
+typedef struct modestaterectangle {
+    int16_t t;
+    int16_t color;
+} mode_state_rectangle_t;
+
+typedef struct modestatestarry {
+    int16_t point;              // Into g_shape_circle_starry
+    phase_t color_phase;
+} mode_state_starry_t;
+
+typedef struct modestatespectrum {
+    uint32_t spectra;           // Analyzer spectra already in level
+    q15_t level[SPECTRUM_NUM_CHANNELS][SPECTRUM_NUM_BANDS];    // Drawn, falling at the release rate
+    int16_t point;              // Along the bars
+    int16_t beat_color;         // Stepped a bin along the colour line on every beat
+    uint32_t beats;             // Beat count beat_color has stepped to
+} mode_state_spectrum_t;
+
+// Plays an ILDA file or a compact show, whichever the blob holds.
+typedef struct modestateilda {
+    bool compact;
+    ilda_file_t show;
+    ilda_cursor_t cursor;
+    compact_show_t compact_show;
+    compact_cursor_t compact_cursor;
+    uint16_t step;              // Frames played past the one the CV selects
+    uint32_t step_phase;        // Q16 fraction of the next step
+} mode_state_ilda_t;
+
+// State RenderEngineFrame() runs a static mode in, one member per mode with frame_points.
+typedef union modestateframe {
+    mode_state_rectangle_t rectangle;
+    mode_state_starry_t starry;
+} mode_state_frame_t;
+
+/*
+ * Picks the mode from the middle CV once per RunEngineBlock() call. The mode
+ * only changes once the CV is more than hysteresis past its region and the
+ * new mode has held for settle_blocks calls in a row. CVs within deadband
+ * of the last one evaluated keep the selection without a lookup. The
+ * crossfade weight still follows the CV, so this only decides which mode is
+ * drawn when the crossfade is off and keeps CV spikes from switching.
+ */
+typedef struct modeselectorconfig {
+    int16_t hysteresis;         // CV counts, at most half a region
+    int16_t settle_blocks;
+    int16_t deadband;           // CV counts
+} mode_selector_config_t;
+
+typedef struct modeselector {
+    mode_selector_config_t config;
+    bool primed;                // False until the first CV, which is taken at once
+    int mode;
+    int candidate;              // Mode the CV is in, while it differs from mode
+    int16_t settled;            // Calls the candidate has held
+    int16_t last_cv;
+    uint32_t switches;
+} mode_selector_t;
+
+/*
+ * Everything the modes carry from one point to the next, in one block. Each
+ * context is an independent engine instance: modes can be reset one at a
+ * time, and a fresh context replays a run exactly.
+ */
+typedef struct enginecontext {
+    mode_state_audio_mono_t audio_mono;
+    mode_state_spectrum_t spectrum;
+    mode_state_spinning_coin_t spinning_coin;
+    mode_state_spiral_t spiral;
+    mode_state_messed_up_spiral_t messed_up_spiral;
+    mode_state_rectangle_t rectangle;
+    mode_state_starry_t starry;
+    mode_state_ilda_t ilda;
+    mode_state_frame_t frame_state;     // Frames render here, the streamed mode carries on untouched
+    mode_selector_t mode_selector;
+
+    // Cleared by the caller when the dual render of a crossfade does not fit
+    // its time budget, the selected mode is then rendered alone.
+    bool crossfade_enabled;
+    // Set by RunEngineBlock(): whether the block wants blanking, dwell and slew
+    // limiting. Audio XY modes are a waveform drawn as it arrives, those stages
+    // would stretch and smear it, so only blocks they render alone skip them.
+    bool output_stages;
+    engine_output_block_t crossfade_scratch;
+    engine_output_block_t point_scratch;
+    engine_inputs_t mode_inputs[ENGINE_MAX_BLOCK];
+} engine_context_t;
+
+/*
+ * A static scene: a mode whose picture is a closed loop fixed by its CVs.
+ * inputs are the CVs quantized by ENGINE_FRAME_CV_SHIFT, key identifies them.
+ */
+typedef struct engineframe {
+    uint32_t key;
+    int mode;
+    int points;                 // In one closed loop
+    engine_inputs_t inputs;
+} engine_frame_t;
+
+void InitEngine(engine_context_t* context);
+void ResetEngineMode(engine_context_t* context, const int mode);
+// Mode a middle CV value falls in, from the region threshold table. Values
+// outside the ADC range clamp to the first or last mode.
+int GetMode(const int16_t selection_point_adc_val);
+// Updates the selection for one block's middle CV and returns the selected mode.
+int UpdateModeSelector(mode_selector_t* selector, const int16_t selection_point_adc_val);
+// InitEngine() loads the built-in show, this points the ILDA mode at another
+// one in read-only memory, ILDA or compact (compact_show.h). Returns false,
+// keeping the show, if it is neither.
+bool SetEngineIldaShow(engine_context_t* context, const uint8_t* data, const size_t size);
+void InitAudioAnalyzer(engine_audio_analyzer_t* analyzer);
+// Runs n <= ENGINE_MAX_BLOCK frames' audio through the band bank, beat tracker
+// and spectrum analyzer and updates the features.
+void AnalyzeAudioBlock(engine_audio_analyzer_t* analyzer, const engine_inputs_t* inputs, const int n);
+
+/*
+ * Renders n <= ENGINE_MAX_BLOCK points, one per input frame. The mode, or the
+ * pair of modes and their mix, is picked once from the first frame's middle
+ * CV and each mode renders the whole block in one call. audio is what the
+ * input side's analyzer made of the audio up to the block, the modes get it
+ * beside their inputs. Returns true if the block was a crossfade of two modes.
+ */
+bool RunEngineBlock(engine_context_t* context, const engine_inputs_t* inputs, const engine_audio_features_t* audio,
+                    engine_output_block_t* outputs, const int n);
+
+/*
+ * Fills frame if the inputs and the mode the selector holds make a single mode
+ * that draws a static loop of at most ENGINE_FRAME_MAX_POINTS points. Returns
+ * false if the scene animates, crossfades or is too long, and has to be
+ * streamed. The selector is not updated, see UpdateModeSelector().
+ */
+bool GetEngineFrame(const engine_context_t* context, const engine_inputs_t* inputs, engine_frame_t* frame);
+
+/*
+ * Renders points [first, first + n) of a frame's loop, n <= ENGINE_MAX_BLOCK.
+ * The mode runs from context->frame_state, which first == 0 resets, so every
+ * pass over the loop is identical and streaming resumes where it left off.
+ */
+void RenderEngineFrame(engine_context_t* context, const engine_frame_t* frame, engine_output_block_t* outputs,
+                       const int first, const int n);
+
+// One point through RunEngineBlock(), mode selection and dispatch included.
+void RunEngine(engine_context_t* context, engine_inputs_t* inputs, const engine_audio_features_t* audio,
+               engine_outputs_t* outputs);
 
 #endif // ENGINE_H_
@@ -0,0 +1,17 @@
+#ifndef ENGINE_FLOAT_H_
+#define ENGINE_FLOAT_H_
+
+#include <stdbool.h>
+
+#include "engine.h"
+
+/*
+ * The engine built with float amplitude envelopes, see engine_float.c. The
+ * contexts are laid out alike, so an engine_context_t runs in either build.
+ */
+bool FloatRunEngineBlock(engine_context_t* context, const engine_inputs_t* inputs, const engine_audio_features_t* audio,
+                         engine_output_block_t* outputs, const int n);
+// Copies a context of the fixed-point build, its envelopes converted to float.
+void FloatCopyEngineContext(engine_context_t* reference, const engine_context_t* fixed);
+
+#endif  // ENGINE_FLOAT_H_
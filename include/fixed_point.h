@@ -0,0 +1,55 @@
+#ifndef FIXED_POINT_H_
+#define FIXED_POINT_H_
+
+#include <stdint.h>
+
+/*
+ * Fixed-point formats used by the engine.
+ *   Q15: int16_t, 1 sign + 15 fraction bits, [-1, 1)
+ *   Q30: int32_t, 2 integer + 30 fraction bits, [-2, 2), used for slow
+ *        accumulators that need headroom above 1.0
+ *   Q31: int32_t, 1 sign + 31 fraction bits, [-1, 1)
+ * All helpers saturate instead of wrapping.
+ */
+typedef int16_t q15_t;
+typedef int32_t q30_t;
+typedef int32_t q31_t;
+
+#define Q15_MAX  ((q15_t)0x7FFF)
+#define Q15_MIN  ((q15_t)-0x8000)
+#define Q30_ONE  ((q30_t)(1 << 30))
+
+static inline q15_t SatQ15(const int32_t value) {
+    return (q15_t)(value > Q15_MAX ? Q15_MAX : value < Q15_MIN ? Q15_MIN : value);
+}
+
+static inline q15_t AddQ15(const q15_t a, const q15_t b) {
+    return SatQ15((int32_t)a + b);
+}
+
+static inline q15_t MulQ15(const q15_t a, const q15_t b) {
+    return SatQ15(((int32_t)a * b) >> 15);
+}
+
+// a * ratio + b * (1 - ratio), ratio in Q15 [0, 1].
+static inline q15_t LerpQ15(const q15_t a, const q15_t b, const q15_t ratio) {
+    return SatQ15(((int32_t)a * ratio + (int32_t)b * ((1 << 15) - ratio)) >> 15);
+}
+
+// Integer value scaled by a Q30 gain, e.g. an amplitude envelope.
+static inline int32_t ScaleQ30(const int32_t value, const q30_t gain) {
+    return (int32_t)(((int64_t)value * gain) >> 30);
+}
+
+// log2(value) in Q8 for value > 0, linear between powers of two, within 0.09 of the exact log2.
+static inline int32_t Log2Q8(const uint64_t value) {
+    const int msb = 63 - __builtin_clzll(value);
+    const uint64_t mantissa = msb >= 8 ? value >> (msb - 8) : value << (8 - msb);
+    return (int32_t)(((uint32_t)msb << 8) | (uint32_t)(mantissa & 0xFFu));
+}
+
+// numerator / denominator as Q30, for compile-time constant denominators.
+#define Q30_RATIO(numerator, denominator) \
+    ((q30_t)(((int64_t)(numerator) << 30) / (denominator)))
+
+#endif  // FIXED_POINT_H_
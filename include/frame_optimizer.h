@@ -0,0 +1,83 @@
+#ifndef FRAME_OPTIMIZER_H_
+#define FRAME_OPTIMIZER_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "engine.h"
+
+/*
+ * Reorders the lit segments of a frame to cut blanked galvo travel. A
+ * segment is a run of lit points, the dark points between them are the
+ * travel. Segments are chained nearest neighbour first, then improved with
+ * 2-opt, both of which may reverse a segment. The frame is a loop, so the
+ * tour is too. Travel is measured per axis (Chebyshev), as the galvos move
+ * both axes at once and the slew limiter steps on the longer one.
+ *
+ * The work is split into steps of a fixed number of distance evaluations so
+ * it can run a little per engine block. A frame with no dark points is one
+ * closed path and is left as it is.
+ */
+
+#define FRAME_OPT_MAX_SEGMENTS      64
+// Distance evaluations per FrameOptimizerStep() on the target, ~20us each block at 72MHz.
+#define FRAME_OPT_STEP_BUDGET       256
+// 2-opt sweeps over the tour before giving up on further gains.
+#define FRAME_OPT_MAX_SWEEPS        8
+
+typedef struct framepoints {
+    int16_t x[ENGINE_FRAME_MAX_POINTS];
+    int16_t y[ENGINE_FRAME_MAX_POINTS];
+    int16_t r[ENGINE_FRAME_MAX_POINTS];
+    int16_t g[ENGINE_FRAME_MAX_POINTS];
+    int16_t b[ENGINE_FRAME_MAX_POINTS];
+    int n;
+} frame_points_t;
+
+typedef enum frameoptphase {
+    FRAME_OPT_NEAREST = 0,
+    FRAME_OPT_TWO_OPT,
+    FRAME_OPT_DONE
+} frame_opt_phase_t;
+
+typedef struct frameoptimizer {
+    const frame_points_t* points;
+    int num_segments;           // 0 for a closed path played as is
+    int16_t start[FRAME_OPT_MAX_SEGMENTS];
+    int16_t length[FRAME_OPT_MAX_SEGMENTS];
+    uint8_t order[FRAME_OPT_MAX_SEGMENTS];
+    bool reversed[FRAME_OPT_MAX_SEGMENTS];
+    bool visited[FRAME_OPT_MAX_SEGMENTS];
+
+    frame_opt_phase_t phase;
+    int row;                    // Nearest neighbour: tour position being filled
+    int i;                      // 2-opt: reversal of tour positions i..j
+    int j;
+    int sweeps;
+    bool improved;
+
+    uint32_t travel_before;     // Blank travel in generation order
+    uint32_t travel_nearest;    // After the nearest neighbour chain
+    uint32_t travel_after;      // Current tour
+    uint32_t evaluations;
+} frame_optimizer_t;
+
+// Finds the segments of points, which must stay unchanged until the frame has been read.
+void FrameOptimizerStart(frame_optimizer_t* opt, const frame_points_t* points);
+
+// Runs up to budget distance evaluations. Returns true once the tour is final.
+bool FrameOptimizerStep(frame_optimizer_t* opt, const int budget);
+
+typedef struct framecursor {
+    int segment;
+    int offset;
+} frame_cursor_t;
+
+/*
+ * Copies up to n points of the reordered frame from the cursor on, each
+ * segment led by a dark point at its first point for the blanked move.
+ * Returns how many were written, 0 at the end of the frame.
+ */
+int ReadOptimizedFrame(const frame_optimizer_t* opt, frame_cursor_t* cursor, engine_output_block_t* out, const int n);
+
+#endif  // FRAME_OPTIMIZER_H_
@@ -0,0 +1,54 @@
+#ifndef GALVO_SLEW_H_
+#define GALVO_SLEW_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "engine.h"
+
+/*
+ * Output-stage slew limiter. Moves larger than max_delta DAC counts on
+ * either axis are split into equal steps by inserting points, so the
+ * galvos are never asked to jump further than they can follow in one tick.
+ * Integer only, one division per move, and at most GALVO_SLEW_MAX_INSERT
+ * points added per input point.
+ */
+
+#define GALVO_SLEW_MAX_INSERT       16
+// Smallest step that still crosses full scale within GALVO_SLEW_MAX_INSERT points.
+#define GALVO_SLEW_MIN_DELTA        ((LASER_POS_MAX + GALVO_SLEW_MAX_INSERT) / (GALVO_SLEW_MAX_INSERT + 1))
+#define GALVO_SLEW_DEFAULT_DELTA    512
+
+typedef struct galvoslewconfig {
+    bool enabled;
+    int16_t max_delta;      // Clamped to GALVO_SLEW_MIN_DELTA..LASER_POS_MAX
+    bool blank_moves;       // Inserted points dark, otherwise they take the target's colour
+} galvo_slew_config_t;
+
+typedef struct galvoslew {
+    galvo_slew_config_t config;
+    bool started;
+    int16_t x;              // Last point emitted
+    int16_t y;
+    // Move in progress, positions in Q16 so the steps do not drift.
+    int32_t step_x;
+    int32_t step_y;
+    int32_t move_x;
+    int32_t move_y;
+    int16_t steps_left;     // Inserted points still to emit before the target
+    bool moving;            // Target of the current move not yet emitted
+    uint32_t points_in;
+    uint32_t points_out;
+} galvo_slew_t;
+
+void GalvoSlewInit(galvo_slew_t* slew, const galvo_slew_config_t* config);
+
+/*
+ * Feeds in->x[first..n) through the limiter, appending to out until it holds
+ * out_size points. Returns how many input points were consumed; a move cut
+ * short by a full output block resumes on the next call.
+ */
+int GalvoSlewBlock(galvo_slew_t* slew, const engine_output_block_t* in, int first, const int n,
+                   engine_output_block_t* out, int* out_count, const int out_size);
+
+#endif  // GALVO_SLEW_H_
@@ -0,0 +1,93 @@
+#ifndef HOST_BENCH_H_
+#define HOST_BENCH_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "compact_show.h"
+
+/*
+ * Micro-benchmarks for the native build, selected with "photon -b <name>",
+ * and the helpers they share with the checks in host_test.c.
+ */
+
+#define BENCH_TWO_PI      6.283185307179586
+
+// Audio at the engine's rate, as the platform would deliver it.
+typedef struct benchaudio {
+    int16_t* left;              // ADC counts at ADC_SAMPLE_RATE_DEFAULT_HZ
+    int16_t* right;
+    size_t frames;
+} bench_audio_t;
+
+typedef struct benchbeats {
+    uint32_t* onsets;           // Last frames of the blocks they were counted in
+    uint32_t* beats;
+    size_t num_onsets;
+    size_t num_beats;
+    uint32_t color_steps;       // Blocks the spectrum mode stepped its colours in
+    double bpm;
+} bench_beats_t;
+
+// A show decoded into memory, the common ground of the ILDA, CSV and compact formats.
+typedef struct benchshow {
+    compact_point_t* points;
+    size_t num_points;
+    uint16_t* frame_points;
+    uint16_t num_frames;
+} bench_show_t;
+
+// Runs the named benchmark, or all of them for "all". Returns false if the
+// name is unknown.
+bool RunHostBenchmark(const char* name);
+
+void ListHostBenchmarks(void);
+
+// Deterministic xorshift so runs are comparable.
+uint32_t BenchRandom(void);
+
+int16_t BenchRandomAdc(void);
+
+// Reads a 16-bit PCM WAV file, mono or stereo, resampled to the engine's
+// audio rate. Mono goes to both channels.
+bool ReadWavFile(const char* path, bench_audio_t* audio);
+
+void FreeBenchAudio(bench_audio_t* audio);
+
+// Runs audio through RunEngineBlock() in the spectrum mode and notes the
+// blocks the engine counted onsets and beats in, by their last frame.
+bool TrackBeats(const bench_audio_t* audio, bench_beats_t* beats);
+
+void FreeBenchBeats(bench_beats_t* beats);
+
+bool LoadIldaShow(bench_show_t* show, const uint8_t* data, size_t size);
+
+// A random walk with long jumps and out of range points, two frames.
+bool BuildRandomWalkShow(bench_show_t* show);
+
+void FreeBenchShow(bench_show_t* show);
+
+// Encodes into a malloc'd buffer, returns its size or 0.
+size_t EncodeBenchShow(const bench_show_t* show, uint8_t** out);
+
+// Decodes the compact blob and checks it holds show, point for point.
+bool CheckCompactShow(const bench_show_t* show, const uint8_t* data, size_t size);
+
+// Decodes an ILDA file with the target's reader and prints each frame's
+// point count and coordinate range in DAC counts, "photon -d <file>".
+bool DecodeIldaFile(const char* path);
+
+// Converts an ILDA or x,y,r,g,b CSV file (blank line between frames) to the
+// compact show format, checks the round trip and reports the size against
+// raw points and ILDA. Writes the show to output unless it is NULL,
+// "photon -e <file> [-o show.bin]".
+bool EncodeCompactShowFile(const char* path, FILE* output);
+
+// Runs a 16-bit PCM WAV file through the engine as its audio input and
+// prints the times of the onsets and beats it flags, and the tempo,
+// "photon -w <file.wav>".
+bool AnalyzeWavFile(const char* path);
+
+#endif  // HOST_BENCH_H_
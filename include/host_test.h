@@ -0,0 +1,15 @@
+#ifndef HOST_TEST_H_
+#define HOST_TEST_H_
+
+/*
+ * Pass/fail checks for the native build, selected with "photon -t <name>"
+ * and run by "make host-test".
+ */
+
+// Runs the named check, or all of them for "all". Returns how many failed,
+// or -1 if the name is unknown.
+int RunHostTests(const char* name);
+
+void ListHostTests(void);
+
+#endif  // HOST_TEST_H_
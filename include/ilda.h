@@ -0,0 +1,67 @@
+#ifndef ILDA_H_
+#define ILDA_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Streaming reader for ILDA image files (formats 0, 1, 4 and 5) held in a
+ * read-only blob, normally flash. Nothing is copied: a cursor walks the
+ * records in place and decodes one point at a time, so a frame of any
+ * length costs a few bytes of RAM. Format 2 palette sections are skipped,
+ * indexed colours always use the ILDA default palette.
+ *
+ * Positions come out as DAC counts (0..LASER_POS_MAX, ILDA 0 at the centre)
+ * and colours as laser PWM levels (0..LASER_PWM_MAX), blanked points dark.
+ */
+
+#define ILDA_HEADER_SIZE    32
+#define ILDA_PALETTE_SIZE   64
+
+typedef struct ildafile {
+    const uint8_t* data;
+    size_t size;
+    uint16_t num_frames;    // Point sections, 0 if the blob is not valid ILDA
+    size_t first_frame;     // Offset of the first point section header
+} ilda_file_t;
+
+// A position in the file: the header of the current frame and the next point in it.
+typedef struct ildacursor {
+    size_t frame_offset;
+    uint16_t frame;
+    uint16_t num_points;
+    uint16_t point;
+    uint8_t format;
+} ilda_cursor_t;
+
+typedef struct ildapoint {
+    int16_t x;
+    int16_t y;
+    int16_t r;
+    int16_t g;
+    int16_t b;
+    bool blanked;
+    bool last;              // Status bit, set on the final point of a frame
+} ilda_point_t;
+
+/*
+ * Checks every section header and counts the point sections. Returns false,
+ * leaving num_frames 0, if the blob is truncated or has an unknown format.
+ */
+bool IldaOpen(ilda_file_t* file, const uint8_t* data, const size_t size);
+
+// Moves the cursor to the start of a frame, frame < num_frames. Walks forward
+// from the cursor where it can, so stepping to the next frame is one hop.
+void IldaSeekFrame(const ilda_file_t* file, ilda_cursor_t* cursor, const uint16_t frame);
+
+// Decodes the next point of the current frame. Returns false once every point
+// of the frame has been read; the cursor then stays at the end of the frame.
+bool IldaNextPoint(const ilda_file_t* file, ilda_cursor_t* cursor, ilda_point_t* point);
+
+// Show linked into flash for MODE_ILDA, ILDA or compact (compact_show.h),
+// generated by resources/ilda/make_default_show.py.
+extern const uint8_t g_ilda_default_show[];
+extern const size_t g_ilda_default_show_size;
+
+#endif  // ILDA_H_
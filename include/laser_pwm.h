@@ -0,0 +1,31 @@
+#ifndef LASER_PWM_H_
+#define LASER_PWM_H_
+
+#include <stdint.h>
+
+#include "engine.h"
+
+// Timer ticks per PWM cycle at 72MHz, ~70kHz so every point gets whole cycles.
+// Duties are 0..LASER_PWM_PERIOD inclusive so they fit in 10 bits.
+#define LASER_PWM_PERIOD  1023
+
+// Starts TIM2 (PB3, red) and TIM4 (PB6 green, PB9 blue) in PWM mode. PB3 must
+// already be released from SWJ and TIM2 partially remapped.
+void StartLaserPwm(void);
+
+// Writes the duty of all three channels into the preload registers. They reach
+// the outputs on the next update event, at the end of the cycle in progress, so
+// every PWM cycle runs whole and the light out stays linear in the duty.
+void SetLaserPwmI(const int16_t pwm_output_r, const int16_t pwm_output_g, const int16_t pwm_output_b);
+
+// As SetLaserPwmI() with duties already converted by LaserDutyFromLevel().
+void SetLaserDutyI(const uint16_t duty_r, const uint16_t duty_g, const uint16_t duty_b);
+
+// Maps a 0..LASER_PWM_MAX intensity onto 0..LASER_PWM_PERIOD timer ticks,
+// rounding to nearest and clamping out of range values.
+static inline uint16_t LaserDutyFromLevel(int16_t level) {
+    level = level < 0 ? 0 : level > LASER_PWM_MAX ? LASER_PWM_MAX : level;
+    return (uint16_t)(((uint32_t)level * LASER_PWM_PERIOD + LASER_PWM_MAX / 2) / LASER_PWM_MAX);
+}
+
+#endif  // LASER_PWM_H_
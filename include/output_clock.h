@@ -0,0 +1,58 @@
+#ifndef OUTPUT_CLOCK_H_
+#define OUTPUT_CLOCK_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "engine.h"
+
+#define OUTPUT_RATE_MIN_HZ      1000
+#define OUTPUT_RATE_MAX_HZ      60000
+#define OUTPUT_RATE_DEFAULT_HZ  20000
+
+// Points the engine renders between waits, must fit in POINT_RING_SIZE.
+#define OUTPUT_BLOCK_SIZE       32
+
+// Blanking, dwell and slew points a frame may gain in the output stages. The
+// rectangle and starry frames gain at most 33 at the default settings, a
+// frame that gains more than this is streamed instead.
+#define OUTPUT_FRAME_STAGE_POINTS   64
+
+// Longest frame the output can loop, 2.5KB of packed points.
+#define OUTPUT_FRAME_MAX_POINTS (ENGINE_FRAME_MAX_POINTS + OUTPUT_FRAME_STAGE_POINTS)
+
+// Starts the fixed-rate sample clock. One point is latched per tick.
+void StartOutputClock(uint32_t rate_hz);
+
+// Changes the point rate of a running clock, clamped to the supported range.
+void SetOutputRate(uint32_t rate_hz);
+
+// Sleeps until the point ring has room for OUTPUT_BLOCK_SIZE points.
+void WaitOutputSpace(void);
+
+// Queues one point for the output ISR, engine thread only. Returns false if
+// the ring is full and the point was dropped.
+bool QueueOutputPoint(const engine_outputs_t* point);
+
+// Encodes up to OUTPUT_BLOCK_SIZE points in one pass and queues them with a
+// single ring publish. Returns false, queueing nothing, if they do not fit.
+bool QueueOutputBlock(const engine_output_block_t* points, const uint32_t n);
+
+// Frame buffer for the tick ISR to loop over instead of the ring. Only
+// written while no frame plays, see platform.h for the sequence.
+bool BeginOutputFrame(void);
+bool AppendOutputFrame(const engine_output_block_t* points, const uint32_t n);
+void PlayOutputFrame(void);
+void StopOutputFrame(void);
+
+// Ticks that found the ring empty and held the last point.
+uint32_t GetOutputUnderruns(void);
+
+// Points dropped because the ring was full.
+uint32_t GetOutputOverruns(void);
+
+// Ticks that found the DAC still shifting out the last point and left theirs
+// queued for the next tick.
+uint32_t GetOutputDacBusyTicks(void);
+
+#endif  // OUTPUT_CLOCK_H_
@@ -0,0 +1,53 @@
+#ifndef PLATFORM_H_
+#define PLATFORM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "adc_input.h"
+#include "engine.h"
+#include "output_clock.h"
+
+/*
+ * Thin hardware abstraction between the engine loop and the I/O. Exactly one
+ * implementation is linked: platform_chibios.c on the target, platform_posix.c
+ * for the native host build.
+ */
+
+// Brings up inputs, outputs and the clock.
+void PlatformStart(void);
+
+/*
+ * ADC source. Fills inputs[INPUT_BLOCK_FRAMES] with the latest block and
+ * audio with the features of the audio up to its end, never blocks. Every
+ * frame goes through the band bank and beat tracker once as it arrives, see
+ * engine_audio_analyzer_t, blocks the engine skips or repeats included.
+ * Returns false once a finite input (host recording) is exhausted.
+ */
+bool PlatformReadInputBlock(engine_inputs_t* inputs, engine_audio_features_t* audio);
+
+// DAC and colour sink. Takes OUTPUT_BLOCK_SIZE points, waiting for room on the
+// target and writing them out as fast as possible on the host.
+void PlatformWriteOutputBlock(const engine_output_block_t* outputs);
+
+/*
+ * Frame replay. A static scene is built once into the frame buffer and the
+ * output side loops over it, from the output ISR on the target, so the engine
+ * does no work while the scene holds.
+ */
+// Clears the frame buffer. Returns false while a stopped frame is still finishing its pass.
+bool PlatformBeginFrame(void);
+// Appends n points to the frame. Returns false once OUTPUT_FRAME_MAX_POINTS would be exceeded.
+bool PlatformAppendFrame(const engine_output_block_t* outputs, const int n);
+// Loops the frame, starting once every queued output block has played.
+void PlatformPlayFrame(void);
+// Ends the loop at the end of the current pass, output blocks written after this play next.
+void PlatformStopFrame(void);
+// Lets about one input block of the frame play.
+void PlatformWaitFrame(void);
+
+// Free running clock for timing, wraps at 32 bits.
+uint32_t PlatformCycles(void);
+uint32_t PlatformCyclesPerSecond(void);
+
+#endif  // PLATFORM_H_
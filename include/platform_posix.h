@@ -0,0 +1,28 @@
+#ifndef PLATFORM_POSIX_H_
+#define PLATFORM_POSIX_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "engine.h"
+
+/*
+ * Host-only settings for platform_posix.c, applied before PlatformStart().
+ */
+typedef struct posixplatformconfig {
+    FILE* input;                 // CSV frames "audio_l,audio_r,cv_l,cv_m,cv_r", NULL for synthetic
+    FILE* output;                // CSV points "x,y,r,g,b", NULL to discard
+    uint64_t num_points;         // Stop after this many points, 0 to run until the input ends
+    engine_inputs_t synthetic;   // CV values used with the synthetic input
+} posix_platform_config_t;
+
+void PosixPlatformConfigure(const posix_platform_config_t* config);
+
+// Points written to the sink so far.
+uint64_t PosixPlatformPointCount(void);
+
+// Input blocks the ADC side has delivered and analysed so far, and its analyzer.
+uint64_t PosixPlatformInputBlocks(void);
+const engine_audio_analyzer_t* PosixPlatformAudioAnalyzer(void);
+
+#endif  // PLATFORM_POSIX_H_
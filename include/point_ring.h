@@ -0,0 +1,84 @@
+#ifndef POINT_RING_H_
+#define POINT_RING_H_
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "dac_mcp4822.h"
+#include "engine.h"
+#include "laser_pwm.h"
+
+/*
+ * Wait-free single-producer/single-consumer ring of packed laser points.
+ * The engine thread is the only producer and the output ISR the only consumer.
+ * Has no OS dependencies so it builds on the host as well as the target.
+ */
+
+#define POINT_RING_SIZE_LOG2  7
+#define POINT_RING_SIZE       (1u << POINT_RING_SIZE_LOG2)
+#define POINT_RING_MASK       (POINT_RING_SIZE - 1u)
+
+// Keep the producer and consumer indices on separate cache lines on the host.
+#if defined(__ARM_ARCH)
+#define POINT_RING_ALIGN  4
+#else
+#define POINT_RING_ALIGN  64
+#endif
+
+/*
+ * A point ready for the output ISR: both MCP4822 command words in the low 32
+ * bits (ch1 first, so they sit in memory in SPI order) and the three laser
+ * PWM duties as 10-bit timer compare values above them. Top 2 bits reserved.
+ */
+typedef uint64_t packed_point_t;
+
+#define PACKED_POINT_DUTY_BITS  10
+#define PACKED_POINT_DUTY_MASK  ((1u << PACKED_POINT_DUTY_BITS) - 1u)
+#define PACKED_POINT_R_SHIFT    32
+#define PACKED_POINT_G_SHIFT    (PACKED_POINT_R_SHIFT + PACKED_POINT_DUTY_BITS)
+#define PACKED_POINT_B_SHIFT    (PACKED_POINT_G_SHIFT + PACKED_POINT_DUTY_BITS)
+
+typedef struct pointring {
+    _Alignas(POINT_RING_ALIGN) _Atomic uint32_t head;       // Written by the producer only
+    uint32_t overruns;                                     // Producer side
+    _Alignas(POINT_RING_ALIGN) _Atomic uint32_t tail;       // Written by the consumer only
+    uint32_t underruns;                                    // Consumer side
+    _Alignas(POINT_RING_ALIGN) packed_point_t points[POINT_RING_SIZE];
+} point_ring_t;
+
+void PointRingInit(point_ring_t* ring);
+
+// Returns false and counts an overrun if the ring is full.
+bool PointRingPush(point_ring_t* ring, const packed_point_t point);
+
+// Pushes all n points with a single index publish. Returns false and counts
+// one overrun, pushing nothing, if they do not all fit.
+bool PointRingPushBlock(point_ring_t* ring, const packed_point_t* points, const uint32_t n);
+
+// Returns false and counts an underrun if the ring is empty.
+bool PointRingPop(point_ring_t* ring, packed_point_t* point);
+
+// Number of queued points. Exact from either side, a lower bound of the other.
+uint32_t PointRingCount(point_ring_t* ring);
+
+static inline uint32_t PointRingFree(point_ring_t* ring) {
+    return POINT_RING_SIZE - PointRingCount(ring);
+}
+
+static inline packed_point_t PackPoint(const engine_outputs_t* outputs) {
+    return (packed_point_t)DacCommandWord(outputs->position_output_x, DAC_CMD_CH1)
+         | ((packed_point_t)DacCommandWord(outputs->position_output_y, DAC_CMD_CH2) << 16)
+         | ((packed_point_t)LaserDutyFromLevel(outputs->laser_pwm_output_r) << PACKED_POINT_R_SHIFT)
+         | ((packed_point_t)LaserDutyFromLevel(outputs->laser_pwm_output_g) << PACKED_POINT_G_SHIFT)
+         | ((packed_point_t)LaserDutyFromLevel(outputs->laser_pwm_output_b) << PACKED_POINT_B_SHIFT);
+}
+
+// Packs a block in one pass, no branches so the host compiler can vectorize it.
+void PackPointBlock(const engine_output_block_t* outputs, packed_point_t* points, const uint32_t n);
+
+static inline uint16_t PackedPointDuty(const packed_point_t point, const unsigned shift) {
+    return (uint16_t)((point >> shift) & PACKED_POINT_DUTY_MASK);
+}
+
+#endif  // POINT_RING_H_
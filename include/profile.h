@@ -0,0 +1,56 @@
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include <stdint.h>
+
+#include "platform.h"
+
+/*
+ * Per-stage and per-mode cycle counters. Time is taken from PlatformCycles():
+ * DWT CYCCNT on the target, nanoseconds on the host. Build with
+ * -DENABLE_PROFILING=1 to turn it on; otherwise every macro compiles to
+ * nothing and the stats table is not linked.
+ */
+#ifndef ENABLE_PROFILING
+#define ENABLE_PROFILING 0
+#endif
+
+#define PROFILE_MAX_MODES    16
+#define PROFILE_HIST_BINS    16  // Bin n counts samples of [2^n, 2^(n+1)) cycles
+
+typedef enum profileslot {
+    PROFILE_INPUT = 0,      // Reading an input block
+    PROFILE_ENGINE,         // Rendering an output block
+    PROFILE_OUTPUT,         // Encoding and queueing an output block
+    PROFILE_TICK,           // Output clock ISR, one point
+    PROFILE_MODE_BASE,      // One block of each generator mode
+    PROFILE_NUM_SLOTS = PROFILE_MODE_BASE + PROFILE_MAX_MODES
+} profile_slot_t;
+
+typedef struct profilestats {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    uint32_t histogram[PROFILE_HIST_BINS];
+} profile_stats_t;
+
+#if ENABLE_PROFILING
+
+void ProfileRecord(const unsigned slot, const uint32_t cycles);
+const profile_stats_t* ProfileGetStats(const unsigned slot);
+void ProfileReset(void);
+
+// Times the statement or block that follows it:
+//   PROFILE_SCOPE(PROFILE_ENGINE) { ... }
+#define PROFILE_SCOPE(slot) \
+    for (uint32_t profile_start_ = PlatformCycles(), profile_done_ = 0; !profile_done_; \
+         profile_done_ = 1, ProfileRecord((slot), PlatformCycles() - profile_start_))
+
+#else
+
+#define PROFILE_SCOPE(slot)
+
+#endif
+
+#endif  // PROFILE_H_
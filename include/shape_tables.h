@@ -0,0 +1,46 @@
+#ifndef SHAPE_TABLES_H_
+#define SHAPE_TABLES_H_
+
+#include <stdint.h>
+
+#include "trig_lut.h"
+
+/*
+ * Flash tables of the built-in modes' shapes, generated by
+ * resources/shapes/make_shape_tables.py. Points are Q15 about the centre;
+ * modes scale them with ScaleQ15() and add their offset. One table read
+ * gives both coordinates, where SinQ15() and CosQ15() fold and interpolate
+ * separately.
+ */
+
+#define SHAPE_CIRCLE_BITS       9
+#define SHAPE_CIRCLE_SIZE       (1 << SHAPE_CIRCLE_BITS)
+#define SHAPE_CIRCLE_FRAC_BITS  15
+#define SHAPE_CIRCLE_ROUND      (1 << (SHAPE_CIRCLE_FRAC_BITS - 1))
+// Divisible by 2 * denom for every MODE_STARRY denom, 1..6.
+#define SHAPE_STARRY_POINTS     120
+
+typedef struct shapepoint {
+    int16_t x;
+    int16_t y;
+} shape_point_t;
+
+// Unit circle (cos, sin), with entry SHAPE_CIRCLE_SIZE repeating entry 0.
+extern const shape_point_t g_shape_circle[SHAPE_CIRCLE_SIZE + 1];
+// Unit circle (cos, sin) at exactly the angles MODE_STARRY steps through.
+extern const shape_point_t g_shape_circle_starry[SHAPE_STARRY_POINTS];
+
+// (CosQ15(phase), SinQ15(phase)) from one interpolated table lookup, within ~1.5 LSB as they are.
+static inline shape_point_t CircleQ15(const phase_t phase) {
+    const uint32_t index = phase >> (32 - SHAPE_CIRCLE_BITS);
+    const int32_t frac = (int32_t)((phase >> (32 - SHAPE_CIRCLE_BITS - SHAPE_CIRCLE_FRAC_BITS))
+                                   & ((1u << SHAPE_CIRCLE_FRAC_BITS) - 1u));
+    const shape_point_t a = g_shape_circle[index];
+    const shape_point_t b = g_shape_circle[index + 1];
+    return (shape_point_t){
+        (int16_t)(a.x + (((b.x - a.x) * frac + SHAPE_CIRCLE_ROUND) >> SHAPE_CIRCLE_FRAC_BITS)),
+        (int16_t)(a.y + (((b.y - a.y) * frac + SHAPE_CIRCLE_ROUND) >> SHAPE_CIRCLE_FRAC_BITS)),
+    };
+}
+
+#endif  // SHAPE_TABLES_H_
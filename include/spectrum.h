@@ -0,0 +1,79 @@
+#ifndef SPECTRUM_H_
+#define SPECTRUM_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "fixed_point.h"
+
+/*
+ * Fixed-point spectrum analyzer for the audio inputs. Both channels go into
+ * one complex FFT, left as the real part and right as the imaginary, and
+ * are split apart again per bin. Samples are captured Hann-windowed, in
+ * bit-reversed order, into one half of a double buffer. When it fills, the
+ * halves swap and a job transforms the full half: radix-2 decimation in
+ * time, each stage halving so nothing saturates, with twiddles read from
+ * g_shape_circle. The job then bins the two magnitude spectra into log-spaced
+ * bands.
+ *
+ * The job runs a bounded number of work units per call, a butterfly or a
+ * bin each, so its cost spreads over the points of the next capture.
+ */
+
+#define SPECTRUM_FFT_BITS       8
+#define SPECTRUM_FFT_SIZE       (1 << SPECTRUM_FFT_BITS)
+#define SPECTRUM_NUM_BANDS      16
+#define SPECTRUM_NUM_CHANNELS   2
+// Butterflies of all stages, then bins 1..SPECTRUM_FFT_SIZE / 2 - 1 split and binned.
+#define SPECTRUM_JOB_WORK       (SPECTRUM_FFT_BITS * SPECTRUM_FFT_SIZE / 2 + SPECTRUM_FFT_SIZE / 2 - 1)
+// Work units each captured sample pays for, enough to finish a job within
+// one capture with a block's worth to spare.
+#define SPECTRUM_WORK_PER_POINT 6
+// Bin magnitudes taken as 0 dB, a full-scale sine on one channel, and the
+// range below it that maps onto the levels.
+#define SPECTRUM_FULL_SCALE_LOG2    12
+#define SPECTRUM_RANGE_LOG2         10
+
+typedef struct spectrumcomplex {
+    int16_t re;
+    int16_t im;
+} spectrum_complex_t;
+
+// First FFT bin of each band and one past the last, log-spaced from 78 Hz at 20 kHz.
+extern const uint8_t g_spectrum_band_edges[SPECTRUM_NUM_BANDS + 1];
+
+typedef struct spectrumanalyzer {
+    spectrum_complex_t buffer[2][SPECTRUM_FFT_SIZE];
+    uint8_t capture;            // Half being captured into, the job works on the other
+    uint16_t captured;
+    uint8_t stage;              // Of the job, SPECTRUM_FFT_BITS for the bands, past that idle
+    uint16_t index;             // Butterfly or bin within the stage
+    uint16_t peak[SPECTRUM_NUM_CHANNELS][SPECTRUM_NUM_BANDS];
+    // Band levels of the last finished spectrum, Q15 over SPECTRUM_RANGE_LOG2 octaves.
+    q15_t level[SPECTRUM_NUM_CHANNELS][SPECTRUM_NUM_BANDS];
+    uint32_t spectra;
+    uint32_t overruns;          // Captures that filled before the job finished
+} spectrum_analyzer_t;
+
+void SpectrumAnalyzerInit(spectrum_analyzer_t* analyzer);
+
+/*
+ * Captures one frame of the audio inputs, in ADC counts. A capture that
+ * fills while the last job is still running finishes that job first.
+ */
+void SpectrumAnalyzerPush(spectrum_analyzer_t* analyzer, const int16_t left, const int16_t right);
+
+// Runs up to work units of the job. Returns true if that finished a spectrum.
+bool SpectrumAnalyzerRun(spectrum_analyzer_t* analyzer, int work);
+
+// |re + j im| to within about 3%, without a square root.
+static inline uint32_t SpectrumMagnitude(const int32_t re, const int32_t im) {
+    const uint32_t a = (uint32_t)(re < 0 ? -re : re);
+    const uint32_t b = (uint32_t)(im < 0 ? -im : im);
+    const uint32_t hi = a > b ? a : b;
+    const uint32_t lo = a > b ? b : a;
+    const uint32_t blend = hi - (hi >> 3) + (lo >> 1);
+    return blend > hi ? blend : hi;
+}
+
+#endif  // SPECTRUM_H_
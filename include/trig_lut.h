@@ -0,0 +1,30 @@
+#ifndef TRIG_LUT_H_
+#define TRIG_LUT_H_
+
+#include <stdint.h>
+
+/*
+ * Table-based sine/cosine on a 32-bit phase accumulator. A full turn is 2^32,
+ * so phases wrap for free on unsigned overflow. Results are Q15.
+ */
+typedef uint32_t phase_t;
+
+#define PHASE_QUARTER_TURN  ((phase_t)0x40000000u)
+#define PHASE_HALF_TURN     ((phase_t)0x80000000u)
+#define PHASE_PER_RADIAN    683565276u  // 2^32 / (2 * PI), rounded
+
+#define Q15_ONE             32767
+
+// Quarter-wave table with linear interpolation, max error ~1 LSB of Q15.
+int16_t SinQ15(const phase_t phase);
+
+static inline int16_t CosQ15(const phase_t phase) {
+    return SinQ15(phase + PHASE_QUARTER_TURN);
+}
+
+// Scales a Q15 value to +-scale, e.g. ScaleQ15(SinQ15(p), ADC_IN_MIDPOINT).
+static inline int32_t ScaleQ15(const int16_t value, const int32_t scale) {
+    return ((int32_t)value * scale) >> 15;
+}
+
+#endif  // TRIG_LUT_H_
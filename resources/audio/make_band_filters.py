@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+"""
+Writes src/audio_bands_table.c, the Goertzel filters of the audio band bank
+in include/audio_bands.h.
+
+Each band is one Goertzel filter at its centre frequency, run over blocks
+of BLOCK_PERIODS periods of that frequency, so the bank is constant Q: the
+main lobe reaches half an octave or so either side of the centre, and low
+bands read out less often than high ones. After every block the band's
+level is smoothed towards the new one with one-pole attack and release
+coefficients, worked out per band from its block length so every band has
+the same time constants.
+
+    python3 resources/audio/make_band_filters.py > src/audio_bands_table.c
+
+Frequencies assume the default 20kHz frame rate, other rates scale them.
+Running the script prints each band's response half an octave either
+side of its centre, and its worst sidelobe, to stderr.
+"""
+import math
+import sys
+
+RATE = 20000.0
+CENTRES = (63.0, 125.0, 250.0, 500.0, 1000.0, 2000.0, 4000.0, 8000.0)
+BLOCK_PERIODS = 2.0
+COEF_BITS = 30
+ATTACK_S = 0.010
+RELEASE_S = 0.150
+Q15_ONE = 32767
+
+
+def band(hz):
+    length = max(2, round(BLOCK_PERIODS * RATE / hz))
+    omega = 2.0 * math.pi * hz / RATE
+    return {
+        "hz": hz,
+        "coef": round((1 << COEF_BITS) * 2.0 * math.cos(omega)),
+        "length": length,
+        "length_log2_q8": round(256.0 * math.log2(length / 2.0)),
+        "attack": round(Q15_ONE * (1.0 - math.exp(-length / (RATE * ATTACK_S)))),
+        "release": round(Q15_ONE * (1.0 - math.exp(-length / (RATE * RELEASE_S)))),
+    }
+
+
+def response(b, hz):
+    """Goertzel block gain at hz relative to its centre, from the DFT of a rectangular block."""
+    omega = 2.0 * math.pi * b["hz"] / RATE
+    delta = 2.0 * math.pi * hz / RATE - omega
+    acc = abs(sum(complex(math.cos(delta * n), math.sin(delta * n)) for n in range(b["length"])))
+    return acc / b["length"]
+
+
+def main():
+    bands = [band(hz) for hz in CENTRES]
+    for b in bands:
+        edges = [20.0 * math.log10(response(b, b["hz"] * k)) for k in (2.0 ** -0.5, 2.0 ** 0.5)]
+        outside = [b["hz"] * 2.0 ** (i / 32.0) for i in range(-256, 257) if abs(i) >= 32]
+        worst = max(20.0 * math.log10(max(response(b, hz), 1e-9)) for hz in outside if hz < RATE / 2.0)
+        print("// %5.0f Hz: %5.1f / %5.1f dB half an octave down / up, %5.1f dB worst an octave or more away"
+              % (b["hz"], edges[0], edges[1], worst), file=sys.stderr)
+
+    print("// Generated by resources/audio/make_band_filters.py, do not edit.")
+    print('#include "audio_bands.h"')
+    print()
+    print("// Centre frequency at 20kHz: 2 cos(2 PI f / rate) Q30, %g periods a block, %gms attack, %gms release."
+          % (BLOCK_PERIODS, ATTACK_S * 1e3, RELEASE_S * 1e3))
+    print("const audio_band_filter_t g_audio_band_filters[AUDIO_BANDS] = {")
+    for b in bands:
+        print("    {%11d, %4d, %5d, %5d, %5d},  // %5.0f Hz"
+              % (b["coef"], b["length"], b["length_log2_q8"], b["attack"], b["release"], b["hz"]))
+    print("};")
+
+
+if __name__ == "__main__":
+    main()
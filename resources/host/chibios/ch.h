@@ -0,0 +1,18 @@
+/*
+ * Host stand-in for the ChibiOS kernel header, enough for the drivers the
+ * host build compiles against hal.h. There is one thread and no interrupts,
+ * so the locks do nothing.
+ */
+#ifndef CH_H_
+#define CH_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+static inline void chSysLock(void) {}
+static inline void chSysUnlock(void) {}
+static inline void chSysLockFromISR(void) {}
+static inline void chSysUnlockFromISR(void) {}
+
+#endif  // CH_H_
@@ -0,0 +1,81 @@
+/*
+ * Host stand-in for the ChibiOS HAL, enough to run dac_mcp4822.c against a
+ * pin trace. GPIO writes go to a hook. The SPI shifts each frame out on its
+ * SCK and MOSI pads as the peripheral would for the SPIConfig's CR1, mode,
+ * frame size and bit order included, once MockSpiFinishFrame() plays the
+ * transfer-complete interrupt.
+ */
+#ifndef HAL_H_
+#define HAL_H_
+
+#include "ch.h"
+
+typedef struct stm32gpio {
+    uint32_t odr;
+} stm32_gpio_t;
+
+typedef stm32_gpio_t* ioportid_t;
+typedef uint32_t iomode_t;
+
+extern stm32_gpio_t g_mock_gpioa;
+extern stm32_gpio_t g_mock_gpiob;
+extern stm32_gpio_t g_mock_gpioc;
+
+#define GPIOA   (&g_mock_gpioa)
+#define GPIOB   (&g_mock_gpiob)
+#define GPIOC   (&g_mock_gpioc)
+
+#define PAL_MODE_INPUT_ANALOG               0u
+#define PAL_MODE_OUTPUT_PUSHPULL            1u
+#define PAL_MODE_STM32_ALTERNATE_PUSHPULL   2u
+
+// Bits of SPI_CR1 the mock shifts frames by, as in the STM32F1 CMSIS header.
+#define SPI_CR1_CPHA        (1u << 0)
+#define SPI_CR1_CPOL        (1u << 1)
+#define SPI_CR1_LSBFIRST    (1u << 7)
+#define SPI_CR1_DFF         (1u << 11)
+
+// SCK and MOSI of SPI2 on the STM32F103, where the peripheral drives the frames.
+#define MOCK_SPI2_PORT      GPIOB
+#define MOCK_SPI2_PAD_SCK   13u
+#define MOCK_SPI2_PAD_MOSI  15u
+
+typedef struct SPIDriver SPIDriver;
+typedef void (*spicallback_t)(SPIDriver* spip);
+
+typedef struct {
+    spicallback_t end_cb;
+    ioportid_t ssport;
+    uint16_t sspad;
+    uint16_t cr1;
+    uint16_t cr2;
+} SPIConfig;
+
+struct SPIDriver {
+    const SPIConfig* config;
+    const void* txbuf;      // Frames of the transfer in flight, NULL when idle
+    size_t n;
+};
+
+extern SPIDriver SPID2;
+
+// Called on every GPIO pad write, level after the write.
+typedef void (*mock_pin_hook_t)(ioportid_t port, unsigned pad, bool level);
+
+void MockHalSetPinHook(mock_pin_hook_t hook);
+
+// Shifts out the transfer in flight and runs the end callback, as the SPI
+// DMA interrupt would. Returns false if no transfer was in flight.
+bool MockSpiFinishFrame(SPIDriver* spip);
+
+void palSetPad(ioportid_t port, unsigned pad);
+void palClearPad(ioportid_t port, unsigned pad);
+void palTogglePad(ioportid_t port, unsigned pad);
+void palSetPadMode(ioportid_t port, unsigned pad, iomode_t mode);
+
+void spiStart(SPIDriver* spip, const SPIConfig* config);
+void spiSelectI(SPIDriver* spip);
+void spiUnselectI(SPIDriver* spip);
+void spiStartSendI(SPIDriver* spip, size_t n, const void* txbuf);
+
+#endif  // HAL_H_
@@ -0,0 +1,98 @@
+/*
+ * GPIO and SPI of the host HAL stand-in, see hal.h.
+ */
+#include "hal.h"
+
+stm32_gpio_t g_mock_gpioa;
+stm32_gpio_t g_mock_gpiob;
+stm32_gpio_t g_mock_gpioc;
+SPIDriver SPID2;
+
+static mock_pin_hook_t g_pin_hook = NULL;
+
+static void WritePad(ioportid_t port, const unsigned pad, const bool level) {
+    port->odr = level ? port->odr | (1u << pad) : port->odr & ~(1u << pad);
+    if (g_pin_hook != NULL) {
+        g_pin_hook(port, pad, level);
+    }
+}
+
+void MockHalSetPinHook(mock_pin_hook_t hook) {
+    g_pin_hook = hook;
+}
+
+void palSetPad(ioportid_t port, unsigned pad) {
+    WritePad(port, pad, true);
+}
+
+void palClearPad(ioportid_t port, unsigned pad) {
+    WritePad(port, pad, false);
+}
+
+void palTogglePad(ioportid_t port, unsigned pad) {
+    WritePad(port, pad, (port->odr & (1u << pad)) == 0);
+}
+
+void palSetPadMode(ioportid_t port, unsigned pad, iomode_t mode) {
+    (void)port;
+    (void)pad;
+    (void)mode;
+}
+
+void spiStart(SPIDriver* spip, const SPIConfig* config) {
+    spip->config = config;
+    spip->txbuf = NULL;
+    spip->n = 0;
+    WritePad(MOCK_SPI2_PORT, MOCK_SPI2_PAD_SCK, (config->cr1 & SPI_CR1_CPOL) != 0);
+}
+
+void spiSelectI(SPIDriver* spip) {
+    palClearPad(spip->config->ssport, spip->config->sspad);
+}
+
+void spiUnselectI(SPIDriver* spip) {
+    palSetPad(spip->config->ssport, spip->config->sspad);
+}
+
+void spiStartSendI(SPIDriver* spip, size_t n, const void* txbuf) {
+    spip->txbuf = txbuf;
+    spip->n = n;
+}
+
+/*
+ * One frame on the wire. MOSI changes before the leading SCK edge with CPHA
+ * 0 and on it with CPHA 1, so the receiver samples on the other edge.
+ */
+static void ShiftFrame(const uint16_t cr1, const uint16_t frame) {
+    const int bits = cr1 & SPI_CR1_DFF ? 16 : 8;
+    const bool idle = (cr1 & SPI_CR1_CPOL) != 0;
+    for (int i = 0; i < bits; ++i) {
+        const int bit = cr1 & SPI_CR1_LSBFIRST ? i : bits - 1 - i;
+        const bool level = ((frame >> bit) & 1u) != 0;
+        if (cr1 & SPI_CR1_CPHA) {
+            WritePad(MOCK_SPI2_PORT, MOCK_SPI2_PAD_SCK, !idle);
+            WritePad(MOCK_SPI2_PORT, MOCK_SPI2_PAD_MOSI, level);
+            WritePad(MOCK_SPI2_PORT, MOCK_SPI2_PAD_SCK, idle);
+        } else {
+            WritePad(MOCK_SPI2_PORT, MOCK_SPI2_PAD_MOSI, level);
+            WritePad(MOCK_SPI2_PORT, MOCK_SPI2_PAD_SCK, !idle);
+            WritePad(MOCK_SPI2_PORT, MOCK_SPI2_PAD_SCK, idle);
+        }
+    }
+}
+
+bool MockSpiFinishFrame(SPIDriver* spip) {
+    if (spip->txbuf == NULL) {
+        return false;
+    }
+    const uint16_t cr1 = spip->config->cr1;
+    for (size_t i = 0; i < spip->n; ++i) {
+        ShiftFrame(cr1, cr1 & SPI_CR1_DFF ? ((const uint16_t*)spip->txbuf)[i] : ((const uint8_t*)spip->txbuf)[i]);
+    }
+    spip->txbuf = NULL;
+    spip->n = 0;
+    if (spip->config->end_cb != NULL) {
+        spip->config->end_cb(spip);
+    }
+    return true;
+}
@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+"""
+Writes src/ilda_default_show.c, the ILDA show linked into flash for MODE_ILDA.
+
+Eight format 5 (2D true colour) frames: a five-pointed star turning through
+one point's worth of rotation, with four dots orbiting it. The dots are
+separate segments with blanked moves between them, so the blanking and
+reordering stages have something to do.
+
+    python3 resources/ilda/make_default_show.py > src/ilda_default_show.c
+
+Given a file, embeds that show instead, ILDA or a compact show written by
+"photon -e" (include/compact_show.h), which takes under half the flash:
+
+    python3 resources/ilda/make_default_show.py show.ild > src/ilda_default_show.c
+"""
+import math
+import struct
+import sys
+
+NUM_FRAMES = 8
+STAR_RADIUS = 20000
+STAR_INNER = 8000
+DOT_RADIUS = 28000
+STATUS_LAST = 0x80
+STATUS_BLANKED = 0x40
+
+
+def header(fmt, records, frame, total):
+    return struct.pack(">4s3xB8s8sHHHBx", b"ILDA", fmt, b"photon", b"dj", records, frame, total, 0)
+
+
+def frame_points(frame):
+    points = []
+    turn = frame / NUM_FRAMES * (2 * math.pi / 5)
+    star = []
+    for k in range(10):
+        radius = STAR_RADIUS if k % 2 == 0 else STAR_INNER
+        angle = turn + k * math.pi / 5 + math.pi / 2
+        star.append((radius * math.cos(angle), radius * math.sin(angle)))
+    star.append(star[0])
+    points.append((star[0], False, (0, 0, 0)))
+    points += [(p, True, (255, 200, 0)) for p in star]
+    for d in range(4):
+        angle = -2 * turn + d * math.pi / 2
+        dot = (DOT_RADIUS * math.cos(angle), DOT_RADIUS * math.sin(angle))
+        points.append((dot, False, (0, 0, 0)))
+        points += [(dot, True, (0, 128, 255))] * 3
+    return points
+
+
+def encode():
+    blob = b""
+    for frame in range(NUM_FRAMES):
+        points = frame_points(frame)
+        blob += header(5, len(points), frame, NUM_FRAMES)
+        for i, ((x, y), lit, (r, g, b)) in enumerate(points):
+            status = (0 if lit else STATUS_BLANKED) | (STATUS_LAST if i == len(points) - 1 else 0)
+            blob += struct.pack(">hhBBBB", round(x), round(y), status, b, g, r)
+    return blob + header(5, 0, 0, NUM_FRAMES)
+
+
+def main():
+    if len(sys.argv) > 1:
+        with open(sys.argv[1], "rb") as show:
+            blob = show.read()
+    else:
+        blob = encode()
+    print("// Generated by resources/ilda/make_default_show.py, do not edit.")
+    print('#include "ilda.h"')
+    print()
+    print("const uint8_t g_ilda_default_show[] = {")
+    for i in range(0, len(blob), 16):
+        print("    " + ", ".join("0x%02x" % b for b in blob[i:i + 16]) + ",")
+    print("};")
+    print()
+    print("const size_t g_ilda_default_show_size = sizeof(g_ilda_default_show);")
+
+
+if __name__ == "__main__":
+    main()
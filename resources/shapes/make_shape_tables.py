@@ -0,0 +1,55 @@
+#!/usr/bin/env python3
+"""
+Writes src/shape_tables.c, the point tables of the built-in modes' shapes,
+so the modes index them instead of evaluating trig per point.
+
+    python3 resources/shapes/make_shape_tables.py > src/shape_tables.c
+
+Each table is a unit circle as Q15 (cos, sin) pairs, at the resolutions
+in include/shape_tables.h:
+
+  g_shape_circle            SHAPE_CIRCLE_SIZE points and a closing guard
+                            entry, interpolated by CircleQ15() for modes
+                            that step by any phase.
+  g_shape_circle_starry     SHAPE_STARRY_POINTS points, every angle
+                            MODE_STARRY reaches (multiples of PI / denom,
+                            denom 1..6), read as is.
+"""
+import math
+
+Q15_ONE = 32767
+CIRCLE_SIZE = 512
+STARRY_POINTS = 120
+
+
+def circle(points, guard):
+    table = []
+    for i in range(points + (1 if guard else 0)):
+        angle = 2.0 * math.pi * i / points
+        table.append((round(Q15_ONE * math.cos(angle)), round(Q15_ONE * math.sin(angle))))
+    return table
+
+
+def emit(name, size, comment, table):
+    print("// %s" % comment)
+    print("const shape_point_t %s[%s] = {" % (name, size))
+    for i in range(0, len(table), 4):
+        print("    " + " ".join("{%6d, %6d}," % point for point in table[i:i + 4]))
+    print("};")
+
+
+def main():
+    print("// Generated by resources/shapes/make_shape_tables.py, do not edit.")
+    print('#include "shape_tables.h"')
+    print()
+    emit("g_shape_circle", "SHAPE_CIRCLE_SIZE + 1",
+         "round(32767 * (cos, sin)(2 * PI * i / %d)) for i in 0..%d, in flash." % (CIRCLE_SIZE, CIRCLE_SIZE),
+         circle(CIRCLE_SIZE, True))
+    print()
+    emit("g_shape_circle_starry", "SHAPE_STARRY_POINTS",
+         "round(32767 * (cos, sin)(2 * PI * i / %d)) for i in 0..%d, in flash." % (STARRY_POINTS, STARRY_POINTS - 1),
+         circle(STARRY_POINTS, False))
+
+
+if __name__ == "__main__":
+    main()
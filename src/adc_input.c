@@ -0,0 +1,198 @@
+#include <ch.h>
+#include <hal.h>
+
+#include "adc_input.h"
+#include "audio_decimator.h"
+
+#define ADC_GROUP_NUM_CHANNELS   5
+// Scans per frame, every channel is converted at the oversampled rate.
+#define ADC_SCANS_PER_FRAME      AUDIO_OVERSAMPLE
+#define ADC_GROUP_BUF_DEPTH      (2 * INPUT_BLOCK_FRAMES * ADC_SCANS_PER_FRAME)
+
+// TIM3 runs off the 72MHz APB1 timer clock and only provides TRGO to the ADC.
+#define ADC_TRIGGER_TIMER_FREQ   4000000
+
+typedef enum adcindext {
+  BUF_IDX_CV_INPUT_L = 0,
+  BUF_IDX_CV_INPUT_C = 1,
+  BUF_IDX_CV_INPUT_R = 2,
+  BUF_IDX_AUDIO_INPUT_L = 3,
+  BUF_IDX_AUDIO_INPUT_R = 4
+} adc_index_t;
+
+static adcsample_t g_adc_samples_buf[ADC_GROUP_NUM_CHANNELS * ADC_GROUP_BUF_DEPTH];
+
+// Above the engine thread, so a block is taken before the DMA comes back to it
+// however long the engine spends on one of its own.
+#define INPUT_THREAD_PRIORITY    (NORMALPRIO + 1)
+
+// Start of the last completed half buffer and a count of completed halves.
+static const adcsample_t* volatile g_adc_ready_block = g_adc_samples_buf;
+static volatile uint32_t g_adc_block_seq = 0;
+static binary_semaphore_t g_adc_block_sem;
+static uint32_t g_input_overruns = 0;
+
+/*
+ * Decimated blocks with the features as of their end. The input thread fills
+ * one while the engine copies from the other, g_input_seq counts the blocks
+ * published and its low bit picks the one to copy.
+ */
+typedef struct inputblock {
+  engine_inputs_t frames[INPUT_BLOCK_FRAMES];
+  engine_audio_features_t audio;
+} input_block_t;
+
+static input_block_t g_input_blocks[2];
+static volatile uint32_t g_input_seq = 0;
+static audio_decimator_t g_audio_left;
+static audio_decimator_t g_audio_right;
+static engine_audio_analyzer_t g_audio_analyzer;
+
+static THD_WORKING_AREA(g_input_thread_wa, 512);
+
+static void AdcEndCallback(ADCDriver* adcp);
+
+/*
+ * ADC conversion group.
+ * Mode:        Circular, 1 sample of 5 channels per TIM3 TRGO.
+ * Channels:    IN3 - IN7
+ * Timing:      (7.5 + 12.5) cycles at 9MHz ADCCLK is 2.2us a channel, 11.1us
+ *              a scan, inside the 12.5us between scans at 4 x 20kHz.
+ */
+static const ADCConversionGroup g_adc_grp_config = {
+  TRUE,                                /* circular */
+  ADC_GROUP_NUM_CHANNELS,              /* num_channels */
+  AdcEndCallback,                      /* end_cb   */
+  NULL,                                /* error_cb */
+  0,                                   /* CR1 */
+  ADC_CR2_EXTTRIG | ADC_CR2_EXTSEL_2,  /* CR2, EXTSEL=100 is TIM3_TRGO */
+  0,                                   /* SMPR1 (ch 10-17) */
+  ADC_SMPR2_SMP_AN3(ADC_SAMPLE_7P5)    /* SMPR2*/
+    | ADC_SMPR2_SMP_AN4(ADC_SAMPLE_7P5)
+    | ADC_SMPR2_SMP_AN5(ADC_SAMPLE_7P5)
+    | ADC_SMPR2_SMP_AN6(ADC_SAMPLE_7P5)
+    | ADC_SMPR2_SMP_AN7(ADC_SAMPLE_7P5),
+  ADC_SQR1_NUM_CH(ADC_GROUP_NUM_CHANNELS), /* sqr1 sequence steps 13-16, seq len */
+  0,                                       /* sqr2 sequence steps 7-12 */
+  ADC_SQR3_SQ1_N(ADC_CHANNEL_IN3)         /* sqr3 sequence steps 1-6  */
+    | ADC_SQR3_SQ2_N(ADC_CHANNEL_IN4)
+    | ADC_SQR3_SQ3_N(ADC_CHANNEL_IN5)
+    | ADC_SQR3_SQ4_N(ADC_CHANNEL_IN6)
+    | ADC_SQR3_SQ5_N(ADC_CHANNEL_IN7)
+};
+
+// Update event on TRGO, no interrupt needed.
+static const GPTConfig g_adc_trigger_config = {
+  .frequency = ADC_TRIGGER_TIMER_FREQ,
+  .callback = NULL,
+  .cr2 = TIM_CR2_MMS_1,
+  .dier = 0
+};
+
+/*
+ * Called by the ADC DMA ISR when either half of the buffer fills. Only
+ * publishes the block and wakes the input thread.
+ */
+static void AdcEndCallback(ADCDriver* adcp) {
+  g_adc_ready_block = adcIsBufferComplete(adcp) ?
+      &g_adc_samples_buf[ADC_GROUP_NUM_CHANNELS * ADC_GROUP_BUF_DEPTH / 2] : g_adc_samples_buf;
+  ++g_adc_block_seq;
+  chSysLockFromISR();
+  chBSemSignalI(&g_adc_block_sem);
+  chSysUnlockFromISR();
+}
+
+/*
+ * One frame from its ADC_SCANS_PER_FRAME scans: audio through the
+ * decimators, CVs from the last scan as they change far slower than a frame.
+ */
+static void GetSamples(engine_inputs_t* samples_in, const adcsample_t* sample_buf) {
+  const adcsample_t* last = &sample_buf[(ADC_SCANS_PER_FRAME - 1) * ADC_GROUP_NUM_CHANNELS];
+  samples_in->audio_in_left = AudioDecimate(&g_audio_left, &sample_buf[BUF_IDX_AUDIO_INPUT_L], ADC_GROUP_NUM_CHANNELS);
+  samples_in->audio_in_right = AudioDecimate(&g_audio_right, &sample_buf[BUF_IDX_AUDIO_INPUT_R], ADC_GROUP_NUM_CHANNELS);
+  samples_in->cv_in_left = last[BUF_IDX_CV_INPUT_L];
+  samples_in->cv_in_middle = last[BUF_IDX_CV_INPUT_C];
+  samples_in->cv_in_right = last[BUF_IDX_CV_INPUT_R];
+}
+
+/*
+ * Decimates each block once as it completes and runs it through the band bank
+ * and beat tracker, the filters must see every scan exactly once. The DMA
+ * comes back around to a half after another INPUT_BLOCK_FRAMES frames
+ * (1.6ms at 20kHz), both finish well within that.
+ */
+static THD_FUNCTION(InputThread, arg) {
+  (void)arg;
+  chRegSetThreadName("input");
+  uint32_t taken_seq = 0;
+  while (true) {
+    chBSemWait(&g_adc_block_sem);
+    chSysLock();
+    const adcsample_t* block = g_adc_ready_block;
+    const uint32_t seq = g_adc_block_seq;
+    chSysUnlock();
+    g_input_overruns += seq - taken_seq - 1;
+    taken_seq = seq;
+
+    input_block_t* next = &g_input_blocks[(g_input_seq + 1) & 1];
+    for (int i = 0; i < INPUT_BLOCK_FRAMES; ++i) {
+      GetSamples(&next->frames[i], &block[i * ADC_SCANS_PER_FRAME * ADC_GROUP_NUM_CHANNELS]);
+    }
+    AnalyzeAudioBlock(&g_audio_analyzer, next->frames, INPUT_BLOCK_FRAMES);
+    next->audio = g_audio_analyzer.features;
+    chSysLock();
+    ++g_input_seq;
+    chSysUnlock();
+  }
+}
+
+void StartInputSampling(uint32_t rate_hz) {
+  AudioDecimatorInit(&g_audio_left);
+  AudioDecimatorInit(&g_audio_right);
+  InitAudioAnalyzer(&g_audio_analyzer);
+  chBSemObjectInit(&g_adc_block_sem, true);
+  chThdCreateStatic(g_input_thread_wa, sizeof(g_input_thread_wa), INPUT_THREAD_PRIORITY, InputThread, NULL);
+
+  palSetPadMode(GPIOA, 3, PAL_MODE_INPUT_ANALOG);
+  palSetPadMode(GPIOA, 4, PAL_MODE_INPUT_ANALOG);
+  palSetPadMode(GPIOA, 5, PAL_MODE_INPUT_ANALOG);
+  palSetPadMode(GPIOA, 6, PAL_MODE_INPUT_ANALOG);
+  palSetPadMode(GPIOA, 7, PAL_MODE_INPUT_ANALOG);
+
+  adcStart(&ADCD1, NULL);
+  adcStartConversion(&ADCD1, &g_adc_grp_config, g_adc_samples_buf, ADC_GROUP_BUF_DEPTH);
+
+  gptStart(&GPTD3, &g_adc_trigger_config);
+  gptStartContinuous(&GPTD3, (gptcnt_t)(ADC_TRIGGER_TIMER_FREQ / (rate_hz * ADC_SCANS_PER_FRAME)));
+}
+
+/*
+ * Read by the engine thread, through PlatformReadInputBlock(). A block and
+ * its features are a few hundred bytes, copying them under the lock would
+ * hold off the output clock tick and jitter the points, so the lock is only
+ * taken to read g_input_seq. The input thread runs above the engine thread
+ * and can publish mid-copy, but it only writes the block it is not
+ * publishing: the copy is only torn if the sequence moved during it, and is
+ * then taken again.
+ */
+void GetInputBlock(engine_inputs_t* inputs, engine_audio_features_t* audio) {
+  uint32_t seq;
+  bool torn;
+  do {
+    chSysLock();
+    seq = g_input_seq;
+    chSysUnlock();
+    const input_block_t* ready = &g_input_blocks[seq & 1];
+    for (int i = 0; i < INPUT_BLOCK_FRAMES; ++i) {
+      inputs[i] = ready->frames[i];
+    }
+    *audio = ready->audio;
+    chSysLock();
+    torn = seq != g_input_seq;
+    chSysUnlock();
+  } while (torn);
+}
+
+uint32_t GetInputOverruns(void) {
+  return g_input_overruns;
+}
@@ -0,0 +1,337 @@
+#include "app.h"
+#include "blank_dwell.h"
+#include "engine.h"
+#include "frame_optimizer.h"
+#include "galvo_slew.h"
+#include "platform.h"
+#include "profile.h"
+
+// Share of a block's output time the engine may spend rendering it.
+#define APP_ENGINE_BUDGET_PERCENT       50
+// Blocks rendered single-mode after a crossfade ran over budget, ~0.4s.
+#define APP_CROSSFADE_BACKOFF_BLOCKS    256
+// Blocks a static scene has to hold before it is built into a frame, ~13ms.
+#define APP_FRAME_HOLD_BLOCKS           8
+
+// Reorders a held scene's segments before its frame is built. Every static
+// mode so far draws one closed path, which the optimizer leaves as it is, so
+// it is off by default and its ~3KB of RAM stay free.
+#ifndef APP_FRAME_OPTIMIZER
+#define APP_FRAME_OPTIMIZER             0
+#endif
+
+_Static_assert(INPUT_BLOCK_FRAMES == OUTPUT_BLOCK_SIZE, "One input frame per output point");
+_Static_assert(OUTPUT_BLOCK_SIZE <= ENGINE_MAX_BLOCK, "Output block larger than an engine block");
+
+static engine_inputs_t g_input_block[INPUT_BLOCK_FRAMES];
+static engine_audio_features_t g_input_audio;
+static engine_output_block_t g_engine_block;
+static engine_output_block_t g_dwell_block;
+static engine_output_block_t g_output_block;
+static int g_output_count;
+static engine_context_t g_engine;
+static blank_dwell_t g_dwell;
+static galvo_slew_t g_slew;
+static bool g_stages_bypassed;
+
+typedef bool (*outputSink)(const engine_output_block_t* outputs, const int n);
+
+// The static scene being held or played, see UpdateFrame().
+static engine_frame_t g_frame;
+static uint32_t g_frame_hold;
+static bool g_frame_playing;
+static bool g_frame_rejected;
+#if APP_FRAME_OPTIMIZER
+static bool g_frame_optimizing;
+static frame_points_t g_frame_points;
+static frame_optimizer_t g_frame_optimizer;
+#endif
+static int g_frame_length;
+static engine_outputs_t g_frame_start;
+static blank_dwell_t g_frame_dwell;
+static galvo_slew_t g_frame_slew;
+
+static uint32_t g_engine_budget;
+static uint32_t g_crossfade_backoff;
+
+/*
+ * Crossfades render two modes, caps their cost: a crossfaded block that ran
+ * over budget turns them off for a while, then they are tried again. The
+ * budget is set for the default point rate.
+ */
+static void UpdateCrossfadeBudget(const bool crossfaded, const uint32_t cycles) {
+    if (crossfaded && cycles > g_engine_budget) {
+        g_engine.crossfade_enabled = false;
+        g_crossfade_backoff = APP_CROSSFADE_BACKOFF_BLOCKS;
+    } else if (g_crossfade_backoff > 0 && --g_crossfade_backoff == 0) {
+        g_engine.crossfade_enabled = true;
+    }
+}
+
+static bool StreamSink(const engine_output_block_t* outputs, const int n) {
+    (void)n;
+    PlatformWriteOutputBlock(outputs);
+    return true;
+}
+
+static bool DiscardSink(const engine_output_block_t* outputs, const int n) {
+    (void)outputs;
+    (void)n;
+    return true;
+}
+
+static bool FrameSink(const engine_output_block_t* outputs, const int n) {
+    if (n > 0 && g_frame_length == 0) {
+        g_frame_start = (engine_outputs_t){outputs->x[0], outputs->y[0], outputs->r[0], outputs->g[0], outputs->b[0]};
+    }
+    g_frame_length += n;
+    return PlatformAppendFrame(outputs, n);
+}
+
+/*
+ * Blanking, dwell and slew limiting of n engine points, handing every output
+ * block that fills up to the sink. One engine block can make several.
+ */
+static bool RunOutputStages(blank_dwell_t* dwell, galvo_slew_t* slew, const engine_output_block_t* block,
+                            const int n, const outputSink sink) {
+    bool ok = true;
+    int consumed = 0;
+    while (consumed < n) {
+        int dwell_count = 0;
+        consumed += BlankDwellBlock(dwell, block, consumed, n, &g_dwell_block, &dwell_count, ENGINE_MAX_BLOCK);
+        int slewed = 0;
+        while (slewed < dwell_count) {
+            slewed += GalvoSlewBlock(slew, &g_dwell_block, slewed, dwell_count,
+                                     &g_output_block, &g_output_count, OUTPUT_BLOCK_SIZE);
+            if (g_output_count == OUTPUT_BLOCK_SIZE) {
+                ok = sink(&g_output_block, OUTPUT_BLOCK_SIZE) && ok;
+                g_output_count = 0;
+            }
+        }
+    }
+    return ok;
+}
+
+// Writes out a part-filled output block, padded with its last point.
+static void FlushOutputBlock(void) {
+    if (g_output_count == 0) {
+        return;
+    }
+    const int last = g_output_count - 1;
+    for (int i = g_output_count; i < OUTPUT_BLOCK_SIZE; ++i) {
+        g_output_block.x[i] = g_output_block.x[last];
+        g_output_block.y[i] = g_output_block.y[last];
+        g_output_block.r[i] = g_output_block.r[last];
+        g_output_block.g[i] = g_output_block.g[last];
+        g_output_block.b[i] = g_output_block.b[last];
+    }
+    PlatformWriteOutputBlock(&g_output_block);
+    g_output_count = 0;
+}
+
+/*
+ * Writes an engine block that skips the output stages, see
+ * engine_context_t.output_stages. The first such block flushes what the
+ * stages still hold and restarts them, so they pick up from scratch when a
+ * mode that wants them comes back.
+ */
+static void BypassOutputStages(const engine_output_block_t* block) {
+    if (!g_stages_bypassed) {
+        FlushOutputBlock();
+        const blank_dwell_config_t dwell_config = g_dwell.config;
+        const galvo_slew_config_t slew_config = g_slew.config;
+        BlankDwellInit(&g_dwell, &dwell_config);
+        GalvoSlewInit(&g_slew, &slew_config);
+        g_stages_bypassed = true;
+    }
+    StreamSink(block, OUTPUT_BLOCK_SIZE);
+}
+
+#if APP_FRAME_OPTIMIZER
+// Renders the held scene's loop into g_frame_points and starts reordering its segments.
+static void StartFrameOptimizer(void) {
+    for (int first = 0; first < g_frame.points; first += ENGINE_MAX_BLOCK) {
+        const int n = g_frame.points - first < ENGINE_MAX_BLOCK ? g_frame.points - first : ENGINE_MAX_BLOCK;
+        RenderEngineFrame(&g_engine, &g_frame, &g_engine_block, first, n);
+        for (int i = 0; i < n; ++i) {
+            g_frame_points.x[first + i] = g_engine_block.x[i];
+            g_frame_points.y[first + i] = g_engine_block.y[i];
+            g_frame_points.r[first + i] = g_engine_block.r[i];
+            g_frame_points.g[first + i] = g_engine_block.g[i];
+            g_frame_points.b[first + i] = g_engine_block.b[i];
+        }
+    }
+    g_frame_points.n = g_frame.points;
+    FrameOptimizerStart(&g_frame_optimizer, &g_frame_points);
+}
+#endif
+
+// One pass over the loop, reordered if APP_FRAME_OPTIMIZER, through the output stages.
+static bool RenderFramePass(blank_dwell_t* dwell, galvo_slew_t* slew, const outputSink sink) {
+    bool ok = true;
+#if APP_FRAME_OPTIMIZER
+    frame_cursor_t cursor = {0, 0};
+    int n;
+    while (ok && (n = ReadOptimizedFrame(&g_frame_optimizer, &cursor, &g_engine_block, ENGINE_MAX_BLOCK)) > 0) {
+        ok = RunOutputStages(dwell, slew, &g_engine_block, n, sink);
+    }
+#else
+    for (int first = 0; ok && first < g_frame.points; first += ENGINE_MAX_BLOCK) {
+        const int n = g_frame.points - first < ENGINE_MAX_BLOCK ? g_frame.points - first : ENGINE_MAX_BLOCK;
+        RenderEngineFrame(&g_engine, &g_frame, &g_engine_block, first, n);
+        ok = RunOutputStages(dwell, slew, &g_engine_block, n, sink);
+    }
+#endif
+    return ok;
+}
+
+/*
+ * Builds the held scene into the platform frame. The loop goes through copies
+ * of the output stages twice: the first pass leaves them as they would be at
+ * the end of a loop, so the second is one loop of continuous output, seam
+ * included. The stream is then slewed onto the frame's first point, and the
+ * stages carry on from the end of the loop once the frame stops.
+ */
+static bool BuildFrame(void) {
+    if (!PlatformBeginFrame()) {
+        return false;
+    }
+    FlushOutputBlock();
+    g_frame_dwell = g_dwell;
+    g_frame_slew = g_slew;
+    g_frame_length = 0;
+
+    RenderFramePass(&g_frame_dwell, &g_frame_slew, DiscardSink);
+    g_output_count = 0;
+    const bool fits = RenderFramePass(&g_frame_dwell, &g_frame_slew, FrameSink) &&
+                      FrameSink(&g_output_block, g_output_count);
+    g_output_count = 0;
+    if (!fits || g_frame_length == 0) {
+        g_frame_rejected = true;
+        return false;
+    }
+
+    // The dwell block is free between RunOutputStages() calls.
+    g_dwell_block.x[0] = g_frame_start.position_output_x;
+    g_dwell_block.y[0] = g_frame_start.position_output_y;
+    g_dwell_block.r[0] = g_frame_start.laser_pwm_output_r;
+    g_dwell_block.g[0] = g_frame_start.laser_pwm_output_g;
+    g_dwell_block.b[0] = g_frame_start.laser_pwm_output_b;
+    int consumed = 0;
+    while (consumed < 1) {
+        consumed += GalvoSlewBlock(&g_slew, &g_dwell_block, 0, 1, &g_output_block, &g_output_count, OUTPUT_BLOCK_SIZE);
+        if (g_output_count == OUTPUT_BLOCK_SIZE) {
+            PlatformWriteOutputBlock(&g_output_block);
+            g_output_count = 0;
+        }
+    }
+    FlushOutputBlock();
+
+    g_dwell = g_frame_dwell;
+    g_slew = g_frame_slew;
+    PlatformPlayFrame();
+    return true;
+}
+
+/*
+ * Decides whether this input block plays from the frame. A static scene that
+ * holds its quantized CVs for APP_FRAME_HOLD_BLOCKS is built and looped by
+ * the output side; with APP_FRAME_OPTIMIZER it is first rendered once and its
+ * segments reordered a budgeted step per block while streaming goes on. Any change stops the loop and
+ * streaming resumes.
+ */
+static bool UpdateFrame(void) {
+    engine_frame_t frame;
+    const bool is_static = GetEngineFrame(&g_engine, &g_input_block[0], &frame);
+    const bool held = is_static && g_frame_hold > 0 && frame.key == g_frame.key;
+
+    if (g_frame_playing) {
+        if (held) {
+            return true;
+        }
+        PlatformStopFrame();
+        g_frame_playing = false;
+    }
+    if (!held) {
+        g_frame = frame;
+        g_frame_hold = is_static ? 1 : 0;
+        g_frame_rejected = false;
+#if APP_FRAME_OPTIMIZER
+        g_frame_optimizing = false;
+#endif
+        return false;
+    }
+    if (g_frame_rejected || ++g_frame_hold < APP_FRAME_HOLD_BLOCKS) {
+        return false;
+    }
+    PROFILE_SCOPE(PROFILE_ENGINE) {
+#if APP_FRAME_OPTIMIZER
+        if (!g_frame_optimizing) {
+            StartFrameOptimizer();
+            g_frame_optimizing = true;
+        }
+        if (FrameOptimizerStep(&g_frame_optimizer, FRAME_OPT_STEP_BUDGET)) {
+            g_frame_playing = BuildFrame();
+        }
+#else
+        g_frame_playing = BuildFrame();
+#endif
+    }
+    return g_frame_playing;
+}
+
+void AppInit(void) {
+    const blank_dwell_config_t dwell_config = {
+        .enabled = true,
+        .pre_blank = BLANK_DWELL_DEFAULT_PRE,
+        .post_blank = BLANK_DWELL_DEFAULT_POST,
+        .corner_dwell = BLANK_DWELL_DEFAULT_DWELL,
+        .corner_cos = BLANK_DWELL_DEFAULT_CORNER
+    };
+    const galvo_slew_config_t slew_config = {
+        .enabled = true,
+        .max_delta = GALVO_SLEW_DEFAULT_DELTA,
+        .blank_moves = false
+    };
+    InitEngine(&g_engine);
+    BlankDwellInit(&g_dwell, &dwell_config);
+    GalvoSlewInit(&g_slew, &slew_config);
+    g_output_count = 0;
+    g_stages_bypassed = false;
+    g_frame_hold = 0;
+    g_frame_playing = false;
+#if APP_FRAME_OPTIMIZER
+    g_frame_optimizing = false;
+#endif
+    g_engine_budget = (uint32_t)((uint64_t)PlatformCyclesPerSecond() * OUTPUT_BLOCK_SIZE / OUTPUT_RATE_DEFAULT_HZ
+                                 * APP_ENGINE_BUDGET_PERCENT / 100);
+}
+
+bool AppStep(void) {
+    bool have_input;
+    PROFILE_SCOPE(PROFILE_INPUT) {
+        have_input = PlatformReadInputBlock(g_input_block, &g_input_audio);
+    }
+    if (!have_input) {
+        return false;
+    }
+    if (UpdateFrame()) {
+        // The engine sits the block out, the selection still tracks the CV.
+        UpdateModeSelector(&g_engine.mode_selector, g_input_block[0].cv_in_middle);
+        PlatformWaitFrame();
+        return true;
+    }
+    PROFILE_SCOPE(PROFILE_ENGINE) {
+        const uint32_t start = PlatformCycles();
+        const bool crossfaded = RunEngineBlock(&g_engine, g_input_block, &g_input_audio, &g_engine_block,
+                                               OUTPUT_BLOCK_SIZE);
+        UpdateCrossfadeBudget(crossfaded, PlatformCycles() - start);
+    }
+    if (g_engine.output_stages) {
+        g_stages_bypassed = false;
+        RunOutputStages(&g_dwell, &g_slew, &g_engine_block, OUTPUT_BLOCK_SIZE, StreamSink);
+    } else {
+        BypassOutputStages(&g_engine_block);
+    }
+    return true;
+}
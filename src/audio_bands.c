@@ -0,0 +1,45 @@
+#include "audio_bands.h"
+#include "engine.h"
+
+void AudioBandsInit(audio_bands_t* bands) {
+    *bands = (audio_bands_t){0};
+}
+
+// Level of a finished block from the filter's power, |X|^2 = s1^2 + s2^2 - coef s1 s2.
+static q15_t BlockLevel(const audio_band_filter_t* filter, const int32_t s1, const int32_t s2) {
+    const int64_t cross = ((int64_t)filter->coef * s1) >> AUDIO_BANDS_COEF_BITS;
+    const int64_t power = (int64_t)s1 * s1 + (int64_t)s2 * s2 - cross * s2;
+    if (power <= 0) {
+        return 0;
+    }
+    // A sine of amplitude A gives |X| = A * length / 2.
+    const int32_t amplitude_log2_q8 = (Log2Q8((uint64_t)power) >> 1) - filter->length_log2_q8;
+    const int32_t above_floor = amplitude_log2_q8 - ((AUDIO_BANDS_FULL_SCALE_LOG2 - AUDIO_BANDS_RANGE_LOG2) << 8);
+    if (above_floor <= 0) {
+        return 0;
+    }
+    return SatQ15((above_floor << 15) / (AUDIO_BANDS_RANGE_LOG2 << 8));
+}
+
+void AudioBandsPush(audio_bands_t* bands, const int16_t left, const int16_t right) {
+    const int32_t sample = ((int32_t)left + right) / 2 - ADC_IN_MIDPOINT;
+    for (int band = 0; band < AUDIO_BANDS; ++band) {
+        const audio_band_filter_t* filter = &g_audio_band_filters[band];
+        const int32_t s1 = bands->s1[band];
+        const int32_t s2 = bands->s2[band];
+        const int32_t s0 = sample + (int32_t)(((int64_t)filter->coef * s1) >> AUDIO_BANDS_COEF_BITS) - s2;
+        if (++bands->count[band] < filter->length) {
+            bands->s2[band] = s1;
+            bands->s1[band] = s0;
+            continue;
+        }
+
+        const q15_t target = BlockLevel(filter, s0, s1);
+        const q15_t level = bands->level[band];
+        const q15_t rate = target > level ? filter->attack : filter->release;
+        bands->level[band] = (q15_t)(level + (((int32_t)(target - level) * rate) >> 15));
+        bands->s1[band] = 0;
+        bands->s2[band] = 0;
+        bands->count[band] = 0;
+    }
+}
@@ -0,0 +1,14 @@
+// Generated by resources/audio/make_band_filters.py, do not edit.
+#include "audio_bands.h"
+
+// Centre frequency at 20kHz: 2 cos(2 PI f / rate) Q30, 2 periods a block, 10ms attack, 150ms release.
+const audio_band_filter_t g_audio_band_filters[AUDIO_BANDS] = {
+    { 2147063051,  635,  2128, 31398,  6251},  //    63 Hz
+    { 2145828016,  320,  1874, 26151,  3315},  //   125 Hz
+    { 2140863673,  160,  1618, 18044,  1702},  //   250 Hz
+    { 2121044561,   80,  1362, 10803,   862},  //   500 Hz
+    { 2042378317,   40,  1106,  5940,   434},  //  1000 Hz
+    { 1737350766,   20,   850,  3118,   218},  //  2000 Hz
+    {  663608942,   10,   594,  1598,   109},  //  4000 Hz
+    {-1737350766,    5,   338,   809,    55},  //  8000 Hz
+};
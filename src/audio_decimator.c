@@ -0,0 +1,51 @@
+#include "audio_decimator.h"
+#include "engine.h"
+
+_Static_assert(AUDIO_CIC_ORDER == 3, "CicDecimate() unrolls three integrators");
+
+void AudioDecimatorInit(audio_decimator_t* decimator) {
+    *decimator = (audio_decimator_t){0};
+}
+
+// One CIC output from AUDIO_CIC_DECIMATION input samples.
+static inline int16_t CicDecimate(audio_decimator_t* decimator, const uint16_t* samples, const int stride) {
+    uint32_t i0 = decimator->integrator[0];
+    uint32_t i1 = decimator->integrator[1];
+    uint32_t i2 = decimator->integrator[2];
+    for (int k = 0; k < AUDIO_CIC_DECIMATION; ++k) {
+        i0 += (uint32_t)((int32_t)samples[k * stride] - ADC_IN_MIDPOINT);
+        i1 += i0;
+        i2 += i1;
+    }
+    decimator->integrator[0] = i0;
+    decimator->integrator[1] = i1;
+    decimator->integrator[2] = i2;
+
+    uint32_t value = i2;
+    for (int stage = 0; stage < AUDIO_CIC_ORDER; ++stage) {
+        const uint32_t delayed = decimator->comb[stage];
+        decimator->comb[stage] = value;
+        value -= delayed;
+    }
+    return (int16_t)(int32_t)value;
+}
+
+int16_t AudioDecimate(audio_decimator_t* decimator, const uint16_t* samples, const int stride) {
+    for (int k = 0; k < AUDIO_FIR_DECIMATION; ++k) {
+        const int16_t value = CicDecimate(decimator, &samples[k * AUDIO_CIC_DECIMATION * stride], stride);
+        decimator->history[decimator->head] = value;
+        decimator->history[decimator->head + AUDIO_FIR_TAPS] = value;
+        decimator->head = decimator->head + 1 == AUDIO_FIR_TAPS ? 0 : decimator->head + 1;
+    }
+
+    // Oldest first, so the taps pair up from both ends.
+    const int16_t* window = &decimator->history[decimator->head];
+    int32_t acc = (int32_t)g_audio_fir_taps[AUDIO_FIR_HALF_TAPS - 1] * window[AUDIO_FIR_TAPS / 2];
+    for (int k = 0; k < AUDIO_FIR_HALF_TAPS - 1; ++k) {
+        acc += (int32_t)g_audio_fir_taps[k] * (window[k] + window[AUDIO_FIR_TAPS - 1 - k]);
+    }
+
+    const int shift = AUDIO_FIR_COEF_BITS + AUDIO_CIC_GAIN_BITS;
+    const int32_t value = ((acc + (1 << (shift - 1))) >> shift) + ADC_IN_MIDPOINT;
+    return (int16_t)(value < 0 ? 0 : (value > ADC_IN_MAX ? ADC_IN_MAX : value));
+}
@@ -0,0 +1,8 @@
+// Generated by resources/audio/make_decimator_fir.py, do not edit.
+#include "audio_decimator.h"
+
+// Q15 taps 0..15 of the symmetric 31-tap FIR, CIC droop compensated, sum 32768.
+const int16_t g_audio_fir_taps[AUDIO_FIR_HALF_TAPS] = {
+         0,     -2,      0,     -5,     -5,     56,     65,   -213,
+      -328,    508,   1116,   -836,  -3155,    628,  10500,  16110,
+};
@@ -0,0 +1,162 @@
+#include "beat_tracker.h"
+
+// How long after a hit in the audio the comb places it, the onset latency and half a hop, measured by "photon -b beat".
+#define BEAT_ONSET_LATENCY      280     // Frames
+// Tempo prior, the share of the autocorrelation kept per hop of lag away from BEAT_PRIOR_LAG, Q15.
+#define BEAT_PRIOR_SLOPE        512
+#define BEAT_PERIOD_SMOOTH_BITS 3
+// Share of the phase error taken out each hop.
+#define BEAT_PHASE_SMOOTH_BITS  3
+
+// 2^32 phase per beat of period_q8 / 256 hops.
+static phase_t PhaseIncrement(const uint32_t period_q8) {
+    return (phase_t)(((uint64_t)1 << 40) / ((uint64_t)period_q8 * BEAT_HOP));
+}
+
+void BeatTrackerInit(beat_tracker_t* tracker) {
+    *tracker = (beat_tracker_t){0};
+    tracker->period_q8 = BEAT_PRIOR_LAG << 8;
+    tracker->increment = PhaseIncrement(tracker->period_q8);
+}
+
+/*
+ * Autocorrelation peak, weighted towards BEAT_PRIOR_LAG, refined by a
+ * parabola through its neighbours. Returns false, and leaves the period,
+ * unless the peak stands BEAT_ACF_PEAK times over the average lag, as it
+ * does not in noise or with a single onset.
+ */
+static bool UpdateTempo(beat_tracker_t* tracker) {
+    int best = 0;
+    int64_t best_score = 0;
+    int64_t total = 0;
+    for (int i = 0; i < BEAT_NUM_LAGS; ++i) {
+        total += tracker->acf[i];
+        const int distance = i + BEAT_MIN_LAG - BEAT_PRIOR_LAG;
+        const int32_t weight = (1 << 15) - (distance < 0 ? -distance : distance) * BEAT_PRIOR_SLOPE;
+        const int64_t score = (int64_t)tracker->acf[i] * weight;
+        if (score > best_score) {
+            best = i;
+            best_score = score;
+        }
+    }
+    if (best_score <= 0 || (int64_t)tracker->acf[best] * BEAT_NUM_LAGS <= total * BEAT_ACF_PEAK) {
+        return false;
+    }
+
+    int32_t offset_q8 = 0;
+    if (best > 0 && best < BEAT_NUM_LAGS - 1) {
+        const int32_t before = tracker->acf[best - 1];
+        const int32_t peak = tracker->acf[best];
+        const int32_t after = tracker->acf[best + 1];
+        const int32_t curvature = before - 2 * peak + after;
+        if (curvature < 0) {
+            offset_q8 = (int32_t)(((int64_t)(before - after) << 7) / curvature);
+            offset_q8 = offset_q8 < -128 ? -128 : (offset_q8 > 128 ? 128 : offset_q8);
+        }
+    }
+    const int32_t target_q8 = ((best + BEAT_MIN_LAG) << 8) + offset_q8;
+    tracker->period_q8 = (uint32_t)((int32_t)tracker->period_q8
+                                    + ((target_q8 - (int32_t)tracker->period_q8) >> BEAT_PERIOD_SMOOTH_BITS));
+    tracker->increment = PhaseIncrement(tracker->period_q8);
+    return true;
+}
+
+/*
+ * Hops back to the last beat by the onset history: the offset within a
+ * period that holds the most onset strength summed over BEAT_COMB_BEATS
+ * periods back. Returns -1 unless it stands BEAT_COMB_PEAK times over the
+ * average offset, as it does not in noise or silence.
+ */
+static int CombOffset(const beat_tracker_t* tracker) {
+    const int period = (int)((tracker->period_q8 + 128) >> 8);
+    int best = -1;
+    int32_t best_score = 0;
+    int32_t total = 0;
+    for (int offset = 0; offset < period; ++offset) {
+        int32_t score = 0;
+        for (int beat = 0; beat < BEAT_COMB_BEATS; ++beat) {
+            const int back = offset + (int)((beat * tracker->period_q8 + 128) >> 8);
+            score += tracker->history[(tracker->head - back) & (BEAT_HISTORY - 1)];
+        }
+        total += score;
+        if (score > best_score) {
+            best = offset;
+            best_score = score;
+        }
+    }
+    return (int64_t)best_score * period > (int64_t)total * BEAT_COMB_PEAK ? best : -1;
+}
+
+/*
+ * Pulls the phase towards the comb's while they agree within an eighth of
+ * a beat. Otherwise, unlocked, the phase restarts at the comb's. Counts the
+ * hops they disagree in, so a lock is earned by the phase running through
+ * beats on its own.
+ */
+static void AlignPhase(beat_tracker_t* tracker, const bool periodic) {
+    const int offset = periodic ? CombOffset(tracker) : -1;
+    if (offset < 0) {
+        ++tracker->missed_hops;
+        return;
+    }
+    const phase_t target = tracker->increment * (phase_t)(offset * BEAT_HOP + BEAT_ONSET_LATENCY);
+    const int32_t error = (int32_t)(tracker->phase - target);
+    const bool agree = error > -(int32_t)(PHASE_QUARTER_TURN / 2) && error < (int32_t)(PHASE_QUARTER_TURN / 2);
+    tracker->missed_hops += agree ? 0 : 1;
+    if (agree) {
+        tracker->phase -= (phase_t)(error >> BEAT_PHASE_SMOOTH_BITS);
+    } else if (!BeatTrackerLocked(tracker)) {
+        tracker->phase = target;
+    }
+}
+
+static void RunHop(beat_tracker_t* tracker, const q15_t* band_levels) {
+    int32_t flux = 0;
+    for (int band = 0; band < AUDIO_BANDS; ++band) {
+        const int32_t rise = band_levels[band] - tracker->previous[band];
+        flux += rise > 0 ? rise : 0;
+        tracker->previous[band] = band_levels[band];
+    }
+    const int32_t mean = tracker->mean;
+    tracker->mean += (flux - mean) >> BEAT_MEAN_BITS;
+
+    if (tracker->refractory > 0) {
+        --tracker->refractory;
+    } else if (flux > 2 * mean + BEAT_ONSET_FLOOR) {
+        tracker->onset = true;
+        ++tracker->onsets;
+        tracker->refractory = BEAT_REFRACTORY_HOPS;
+    }
+
+    const int32_t strength = flux - mean;
+    const int16_t value = (int16_t)(strength < 0 ? 0 : (strength > Q15_MAX ? Q15_MAX : strength));
+    tracker->head = (uint16_t)((tracker->head + 1) & (BEAT_HISTORY - 1));
+    tracker->history[tracker->head] = value;
+    for (int i = 0; i < BEAT_NUM_LAGS; ++i) {
+        const int16_t past = tracker->history[(tracker->head - (i + BEAT_MIN_LAG)) & (BEAT_HISTORY - 1)];
+        tracker->acf[i] += (((int32_t)value * past) >> 15) - (tracker->acf[i] >> BEAT_ACF_DECAY_BITS);
+    }
+    AlignPhase(tracker, UpdateTempo(tracker));
+}
+
+void BeatTrackerPush(beat_tracker_t* tracker, const q15_t* band_levels) {
+    const phase_t start = tracker->phase;
+    tracker->phase += tracker->increment;
+    tracker->onset = false;
+    if (++tracker->hop_frames == BEAT_HOP) {
+        tracker->hop_frames = 0;
+        RunHop(tracker, band_levels);
+    }
+
+    // A beat as the phase passes 0 going forward, by the oscillator or set onto the comb. A correction
+    // back over half a turn also flips the sign, but does not land it this close past 0.
+    tracker->beat = false;
+    if ((int32_t)start < 0 && tracker->phase < PHASE_QUARTER_TURN) {
+        const bool matched = 2 * tracker->missed_hops < (tracker->period_q8 >> 8);
+        tracker->lock = (int16_t)(matched ? tracker->lock + 1 : tracker->lock - 1);
+        tracker->lock = (int16_t)(tracker->lock < 0 ? 0 : (tracker->lock > BEAT_LOCK_MAX ? BEAT_LOCK_MAX : tracker->lock));
+        tracker->missed_hops = 0;
+        tracker->beat = BeatTrackerLocked(tracker);
+        tracker->beats += tracker->beat ? 1 : 0;
+    }
+}
@@ -0,0 +1,139 @@
+#include "blank_dwell.h"
+
+static inline int16_t ClampRepeat(const int16_t count) {
+    return count < 0 ? 0 : count > BLANK_DWELL_MAX_REPEAT ? BLANK_DWELL_MAX_REPEAT : count;
+}
+
+static inline int16_t ClampPosition(const int16_t value) {
+    return value < 0 ? 0 : value > LASER_POS_MAX ? LASER_POS_MAX : value;
+}
+
+static inline bool IsLit(const blank_dwell_point_t* point) {
+    return (point->r | point->g | point->b) != 0;
+}
+
+static inline bool SamePosition(const blank_dwell_point_t* a, const blank_dwell_point_t* b) {
+    return a->x == b->x && a->y == b->y;
+}
+
+/*
+ * True if the path previous -> current -> next turns by more than the angle
+ * whose cosine is corner_cos. Compared squared so there is no square root:
+ * dot^2 against cos^2 |a|^2 |b|^2. Positions are clamped to 12 bits on the
+ * way in, so |a|^2 |b|^2 and dot^2 are below 2^51 and cos^2 in Q12 leaves
+ * the products a factor of 4 short of 64 bits.
+ */
+static bool IsCorner(const blank_dwell_point_t* previous, const blank_dwell_point_t* current,
+                     const blank_dwell_point_t* next, const q15_t corner_cos) {
+    const int32_t ax = current->x - previous->x;
+    const int32_t ay = current->y - previous->y;
+    const int32_t bx = next->x - current->x;
+    const int32_t by = next->y - current->y;
+    const int64_t dot = (int64_t)ax * bx + (int64_t)ay * by;
+    const uint64_t length_product = (uint64_t)((int64_t)ax * ax + (int64_t)ay * ay)
+                                  * (uint64_t)((int64_t)bx * bx + (int64_t)by * by);
+    if (length_product == 0) {
+        return false;
+    }
+
+    const int32_t cos_q12 = corner_cos / 8;
+    const uint64_t cos_squared = (uint64_t)(cos_q12 * cos_q12) >> 12;
+    const uint64_t dot_squared = (uint64_t)(dot * dot) << 12;
+    if (corner_cos >= 0) {
+        return dot < 0 || dot_squared < cos_squared * length_product;
+    }
+    return dot < 0 && dot_squared > cos_squared * length_product;
+}
+
+static inline void Enqueue(blank_dwell_t* stage, const blank_dwell_point_t* point, const bool lit, int count) {
+    for (; count > 0; --count) {
+        blank_dwell_point_t* slot = &stage->queue[stage->queue_count++];
+        *slot = *point;
+        if (!lit) {
+            slot->r = 0;
+            slot->g = 0;
+            slot->b = 0;
+        }
+    }
+}
+
+// Queues the current point and whatever it needs, now that its successor is known.
+static void QueueCurrent(blank_dwell_t* stage, const blank_dwell_point_t* next) {
+    const blank_dwell_config_t* config = &stage->config;
+    const blank_dwell_point_t* current = &stage->current;
+    const bool lit = IsLit(current);
+    const bool previous_lit = stage->have_previous && IsLit(&stage->previous);
+
+    stage->queue_head = 0;
+    stage->queue_count = 0;
+    if (lit && !previous_lit) {
+        Enqueue(stage, current, false, config->pre_blank);
+    }
+    Enqueue(stage, current, true, 1);
+    if (lit && !IsLit(next)) {
+        Enqueue(stage, current, false, config->post_blank);
+    } else if (lit && previous_lit && IsCorner(&stage->previous, current, next, config->corner_cos)) {
+        Enqueue(stage, current, true, config->corner_dwell);
+    }
+
+    // Repeats of one position carry no direction, keep the last point that moved.
+    if (!stage->have_previous || !SamePosition(&stage->previous, current)) {
+        stage->previous = *current;
+        stage->have_previous = true;
+    } else {
+        stage->previous.r = current->r;
+        stage->previous.g = current->g;
+        stage->previous.b = current->b;
+    }
+}
+
+void BlankDwellInit(blank_dwell_t* stage, const blank_dwell_config_t* config) {
+    *stage = (blank_dwell_t){0};
+    stage->config = *config;
+    stage->config.pre_blank = ClampRepeat(config->pre_blank);
+    stage->config.post_blank = ClampRepeat(config->post_blank);
+    stage->config.corner_dwell = ClampRepeat(config->corner_dwell);
+}
+
+int BlankDwellBlock(blank_dwell_t* stage, const engine_output_block_t* in, int first, const int n,
+                    engine_output_block_t* out, int* out_count, const int out_size) {
+    int count = *out_count;
+    int i = first;
+
+    while (count < out_size) {
+        if (stage->queue_head < stage->queue_count) {
+            const blank_dwell_point_t* point = &stage->queue[stage->queue_head++];
+            out->x[count] = point->x;
+            out->y[count] = point->y;
+            out->r[count] = point->r;
+            out->g[count] = point->g;
+            out->b[count] = point->b;
+            ++count;
+            continue;
+        }
+        if (i >= n) {
+            break;
+        }
+
+        const blank_dwell_point_t next = {
+            ClampPosition(in->x[i]), ClampPosition(in->y[i]), in->r[i], in->g[i], in->b[i]
+        };
+        ++i;
+        if (!stage->config.enabled) {
+            stage->queue_head = 0;
+            stage->queue_count = 0;
+            Enqueue(stage, &next, true, 1);
+            continue;
+        }
+        if (stage->have_current) {
+            QueueCurrent(stage, &next);
+        }
+        stage->current = next;
+        stage->have_current = true;
+    }
+
+    stage->points_in += (uint32_t)(i - first);
+    stage->points_out += (uint32_t)(count - *out_count);
+    *out_count = count;
+    return i - first;
+}
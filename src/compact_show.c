@@ -0,0 +1,92 @@
+#include <string.h>
+
+#include "compact_show.h"
+
+// Longest varint a valid show holds: run headers are at most 17 bits.
+#define COMPACT_VARINT_MAX_BYTES    3
+
+static inline uint16_t ReadU16(const uint8_t* bytes) {
+    return (uint16_t)(bytes[0] | (bytes[1] << 8));
+}
+
+static inline uint32_t ReadU32(const uint8_t* bytes) {
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+// Bounds checked CompactReadVarint() for CompactShowOpen().
+static bool ReadVarint(const uint8_t* data, const size_t size, size_t* offset, uint32_t* value) {
+    *value = 0;
+    for (int i = 0; i < COMPACT_VARINT_MAX_BYTES && *offset < size; ++i) {
+        const uint8_t byte = data[(*offset)++];
+        *value |= (uint32_t)(byte & 0x7Fu) << (7 * i);
+        if ((byte & 0x80u) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool CheckFrame(const uint8_t* data, const size_t size, size_t offset) {
+    uint32_t points;
+    // An empty frame would leave a player seeking forever for a point to draw.
+    if (!ReadVarint(data, size, &offset, &points) || points == 0 || points > UINT16_MAX) {
+        return false;
+    }
+
+    int32_t x = 0;
+    int32_t y = 0;
+    while (points > 0) {
+        uint32_t run;
+        if (!ReadVarint(data, size, &offset, &run) || (run >> 1) == 0 || (run >> 1) > points) {
+            return false;
+        }
+        if (run & 1u) {
+            if (offset + 3 > size) {
+                return false;
+            }
+            offset += 3;
+        }
+        for (uint32_t i = 0; i < (run >> 1); ++i) {
+            uint32_t dx;
+            uint32_t dy;
+            if (!ReadVarint(data, size, &offset, &dx) || !ReadVarint(data, size, &offset, &dy)) {
+                return false;
+            }
+            x += CompactUnzigzag(dx);
+            y += CompactUnzigzag(dy);
+            if (x < 0 || x > COMPACT_SHOW_POS_MAX || y < 0 || y > COMPACT_SHOW_POS_MAX) {
+                return false;
+            }
+        }
+        points -= run >> 1;
+    }
+    return true;
+}
+
+bool CompactShowOpen(compact_show_t* show, const uint8_t* data, const size_t size) {
+    *show = (compact_show_t){data, size, 0};
+
+    if (size < COMPACT_SHOW_HEADER_SIZE || memcmp(data, "PHCS", 4) != 0 || data[4] != COMPACT_SHOW_VERSION) {
+        return false;
+    }
+    const uint16_t frames = ReadU16(&data[6]);
+    if (frames == 0 || COMPACT_SHOW_HEADER_SIZE + (size_t)frames * 4 > size) {
+        return false;
+    }
+    for (uint16_t f = 0; f < frames; ++f) {
+        const uint32_t offset = ReadU32(&data[COMPACT_SHOW_HEADER_SIZE + (size_t)f * 4]);
+        if (offset >= size || !CheckFrame(data, size, offset)) {
+            return false;
+        }
+    }
+
+    show->num_frames = frames;
+    return true;
+}
+
+void CompactShowSeek(const compact_show_t* show, compact_cursor_t* cursor, const uint16_t frame) {
+    const uint8_t* at = &show->data[ReadU32(&show->data[COMPACT_SHOW_HEADER_SIZE + (size_t)frame * 4])];
+    *cursor = (compact_cursor_t){0};
+    cursor->points_left = (uint16_t)CompactReadVarint(&at);
+    cursor->at = at;
+}
@@ -0,0 +1,95 @@
+#include "compact_show_encode.h"
+
+static void PutByte(compact_encoder_t* encoder, const uint8_t byte) {
+    if (encoder->size < encoder->capacity) {
+        encoder->out[encoder->size] = byte;
+    } else {
+        encoder->overflow = true;
+    }
+    ++encoder->size;
+}
+
+static void PutVarint(compact_encoder_t* encoder, uint32_t value) {
+    while (value >= 0x80u) {
+        PutByte(encoder, (uint8_t)(value | 0x80u));
+        value >>= 7;
+    }
+    PutByte(encoder, (uint8_t)value);
+}
+
+static inline uint32_t Zigzag(const int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline int16_t ClampPosition(const int16_t value) {
+    return value < 0 ? 0 : (value > COMPACT_SHOW_POS_MAX ? COMPACT_SHOW_POS_MAX : value);
+}
+
+static inline uint8_t Color8(const int16_t level) {
+    return level <= 0 ? 0 : (uint8_t)((level > 4095 ? 4095 : level) >> 4);
+}
+
+static inline uint32_t PackedColor(const compact_point_t* point) {
+    return ((uint32_t)Color8(point->r) << 16) | ((uint32_t)Color8(point->g) << 8) | Color8(point->b);
+}
+
+void CompactEncoderInit(compact_encoder_t* encoder, uint8_t* out, const size_t capacity, const uint16_t num_frames) {
+    *encoder = (compact_encoder_t){out, capacity, 0, num_frames, 0, false};
+    const uint8_t header[COMPACT_SHOW_HEADER_SIZE] = {
+        'P', 'H', 'C', 'S', COMPACT_SHOW_VERSION, 0, (uint8_t)num_frames, (uint8_t)(num_frames >> 8)
+    };
+    for (int i = 0; i < COMPACT_SHOW_HEADER_SIZE; ++i) {
+        PutByte(encoder, header[i]);
+    }
+    for (uint16_t f = 0; f < num_frames; ++f) {
+        for (int i = 0; i < 4; ++i) {
+            PutByte(encoder, 0);
+        }
+    }
+}
+
+void CompactEncodeFrame(compact_encoder_t* encoder, const compact_point_t* points, const uint16_t n) {
+    // CompactShowOpen() rejects empty frames, so does the encoder.
+    if (encoder->frame >= encoder->num_frames || n == 0) {
+        encoder->overflow = true;
+        return;
+    }
+    const size_t entry = COMPACT_SHOW_HEADER_SIZE + (size_t)encoder->frame * 4;
+    for (int i = 0; i < 4; ++i) {
+        if (entry + (size_t)i < encoder->capacity) {
+            encoder->out[entry + (size_t)i] = (uint8_t)(encoder->size >> (8 * i));
+        }
+    }
+    ++encoder->frame;
+
+    PutVarint(encoder, n);
+    int16_t x = 0;
+    int16_t y = 0;
+    for (uint16_t i = 0; i < n;) {
+        const uint32_t color = PackedColor(&points[i]);
+        uint16_t run = 1;
+        while (i + run < n && PackedColor(&points[i + run]) == color) {
+            ++run;
+        }
+
+        const bool lit = color != 0;
+        PutVarint(encoder, ((uint32_t)run << 1) | (lit ? 1u : 0u));
+        if (lit) {
+            PutByte(encoder, (uint8_t)(color >> 16));
+            PutByte(encoder, (uint8_t)(color >> 8));
+            PutByte(encoder, (uint8_t)color);
+        }
+        for (uint16_t k = 0; k < run; ++k, ++i) {
+            const int16_t px = ClampPosition(points[i].x);
+            const int16_t py = ClampPosition(points[i].y);
+            PutVarint(encoder, Zigzag(px - x));
+            PutVarint(encoder, Zigzag(py - y));
+            x = px;
+            y = py;
+        }
+    }
+}
+
+size_t CompactEncoderFinish(const compact_encoder_t* encoder) {
+    return encoder->overflow || encoder->frame != encoder->num_frames ? 0 : encoder->size;
+}
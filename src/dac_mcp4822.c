@@ -11,26 +11,23 @@
 
 #define SET_DAC_CS()      palSetPad(GPIOB, GPIO_PB12_DAC_CS)
 #define CLEAR_DAC_CS()    palClearPad(GPIOB, GPIO_PB12_DAC_CS)
-#define SET_DAC_SDI()     palSetPad(GPIOB, GPIO_PB15_DAC_MOSI)
-#define CLEAR_DAC_SDI()   palClearPad(GPIOB, GPIO_PB15_DAC_MOSI)
-#define SET_DAC_SCK()     palSetPad(GPIOB, GPIO_PB13_DAC_SCK)
-#define CLEAR_DAC_SCK()   palClearPad(GPIOB, GPIO_PB13_DAC_SCK)
 #define SET_DAC_LDAC()    palSetPad(GPIOB, GPIO_PB14_DAC_MISO)
 #define CLEAR_DAC_LDAC()  palClearPad(GPIOB, GPIO_PB14_DAC_MISO)
 
-#define NORMALIZED_TO_12BIT_FACTOR ((float)((1<<11) - 1)) // Convert [0,2.0] -> [0,0xFFF]
+#define DAC_WORDS_PER_SAMPLE 2
 
 // SPI_CR1 Settings
+// MSTR, SSM, SSI and SPE are forced on by the ChibiOS SPI driver in spiStart().
 #define SPI_CR1_CLOCK_PHASE_BIT  (0 << 0) // The first clock transition is the first data capture edge
 #define SPI_CR1_CLOCK_POLARITY   (0 << 1) // CK to 0 when idle
 #define SPI_CR1_MASTER_SELECTION (1 << 2) // Master configuration
-#define SPI_CR1_BAUD_RATE_CONFIG (0b000 << 3) // fpclk/2
+#define SPI_CR1_BAUD_RATE_CONFIG (0b000 << 3) // fpclk/2 (18MHz on APB1, MCP4822 max is 20MHz)
 #define SPI_CR1_SPI_ENABLE       (0 << 6) // SPI Disabled (turned on by driver later)
 #define SPI_CR1_FRAME_FORMAT     (0 << 7) // MSB-first
 #define SPI_CR1_INT_SS           (0 << 8) // Internal slave select
 #define SPI_CR1_SOFT_SLAVE_MGMT  (0 << 9) // Not enabled
 #define SPI_CR1_RX_ONLY          (0 << 10) // Tx and Rx
-#define SPI_CR1_DAT_FRAME_FMT    (0 << 11) // 16-bit frame
+#define SPI_CR1_DAT_FRAME_FMT    (1 << 11) // 16-bit frame
 #define SPI_CR1_CRC_TX_NEXT      (0 << 12) // No CRC phase
 #define SPI_CR1_HARDWARE_CRC     (0 << 13) // Disabled
 #define SPI_CR1_OUTPUT_ENBL      (0 << 14) // Output enabled
@@ -67,65 +64,100 @@
                           | SPI_CR2_TX_BUF_EMPTY_INT_EN)
 
 
+static void DacSpiEndCallback(SPIDriver* spip);
+
+/*
+ * SPI2 configuration. CS (PB12) is driven by the driver as a pad, one 16-bit
+ * frame per select so the MCP4822 latches each command on the CS rising edge.
+ */
+static const SPIConfig g_dac_spi_config = {
+  .end_cb = DacSpiEndCallback,
+  .ssport = GPIOB,
+  .sspad = GPIO_PB12_DAC_CS,
+  .cr1 = SPI_CR1_CONFIG,
+  .cr2 = SPI_CR2_CONFIG
+};
+
+// Command words for the frame pair in flight, read by the SPI TX DMA stream.
+static uint16_t g_dac_tx_buf[DAC_WORDS_PER_SAMPLE];
+// Index of the word currently on the wire, DAC_WORDS_PER_SAMPLE when idle.
+static volatile uint8_t g_dac_tx_word = DAC_WORDS_PER_SAMPLE;
+static dac_latch_hook_t g_dac_latch_hook = NULL;
+
+/*
+ * Runs in the SPI2 DMA ISR at the end of every 16-bit frame. Raises CS to latch
+ * the word into the DAC input register, then either starts the second word or
+ * pulls LDAC low so both channels update together and runs the latch hook.
+ */
+static void DacSpiEndCallback(SPIDriver* spip) {
+  chSysLockFromISR();
+  spiUnselectI(spip);
+  if (++g_dac_tx_word < DAC_WORDS_PER_SAMPLE) {
+    spiSelectI(spip);
+    spiStartSendI(spip, 1, &g_dac_tx_buf[g_dac_tx_word]);
+  } else {
+    CLEAR_DAC_LDAC(); // Copy DAC input registers to output
+    if (g_dac_latch_hook != NULL) {
+      g_dac_latch_hook();
+    }
+  }
+  chSysUnlockFromISR();
+}
+
 void InitDac(void) {
   /*
-   * SPI1 I/O pins setup.
+   * SPI2 I/O pins setup.
    */
-  palSetPadMode(GPIOB, 13, PAL_MODE_OUTPUT_PUSHPULL);     /* SCK. */
-  palSetPadMode(GPIOB, 14, PAL_MODE_OUTPUT_PUSHPULL);     /* MISO.*/
-  palSetPadMode(GPIOB, 15, PAL_MODE_OUTPUT_PUSHPULL);     /* MOSI.*/
-  palSetPadMode(GPIOB, 12, PAL_MODE_OUTPUT_PUSHPULL);
-  palSetPad(GPIOB, 12);
+  palSetPadMode(GPIOB, DAC_PIN_SCK, PAL_MODE_STM32_ALTERNATE_PUSHPULL);   /* SCK. */
+  palSetPadMode(GPIOB, DAC_PIN_SDI, PAL_MODE_STM32_ALTERNATE_PUSHPULL);   /* MOSI.*/
+  palSetPadMode(GPIOB, DAC_PIN_LDAC, PAL_MODE_OUTPUT_PUSHPULL);           /* LDAC on the MISO pin.*/
+  palSetPadMode(GPIOB, DAC_PIN_CS, PAL_MODE_OUTPUT_PUSHPULL);
+  SET_DAC_CS();
+  SET_DAC_LDAC();
+
+  spiStart(&SPID2, &g_dac_spi_config);
 }
 
-static uint16_t MakeCommandPacket(int16_t value, const bool is_left) {
-  if (value < 0) {
-    value = 0;
-  }
-  const uint16_t twelve_bit_cmd = (uint16_t)(value);// * NORMALIZED_TO_12BIT_FACTOR);
-  const uint16_t gain_selection = 1 << 13;
-  const uint16_t channel_bit = is_left ? (1 << 15) : 0;
-  const uint16_t power_on_bit = 1 << 12;
-  return (twelve_bit_cmd | gain_selection | channel_bit | power_on_bit);
+void SetDacLatchHook(dac_latch_hook_t hook) {
+  g_dac_latch_hook = hook;
 }
 
-void SendFrameManually(uint16_t frame) {
-  volatile int i = 0;
-  volatile int j = 0;
-  CLEAR_DAC_CS();
-  for (j =0; j < 10; ++j);
-  for (i=0; i < 16; ++i) {
-    uint16_t mask = 1 << (15 - i);
-    if (frame & mask) {
-      SET_DAC_SDI();
-    } else {
-      CLEAR_DAC_SDI();
-    }
-    for (j =0; j < 10; ++j);
-    SET_DAC_SCK();
-    for (j =0; j < 10; ++j);
-    CLEAR_DAC_SCK();
-    for (j =0; j < 10; ++j);
-  }
-  SET_DAC_CS();
-  for (j =0; j < 10; ++j);
+bool DacIdle(void) {
+  return g_dac_tx_word >= DAC_WORDS_PER_SAMPLE;
 }
 
-void TransmitSamples(const int16_t ch1_out, const int16_t ch2_out) {
-  volatile uint16_t both_samples[2] = {0};
-  both_samples[0] = MakeCommandPacket(ch1_out, true);
-  both_samples[1] = MakeCommandPacket(ch2_out, false);
-  //spiSelect(&SPID2);                  /* Slave Select assertion.          */
+bool TransmitWordsI(const uint16_t* words) {
+  if (!DacIdle()) {
+    return false;
+  }
+  g_dac_tx_buf[0] = words[0];
+  g_dac_tx_buf[1] = words[1];
+  g_dac_tx_word = 0;
   SET_DAC_LDAC(); // Don't set DAC outputs until LDAC goes low (after both inputs set)
- // spiSend(&SPID2, 4, (void*)&both_samples); /* Atomic transfer operations.      */
- SendFrameManually(both_samples[0]);
- SendFrameManually(both_samples[1]);
-  CLEAR_DAC_LDAC(); // Copy DAC input registers to output 
-  //spiUnselect(&SPID2);                /* Slave Select de-assertion.       */
+  spiSelectI(&SPID2);
+  spiStartSendI(&SPID2, 1, &g_dac_tx_buf[0]);
+
   static uint16_t tx_counter = 0;
   if ((++tx_counter) > 1000) {
     tx_counter = 0;
     palTogglePad(GPIOC, GPIOC_LED);
   }
+  return true;
+}
 
-}
\ No newline at end of file
+bool TransmitSamplesI(const int16_t ch1_out, const int16_t ch2_out) {
+  const uint16_t words[DAC_WORDS_PER_SAMPLE] = {
+    DacCommandWord(ch1_out, DAC_CMD_CH1),
+    DacCommandWord(ch2_out, DAC_CMD_CH2)
+  };
+  return TransmitWordsI(words);
+}
+
+void TransmitSamples(const int16_t ch1_out, const int16_t ch2_out) {
+  // The previous pair takes ~2us on the wire, so this wait is short.
+  while (!DacIdle()) {
+  }
+  chSysLock();
+  TransmitSamplesI(ch1_out, ch2_out);
+  chSysUnlock();
+}
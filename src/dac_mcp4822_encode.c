@@ -0,0 +1,9 @@
+/*
+ * MCP4822 command encoding. Kept free of ChibiOS includes so the same code
+ * runs on the host.
+ */
+#include "dac_mcp4822.h"
+
+uint16_t MakeCommandPacket(int16_t value, const bool is_left) {
+  return DacCommandWord(value, is_left ? DAC_CMD_CH1 : DAC_CMD_CH2);
+}
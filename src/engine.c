@@ -1,15 +1,41 @@
-#include <ch.h> // For NULL
-#include "engine.h"
-#include "math.h"
+#include <stdbool.h>
+#include <stddef.h>
 
-#define PI (3.14159265)
-#define PI_OVER_2  (PI / 2.0)
+#include "engine.h"
+#include "profile.h"
+#include "shape_tables.h"
+#include "trig_lut.h"
+
+#if ENGINE_FIXED_POINT
+#define AMP_ONE                 Q30_ONE
+#define AMP_ZERO                0
+#define AMP_FROM_RATIO(n, d)    ((engine_amp_t)(n) * Q30_RATIO(1, (d)))
+#define AMP_SCALE(value, amp)   ScaleQ30((value), (amp))
+#else
+#define AMP_ONE                 1.0f
+#define AMP_ZERO                0.0f
+#define AMP_FROM_RATIO(n, d)    ((float)(n) / (float)(d))
+#define AMP_SCALE(value, amp)   ((int32_t)((float)(value) * (amp)))
+#endif
 
 #define COLORLINE_MAX  4096
 #define NUM_COLORS 8
 #define COLORLINE_BIN_SIZE (COLORLINE_MAX / NUM_COLORS)
 
-typedef void (*modeFunctor)(engine_inputs_t* inputs, engine_outputs_t* outputs);
+typedef void (*modeFunctor)(void* state, const engine_inputs_t* inputs, const engine_audio_features_t* audio,
+                            engine_output_block_t* outputs, const int n);
+typedef void (*modeReset)(void* state);
+// Points in the closed loop a mode draws from reset for constant inputs, 0 if it never closes.
+typedef int (*modeFramePoints)(const engine_inputs_t* inputs);
+
+// A mode's entry points and where its state lives in engine_context_t.
+typedef struct modeoperator {
+    modeFunctor render;
+    modeReset reset;
+    size_t state_offset;
+    modeFramePoints frame_points;   // NULL for modes that animate
+    bool output_stages;             // False for audio drawn as it arrives, see engine_context_t
+} mode_operator_t;
 
 typedef enum colorchannel {
     RED = 0,
@@ -25,263 +51,421 @@ typedef enum generatormode{
     MODE_MESSED_UP_SPIRAL,
     MODE_RECTANGLE,
     MODE_STARRY,
+    MODE_ILDA,
+    MODE_SPECTRUM,
 
     NUM_MODES
 } GeneratorModeEnum;
 
+_Static_assert(NUM_MODES == ENGINE_NUM_MODES, "ENGINE_NUM_MODES out of date");
+_Static_assert(NUM_MODES <= PROFILE_MAX_MODES, "Not enough profile slots for every mode");
+
 const int16_t REGION_SIZE = ADC_IN_MAX / NUM_MODES;
 
 
+// mix_ratio is the Q15 weight of mode_a, see LerpQ15().
 typedef struct modemixt {
     GeneratorModeEnum mode_a;
     GeneratorModeEnum mode_b;
-    float mix_ratio;
+    q15_t mix_ratio;
 } mode_mix_t;
 
-void SetMonoColor(const colorchannel_t color, const int16_t value, engine_outputs_t* outputs) {
-    switch (color) {
-        case RED:
-            outputs->laser_pwm_output_r = value;
-            break;
-        case GREEN:
-            outputs->laser_pwm_output_g = value;
-            break;
-        case BLUE:
-        default:
-            outputs->laser_pwm_output_b = value;
-            break;        
-    }
-}
+// Colour of each COLORLINE bin, bin 0 is off. Values past the last bin clamp to white.
+static const int16_t g_color_table[NUM_COLORS + 1][3] = {
+    {0, 0, 0},
+    {LASER_PWM_MAX, 0, 0},
+    {0, LASER_PWM_MAX, 0},
+    {0, 0, LASER_PWM_MAX},
+    {0, LASER_PWM_MAX, LASER_PWM_MAX},
+    {LASER_PWM_MAX, LASER_PWM_MAX, 0},
+    {LASER_PWM_MAX, 0, LASER_PWM_MAX},
+    {LASER_PWM_MAX, LASER_PWM_MAX, LASER_PWM_MAX},
+    {LASER_PWM_MAX, LASER_PWM_MAX, LASER_PWM_MAX},
+};
 
-void IntToColors(int16_t value, engine_outputs_t* outputs, const bool off_allowed) {
+// Sets point i of a block to the colour of a COLORLINE value, as a table read rather than a switch.
+static inline void IntToColors(int16_t value, engine_output_block_t* outputs, const int i, const bool off_allowed) {
     value = value < 0 ? 0 :
                         value > COLORLINE_MAX ? COLORLINE_MAX : value;
-    int16_t bin = value / COLORLINE_BIN_SIZE + 1;
+    int16_t bin = value / COLORLINE_BIN_SIZE;
 
-    if (!off_allowed && bin == 1) {
+    if (!off_allowed && bin == 0) {
         bin += 1;
     }
 
-    switch (bin) {
-        case 1:
-            SetMonoColor(RED, 0, outputs);
-            SetMonoColor(GREEN, 0, outputs);
-            SetMonoColor(BLUE, 0, outputs);
-            break;
-        case 2:
-            SetMonoColor(RED, 1, outputs);
-            SetMonoColor(GREEN, 0, outputs);
-            SetMonoColor(BLUE, 0, outputs);
-            break;
-        case 3:
-            SetMonoColor(RED, 0, outputs);
-            SetMonoColor(GREEN, 1, outputs);
-            SetMonoColor(BLUE, 0, outputs);
-            break;
-        case 4:
-            SetMonoColor(RED, 0, outputs);
-            SetMonoColor(GREEN, 0, outputs);
-            SetMonoColor(BLUE, 1, outputs);
-            break;
-        case 5:
-            SetMonoColor(RED, 0, outputs);
-            SetMonoColor(GREEN, 1, outputs);
-            SetMonoColor(BLUE, 1, outputs);
-            break;
-        case 6:
-            SetMonoColor(RED, 1, outputs);
-            SetMonoColor(GREEN, 1, outputs);
-            SetMonoColor(BLUE, 0, outputs);
-            break;
-        case 7:
-            SetMonoColor(RED, 1, outputs);
-            SetMonoColor(GREEN, 0, outputs);
-            SetMonoColor(BLUE, 1, outputs);
-            break;
-        case 8:
-        default:
-            SetMonoColor(RED, 1, outputs);
-            SetMonoColor(GREEN, 1, outputs);
-            SetMonoColor(BLUE, 1, outputs);
-            break;
-    }
-}
-
-GeneratorModeEnum GetMode(int16_t selection_point_adc_val) {
-    int16_t int_selection_point = selection_point_adc_val / (REGION_SIZE + 1);
-
-    if (int_selection_point < 0 || int_selection_point >= NUM_MODES) {
-        while (1) {};
-    }
-    return (GeneratorModeEnum)int_selection_point;
-
+    outputs->r[i] = g_color_table[bin][RED];
+    outputs->g[i] = g_color_table[bin][GREEN];
+    outputs->b[i] = g_color_table[bin][BLUE];
 }
 
-//MODE_AUDIO_STEREO
-void operator_mode_audio_stereo(engine_inputs_t* inputs, engine_outputs_t* outputs) {
-    outputs->position_output_x = inputs->audio_in_left;
-    outputs->position_output_y = inputs->audio_in_right;
-    int16_t color = inputs->cv_in_right/5;
-    IntToColors(color, outputs, false);
-}
+// First middle CV value of each mode's region, and one past the last region.
+#define MODE_REGION_START(mode) ((mode) * (ADC_IN_MAX / NUM_MODES + 1))
+static const int16_t g_mode_region_start[NUM_MODES + 1] = {
+    MODE_REGION_START(0), MODE_REGION_START(1), MODE_REGION_START(2), MODE_REGION_START(3),
+    MODE_REGION_START(4), MODE_REGION_START(5), MODE_REGION_START(6), MODE_REGION_START(7),
+    MODE_REGION_START(8), MODE_REGION_START(9),
+};
+_Static_assert(NUM_MODES == 9, "g_mode_region_start lists one entry per mode");
 
-// MODE_AUDIO_MONO_WAVEFORM
-void operator_mode_audio_mono(engine_inputs_t* inputs, engine_outputs_t* outputs) {
-    static int16_t x_value = 0;
-    const int16_t x_rate = 100;//inputs->cv_in_left;
-    x_value += x_rate;
-    int16_t color;
-    if (x_value > LASER_POS_MAX) {
-        color = 0;
-        IntToColors(0, outputs, true);
-    } else {
-        color = inputs->cv_in_right;
-        IntToColors(color, outputs, false);
+int GetMode(const int16_t selection_point_adc_val) {
+    int mode = 0;
+    while (mode < NUM_MODES - 1 && selection_point_adc_val >= g_mode_region_start[mode + 1]) {
+        ++mode;
     }
-    x_value = x_value % LASER_POS_MAX;
-    outputs->position_output_x = x_value;
-    outputs->position_output_y = inputs->audio_in_right;
+    return mode;
 }
 
-// MODE_SPINNING_COIN
-void operator_mode_messed_up_spiral(engine_inputs_t* inputs, engine_outputs_t* outputs) {
-    static int16_t x_val = 0;
-    static int16_t y_val = 0;
-    static float t = 0;
-    static float amplitude = 0;
-
-    float dt = (float)inputs->cv_in_left / 10000;
-    float d_amplitude = (float)inputs->cv_in_right / 100000; // Arbitrary denom
-
-    amplitude += d_amplitude;
-    if (amplitude > 1.0) {
-        amplitude = 0.0;
+int UpdateModeSelector(mode_selector_t* selector, const int16_t selection_point_adc_val) {
+    const int16_t cv = selection_point_adc_val;
+    if (!selector->primed) {
+        selector->primed = true;
+        selector->mode = GetMode(cv);
+        selector->candidate = selector->mode;
+        selector->last_cv = cv;
+        return selector->mode;
+    }
+    const int16_t change = cv > selector->last_cv ? cv - selector->last_cv : selector->last_cv - cv;
+    if (selector->candidate == selector->mode && change <= selector->config.deadband) {
+        return selector->mode;
+    }
+    selector->last_cv = cv;
+
+    // Inside the current region widened by the hysteresis, nothing to do.
+    const int mode = selector->mode;
+    const int16_t hysteresis = selector->config.hysteresis;
+    if (cv >= g_mode_region_start[mode] - hysteresis && cv < g_mode_region_start[mode + 1] + hysteresis) {
+        selector->candidate = mode;
+        selector->settled = 0;
+        return mode;
     }
-    t += dt;
-    x_val = (int16_t)(sin(t) * LASER_POS_MAX * amplitude) + LASER_POS_MAX;
-    y_val = (int16_t)(sin(t + PI_OVER_2) * LASER_POS_MAX) + LASER_POS_MAX;
-
 
-    static int16_t color = 0;
-    int16_t dcolor = inputs->cv_in_right;
-    color += dcolor;
-    color = color > COLORLINE_MAX ? 0 : color;
-    IntToColors(color, outputs, true);
+    const int candidate = GetMode(cv);
+    selector->settled = candidate == selector->candidate ? selector->settled + 1 : 1;
+    selector->candidate = candidate;
+    if (selector->settled >= selector->config.settle_blocks) {
+        selector->mode = candidate;
+        selector->settled = 0;
+        ++selector->switches;
+    }
+    return selector->mode;
+}
 
-    outputs->position_output_x = x_val;
-    outputs->position_output_y = y_val;
+//MODE_AUDIO_STEREO
+void operator_mode_audio_stereo(void* state, const engine_inputs_t* inputs, const engine_audio_features_t* audio,
+                                engine_output_block_t* outputs, const int n) {
+    (void)state;
+    (void)audio;
+    for (int i = 0; i < n; ++i) {
+        outputs->x[i] = inputs[i].audio_in_left;
+        outputs->y[i] = inputs[i].audio_in_right;
+        int16_t color = inputs[i].cv_in_right/5;
+        IntToColors(color, outputs, i, false);
+    }
 }
 
-void operator_mode_spinning_coin(engine_inputs_t* inputs, engine_outputs_t* outputs) {
-    static int16_t x_val = 0;
-    static int16_t y_val = 0;
-    static float t = 0;
-    static float amplitude = 0;
+// MODE_AUDIO_MONO_WAVEFORM
+void reset_mode_audio_mono(void* state) {
+    mode_state_audio_mono_t* s = state;
+    s->x_value = 0;
+}
 
-    const int16_t range_start = REGION_SIZE * (int16_t)MODE_SPINNING_COIN;
+void operator_mode_audio_mono(void* state, const engine_inputs_t* inputs, const engine_audio_features_t* audio,
+                              engine_output_block_t* outputs, const int n) {
+    (void)audio;
+    mode_state_audio_mono_t* s = state;
+    const int16_t x_rate = 100;//inputs->cv_in_left;
+    int16_t x_value = s->x_value;
+    for (int i = 0; i < n; ++i) {
+        x_value += x_rate;
+        if (x_value > LASER_POS_MAX) {
+            IntToColors(0, outputs, i, true);
+        } else {
+            IntToColors(inputs[i].cv_in_right, outputs, i, false);
+        }
+        x_value = x_value % LASER_POS_MAX;
+        outputs->x[i] = x_value;
+        outputs->y[i] = inputs[i].audio_in_right;
+    }
+    s->x_value = x_value;
+}
 
-    const float dt = (float)(inputs->cv_in_middle - range_start) / 100.0;
+// MODE_SPECTRUM
+#define SPECTRUM_BAR_POINTS     8
+#define SPECTRUM_BAR_SPACING    ((LASER_POS_MAX + 1) / SPECTRUM_NUM_BANDS)
+// Spectra the bars fall by at most in one block, enough to empty them at the slowest release.
+#define SPECTRUM_MAX_FALL       256
+
+void reset_mode_spectrum(void* state) {
+    mode_state_spectrum_t* s = state;
+    s->spectra = 0;
+    for (int channel = 0; channel < SPECTRUM_NUM_CHANNELS; ++channel) {
+        for (int band = 0; band < SPECTRUM_NUM_BANDS; ++band) {
+            s->level[channel][band] = 0;
+        }
+    }
+    s->point = 0;
+    s->beat_color = 0;
+    s->beats = 0;
+}
 
-    static float sign = 1.0;
-    float d_amplitude = (float)inputs->cv_in_left / 100000.0; // Arbitrary denom
+/*
+ * A bar per band, the left channel's level up from the centre line and the
+ * right's down. Each bar is one stroke, alternately up and down, with its
+ * first point blanked over the move from the last bar. The left CV sets
+ * the bar height, the middle CV within the region slows the bars' fall
+ * and the right CV shifts the colours along them. The colours also step a
+ * bin on every beat the beat tracker flags. The spectra come from the input
+ * side's analyzer, the bars fall by every one since the block last drawn.
+ */
+void operator_mode_spectrum(void* state, const engine_inputs_t* inputs, const engine_audio_features_t* audio,
+                            engine_output_block_t* outputs, const int n) {
+    mode_state_spectrum_t* s = state;
+    const int16_t range_start = g_mode_region_start[MODE_SPECTRUM];
+    if (audio->spectra != s->spectra) {
+        // Bars jump up to a new level and fall from a quarter of full height per spectrum down to 1/230.
+        const uint32_t spectra = audio->spectra - s->spectra;
+        const int32_t falls = spectra < SPECTRUM_MAX_FALL ? (int32_t)spectra : SPECTRUM_MAX_FALL;
+        const int32_t offset = inputs[0].cv_in_middle - range_start;
+        const int32_t release = Q15_MAX / (4 + (offset < 0 ? 0 : offset) / 2);
+        for (int channel = 0; channel < SPECTRUM_NUM_CHANNELS; ++channel) {
+            for (int band = 0; band < SPECTRUM_NUM_BANDS; ++band) {
+                const int32_t fallen = s->level[channel][band] - release * falls;
+                const q15_t level = audio->spectrum[channel][band];
+                s->level[channel][band] = level > fallen ? level : (q15_t)(fallen < 0 ? 0 : fallen);
+            }
+        }
+        s->spectra = audio->spectra;
+    }
 
-    amplitude += d_amplitude * sign;
-    if (amplitude > 1.0) {
-        sign = -1.0;
-    } else if (amplitude < -1.0) {
-        sign = 1.0;
+    int16_t point = s->point;
+    // A bin for every beat since the block last drawn.
+    const uint32_t new_beats = (audio->beats - s->beats) % NUM_COLORS;
+    const int16_t beat_color = (int16_t)((s->beat_color + (int32_t)new_beats * COLORLINE_BIN_SIZE) % COLORLINE_MAX);
+
+    for (int i = 0; i < n; ++i) {
+        const int band = point / SPECTRUM_BAR_POINTS;
+        const int step = point % SPECTRUM_BAR_POINTS;
+        const int32_t height = inputs[i].cv_in_left / 2;
+        const int32_t top = LASER_MIDPOINT + ScaleQ15(s->level[0][band], height);
+        const int32_t bottom = LASER_MIDPOINT - ScaleQ15(s->level[1][band], height);
+        const int32_t from = band & 1 ? top : bottom;
+        const int32_t to = band & 1 ? bottom : top;
+        outputs->x[i] = (int16_t)(band * SPECTRUM_BAR_SPACING + SPECTRUM_BAR_SPACING / 2);
+        outputs->y[i] = (int16_t)(from + (to - from) * step / (SPECTRUM_BAR_POINTS - 1));
+        if (step == 0) {
+            IntToColors(0, outputs, i, true);
+        } else {
+            IntToColors((int16_t)((inputs[i].cv_in_right + beat_color + band * COLORLINE_BIN_SIZE) % COLORLINE_MAX),
+                        outputs, i, false);
+        }
+        point = point + 1 == SPECTRUM_NUM_BANDS * SPECTRUM_BAR_POINTS ? 0 : point + 1;
     }
-    t += dt;
-    x_val = (int16_t)(sin(t) * (float)ADC_IN_MIDPOINT * amplitude) + ADC_IN_MIDPOINT;
-    y_val = (int16_t)(cos(t) * (float)ADC_IN_MIDPOINT) + ADC_IN_MIDPOINT;
+    s->point = point;
+    s->beat_color = beat_color;
+    s->beats = audio->beats;
+}
 
-    outputs->position_output_x = x_val;
-    outputs->position_output_y = y_val;
+// MODE_MESSED_UP_SPIRAL
+void reset_mode_messed_up_spiral(void* state) {
+    mode_state_messed_up_spiral_t* s = state;
+    s->t = 0;
+    s->amplitude = AMP_ZERO;
+    s->color = 0;
+}
 
+void operator_mode_messed_up_spiral(void* state, const engine_inputs_t* inputs, const engine_audio_features_t* audio,
+                                    engine_output_block_t* outputs, const int n) {
+    (void)audio;
+    mode_state_messed_up_spiral_t* s = state;
+    phase_t t = s->t;
+    engine_amp_t amplitude = s->amplitude;
+    int16_t color = s->color;
+
+    for (int i = 0; i < n; ++i) {
+        const phase_t dt = (phase_t)inputs[i].cv_in_left * (PHASE_PER_RADIAN / 10000);
+        const engine_amp_t d_amplitude = AMP_FROM_RATIO(inputs[i].cv_in_right, 100000); // Arbitrary denom
+
+        amplitude += d_amplitude;
+        if (amplitude > AMP_ONE) {
+            amplitude = AMP_ZERO;
+        }
+        t += dt;
+        const shape_point_t circle = CircleQ15(t);
+        outputs->x[i] = (int16_t)AMP_SCALE(ScaleQ15(circle.y, LASER_POS_MAX), amplitude) + LASER_POS_MAX;
+        outputs->y[i] = (int16_t)ScaleQ15(circle.x, LASER_POS_MAX) + LASER_POS_MAX;
+
+        int16_t dcolor = inputs[i].cv_in_right;
+        color += dcolor;
+        color = color > COLORLINE_MAX ? 0 : color;
+        IntToColors(color, outputs, i, true);
+    }
 
-    int16_t color_setpoint = inputs->cv_in_right;
+    s->t = t;
+    s->amplitude = amplitude;
+    s->color = color;
+}
 
-    if (color_setpoint > ADC_IN_MAX / 2) {
-        color_setpoint -= ADC_IN_MAX / 2;
-        color_setpoint *= 1;
-        static float color_phase = 0;
-        color_phase = color_phase + color_setpoint;
-        int16_t dynamic_color = (int16_t)(sin(t + (float)color_phase/100000.0) * ADC_IN_MIDPOINT) + ADC_IN_MIDPOINT;
-        IntToColors(dynamic_color, outputs, false);
-    } else {
-        IntToColors(color_setpoint*2, outputs, false);
-    }
+// MODE_SPINNING_COIN
+void reset_mode_spinning_coin(void* state) {
+    mode_state_spinning_coin_t* s = state;
+    s->t = 0;
+    s->color_phase = 0;
+    s->amplitude = AMP_ZERO;
+    s->rising = true;
 }
 
-void operator_mode_spiral(engine_inputs_t* inputs, engine_outputs_t* outputs) {
-    static int16_t x_val = 0;
-    static int16_t y_val = 0;
-    static float t = 0;
-    static float amplitude = 0;
-    const int16_t range_start = REGION_SIZE * (int16_t)MODE_SPIRAL;
+void operator_mode_spinning_coin(void* state, const engine_inputs_t* inputs, const engine_audio_features_t* audio,
+                                 engine_output_block_t* outputs, const int n) {
+    (void)audio;
+    mode_state_spinning_coin_t* s = state;
+    const int16_t range_start = g_mode_region_start[MODE_SPINNING_COIN];
+    phase_t t = s->t;
+    phase_t color_phase = s->color_phase;
+    engine_amp_t amplitude = s->amplitude;
+    bool rising = s->rising;
+
+    for (int i = 0; i < n; ++i) {
+        // Wraps modulo a full turn if the CV sits below the region start.
+        const phase_t dt = (phase_t)(int32_t)(inputs[i].cv_in_middle - range_start) * (PHASE_PER_RADIAN / 100);
+
+        const engine_amp_t d_amplitude = AMP_FROM_RATIO(inputs[i].cv_in_left, 100000); // Arbitrary denom
+
+        amplitude += rising ? d_amplitude : -d_amplitude;
+        if (amplitude > AMP_ONE) {
+            rising = false;
+        } else if (amplitude < -AMP_ONE) {
+            rising = true;
+        }
+        t += dt;
+        const shape_point_t circle = CircleQ15(t);
+        outputs->x[i] = (int16_t)AMP_SCALE(ScaleQ15(circle.y, ADC_IN_MIDPOINT), amplitude) + ADC_IN_MIDPOINT;
+        outputs->y[i] = (int16_t)ScaleQ15(circle.x, ADC_IN_MIDPOINT) + ADC_IN_MIDPOINT;
+
+        int16_t color_setpoint = inputs[i].cv_in_right;
+
+        if (color_setpoint > ADC_IN_MAX / 2) {
+            color_setpoint -= ADC_IN_MAX / 2;
+            color_phase += (phase_t)color_setpoint * (PHASE_PER_RADIAN / 100000);
+            int16_t dynamic_color = (int16_t)ScaleQ15(SinQ15(t + color_phase), ADC_IN_MIDPOINT) + ADC_IN_MIDPOINT;
+            IntToColors(dynamic_color, outputs, i, false);
+        } else {
+            IntToColors(color_setpoint*2, outputs, i, false);
+        }
+    }
 
-    const int dt = (float)(inputs->cv_in_middle - range_start) / 100.0;
+    s->t = t;
+    s->color_phase = color_phase;
+    s->amplitude = amplitude;
+    s->rising = rising;
+}
 
-    static float sign = 1.0;
-    float d_amplitude = (float)inputs->cv_in_left / 100000; // Arbitrary denom
+// MODE_SPIRAL
+// Streams: whole radian steps never bring the angle back round, so one pass
+// played as a frame would jump at its seam and stop the rotation.
+void reset_mode_spiral(void* state) {
+    mode_state_spiral_t* s = state;
+    s->t = 0;
+    s->amplitude = AMP_ZERO;
+    s->rising = true;
+}
 
-    amplitude += d_amplitude * sign;
-    if (amplitude > 1.0) {
-        sign = -1.0;
-    } else if (amplitude < 0.0) {
-        sign = 1.0;
+void operator_mode_spiral(void* state, const engine_inputs_t* inputs, const engine_audio_features_t* audio,
+                          engine_output_block_t* outputs, const int n) {
+    (void)audio;
+    mode_state_spiral_t* s = state;
+    const int16_t range_start = g_mode_region_start[MODE_SPIRAL];
+    phase_t t = s->t;
+    engine_amp_t amplitude = s->amplitude;
+    bool rising = s->rising;
+
+    for (int i = 0; i < n; ++i) {
+        // Whole radians per point, as before.
+        const int dt = (inputs[i].cv_in_middle - range_start) / 100;
+
+        const engine_amp_t d_amplitude = AMP_FROM_RATIO(inputs[i].cv_in_left, 100000); // Arbitrary denom
+
+        amplitude += rising ? d_amplitude : -d_amplitude;
+        if (amplitude > AMP_ONE) {
+            rising = false;
+        } else if (amplitude < AMP_ZERO) {
+            rising = true;
+        }
+        t += (phase_t)dt * PHASE_PER_RADIAN;
+        const shape_point_t circle = CircleQ15(t);
+        outputs->x[i] = (int16_t)AMP_SCALE(ScaleQ15(circle.y, ADC_IN_MIDPOINT), amplitude) + ADC_IN_MIDPOINT;
+        outputs->y[i] = (int16_t)AMP_SCALE(ScaleQ15(circle.x, ADC_IN_MIDPOINT), amplitude) + ADC_IN_MIDPOINT;
+
+        IntToColors(inputs[i].cv_in_right, outputs, i, false);
     }
-    t += dt;
-    x_val = (int16_t)(sin(t) * (float)ADC_IN_MIDPOINT * amplitude) + ADC_IN_MIDPOINT;
-    y_val = (int16_t)(cos(t) * (float)ADC_IN_MIDPOINT * amplitude) + ADC_IN_MIDPOINT;
 
+    s->t = t;
+    s->amplitude = amplitude;
+    s->rising = rising;
+}
 
-    int16_t color = inputs->cv_in_right;
-
-    IntToColors(color, outputs, false);
-
-    outputs->position_output_x = x_val;
-    outputs->position_output_y = y_val;
+// MODE_RECTANGLE
+// t steps by dt and wraps to 0 at the perimeter. Colour cycling is frozen into the frame.
+int frame_points_rectangle(const engine_inputs_t* inputs) {
+    const int width = inputs->cv_in_left;
+    const int dt = inputs->cv_in_middle - g_mode_region_start[MODE_RECTANGLE];
+    if (width <= 0 || dt <= 0) {
+        return dt < 0 ? 0 : 1;
+    }
+    return (4 * width + dt - 1) / dt;
 }
 
-void operator_mode_rectangle(engine_inputs_t* inputs, engine_outputs_t* outputs) {
-    int16_t x_out = 0;
-    int16_t y_out = 0;
+void reset_mode_rectangle(void* state) {
+    mode_state_rectangle_t* s = state;
+    s->t = 0;
+    s->color = 0;
+}
 
-    const int16_t range_start = REGION_SIZE * (int16_t)MODE_RECTANGLE;
+void operator_mode_rectangle(void* state, const engine_inputs_t* inputs, const engine_audio_features_t* audio,
+                             engine_output_block_t* outputs, const int n) {
+    (void)audio;
+    mode_state_rectangle_t* s = state;
+    const int16_t range_start = g_mode_region_start[MODE_RECTANGLE];
     //const int16_t range_end = ADC_IN_MAX / NUM_COLORS * ((int16_t)MODE_RECTANGLE + 1);
-    static int16_t t = 0;
-
-    const int dt = (inputs->cv_in_middle - range_start);
-    int16_t width = inputs->cv_in_left;
-    const int16_t halfwidth = width/2;
-
-    t += dt;
-    if (t >= 4*width) {
-        t = 0;
-    }
-    if (t < width) {
-        x_out = LASER_MIDPOINT + t - halfwidth; // MID - half, MID + half
-        y_out = LASER_MIDPOINT - halfwidth; // MID - half
-    } else if (t < 2*width) {
-        x_out = LASER_MIDPOINT + halfwidth; // MID + half
-        y_out = LASER_MIDPOINT + t - width - halfwidth; // MID - half, MID + half
-    } else if (t < 3*width) {
-        x_out = LASER_MIDPOINT - (t - 2*width - halfwidth); // MID
-        y_out = LASER_MIDPOINT + halfwidth;
-    } else {//(t < 4LASER_POS_MAX) {
-        x_out = LASER_MIDPOINT - halfwidth;
-        y_out = LASER_MIDPOINT - (t - 3*width - halfwidth);
+    int16_t t = s->t;
+    int16_t color = s->color;
+
+    for (int i = 0; i < n; ++i) {
+        int16_t x_out = 0;
+        int16_t y_out = 0;
+
+        const int dt = (inputs[i].cv_in_middle - range_start);
+        int16_t width = inputs[i].cv_in_left;
+        const int16_t halfwidth = width/2;
+
+        t += dt;
+        if (t >= 4*width) {
+            t = 0;
+        }
+        if (t < width) {
+            x_out = LASER_MIDPOINT + t - halfwidth; // MID - half, MID + half
+            y_out = LASER_MIDPOINT - halfwidth; // MID - half
+        } else if (t < 2*width) {
+            x_out = LASER_MIDPOINT + halfwidth; // MID + half
+            y_out = LASER_MIDPOINT + t - width - halfwidth; // MID - half, MID + half
+        } else if (t < 3*width) {
+            x_out = LASER_MIDPOINT - (t - 2*width - halfwidth); // MID
+            y_out = LASER_MIDPOINT + halfwidth;
+        } else {//(t < 4LASER_POS_MAX) {
+            x_out = LASER_MIDPOINT - halfwidth;
+            y_out = LASER_MIDPOINT - (t - 3*width - halfwidth);
+        }
+
+        int16_t dcolor = inputs[i].cv_in_right*10;
+        color += dcolor;
+        color = color > COLORLINE_MAX ? 0 : color;
+        IntToColors(color, outputs, i, false);
+
+        outputs->x[i] = x_out;
+        outputs->y[i] = y_out;
     }
 
-    static int16_t color = 0;
-    int16_t dcolor = inputs->cv_in_right*10;
-    color += dcolor;
-    color = color > COLORLINE_MAX ? 0 : color;
-    IntToColors(color, outputs, false);
-
-    outputs->position_output_x = x_out;
-    outputs->position_output_y = y_out;
+    s->t = t;
+    s->color = color;
 }
 
 // void operator_mode_full_scan(engine_inputs_t* inputs, engine_outputs_t* outputs) {
@@ -313,48 +497,193 @@ void operator_mode_rectangle(engine_inputs_t* inputs, engine_outputs_t* outputs)
 //     outputs->position_output_y = y_out;
 // }
 
-void operator_mode_starry(engine_inputs_t* inputs, engine_outputs_t* outputs) {
-    static int16_t x_val = 0;
-    static int16_t y_val = 0;
-    static float t = 0;
-    static float amplitude = 0;
-
-    const int16_t range_start = REGION_SIZE * (int16_t)MODE_STARRY;
-    const int16_t num = (inputs->cv_in_middle - range_start) / 100;
-    const int16_t denom = 1 + (inputs->cv_in_left / 800);
-    const float dtheta = (float)PI * (float)num / (float)denom;
-    t += dtheta;
-    x_val = (int16_t)(cos(t) * (float)ADC_IN_MIDPOINT) + ADC_IN_MIDPOINT;
-    y_val = (int16_t)(sin(t) * (float)ADC_IN_MIDPOINT) + ADC_IN_MIDPOINT;
-
-    outputs->position_output_x = x_val;
-    outputs->position_output_y = y_val;
-
-
-    int16_t color_setpoint = inputs->cv_in_right;
-
-    if (color_setpoint > ADC_IN_MAX / 2) {
-        color_setpoint -= ADC_IN_MAX / 2;
-        color_setpoint *= 1;
-        static float color_phase = 0;
-        color_phase = color_phase + color_setpoint;
-        int16_t dynamic_color = (int16_t)(sin(t + (float)color_phase/100000.0) * ADC_IN_MIDPOINT) + ADC_IN_MIDPOINT;
-        IntToColors(dynamic_color, outputs, false);
+// MODE_STARRY
+static int GreatestCommonDivisor(int a, int b) {
+    while (b != 0) {
+        const int r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+// Steps of PI * num / denom close after 2 * denom / gcd(num, 2 * denom) points.
+int frame_points_starry(const engine_inputs_t* inputs) {
+    const int num = (inputs->cv_in_middle - g_mode_region_start[MODE_STARRY]) / 100;
+    const int denom = 1 + (inputs->cv_in_left / 800);
+    if (num <= 0) {
+        return num < 0 ? 0 : 1;
+    }
+    return 2 * denom / GreatestCommonDivisor(num, 2 * denom);
+}
+
+// Phase of a g_shape_circle_starry point, for the colour cycle.
+#define STARRY_PHASE_PER_POINT  35791394u   // 2^32 / SHAPE_STARRY_POINTS, rounded
+
+void reset_mode_starry(void* state) {
+    mode_state_starry_t* s = state;
+    s->point = 0;
+    s->color_phase = 0;
+}
+
+void operator_mode_starry(void* state, const engine_inputs_t* inputs, const engine_audio_features_t* audio,
+                          engine_output_block_t* outputs, const int n) {
+    (void)audio;
+    mode_state_starry_t* s = state;
+    const int16_t range_start = g_mode_region_start[MODE_STARRY];
+    int32_t point = s->point;
+    phase_t color_phase = s->color_phase;
+
+    for (int i = 0; i < n; ++i) {
+        const int16_t num = (inputs[i].cv_in_middle - range_start) / 100;
+        const int16_t denom = 1 + (inputs[i].cv_in_left / 800);
+        // PI * num / denom, modulo a full turn, is num * SHAPE_STARRY_POINTS / (2 * denom) points.
+        point += num * (SHAPE_STARRY_POINTS / 2 / denom);
+        point %= SHAPE_STARRY_POINTS;
+        point += point < 0 ? SHAPE_STARRY_POINTS : 0;
+        const shape_point_t circle = g_shape_circle_starry[point];
+        outputs->x[i] = (int16_t)ScaleQ15(circle.x, ADC_IN_MIDPOINT) + ADC_IN_MIDPOINT;
+        outputs->y[i] = (int16_t)ScaleQ15(circle.y, ADC_IN_MIDPOINT) + ADC_IN_MIDPOINT;
+
+        int16_t color_setpoint = inputs[i].cv_in_right;
+
+        if (color_setpoint > ADC_IN_MAX / 2) {
+            color_setpoint -= ADC_IN_MAX / 2;
+            color_phase += (phase_t)color_setpoint * (PHASE_PER_RADIAN / 100000);
+            const phase_t t = (phase_t)point * STARRY_PHASE_PER_POINT;
+            int16_t dynamic_color = (int16_t)ScaleQ15(SinQ15(t + color_phase), ADC_IN_MIDPOINT) + ADC_IN_MIDPOINT;
+            IntToColors(dynamic_color, outputs, i, false);
+        } else {
+            IntToColors(color_setpoint*2, outputs, i, false);
+        }
+    }
+
+    s->point = (int16_t)point;
+    s->color_phase = color_phase;
+}
+
+// MODE_ILDA
+void reset_mode_ilda(void* state) {
+    mode_state_ilda_t* s = state;
+    s->cursor = (ilda_cursor_t){0};
+    s->compact_cursor = (compact_cursor_t){0};
+    s->step = 0;
+    s->step_phase = 0;
+}
+
+static inline uint16_t IldaShowFrames(const mode_state_ilda_t* s) {
+    return s->compact ? s->compact_show.num_frames : s->show.num_frames;
+}
+
+static inline bool IldaShowNextPoint(mode_state_ilda_t* s, compact_point_t* point) {
+    if (s->compact) {
+        return CompactNextPoint(&s->compact_cursor, point);
+    }
+    ilda_point_t ilda;
+    if (!IldaNextPoint(&s->show, &s->cursor, &ilda)) {
+        return false;
+    }
+    *point = (compact_point_t){ilda.x, ilda.y, ilda.r, ilda.g, ilda.b};
+    return true;
+}
+
+static inline void IldaShowSeek(mode_state_ilda_t* s, const uint16_t frame) {
+    if (s->compact) {
+        CompactShowSeek(&s->compact_show, &s->compact_cursor, frame);
     } else {
-        IntToColors(color_setpoint*2, outputs, false);
-    }   
-}
-
-modeFunctor g_mode_functors[NUM_MODES] = {
-    &operator_mode_audio_stereo,
-    &operator_mode_audio_mono,
-    &operator_mode_spinning_coin,
-    &operator_mode_spiral,
-    &operator_mode_messed_up_spiral,
-    &operator_mode_rectangle,
-    &operator_mode_starry,
+        IldaSeekFrame(&s->show, &s->cursor, frame);
+    }
+}
+
+/*
+ * Streams the show straight out of flash. The left CV selects the frame, the
+ * middle CV within the region sets the playback speed, from paused up to a
+ * new frame every pass. A frame is always drawn whole before the next.
+ */
+void operator_mode_ilda(void* state, const engine_inputs_t* inputs, const engine_audio_features_t* audio,
+                        engine_output_block_t* outputs, const int n) {
+    (void)audio;
+    mode_state_ilda_t* s = state;
+    const int16_t range_start = g_mode_region_start[MODE_ILDA];
+    const uint32_t num_frames = IldaShowFrames(s);
+
+    for (int i = 0; i < n; ++i) {
+        // Each frame is tried at most once, a show without points plays as a blanked midpoint.
+        compact_point_t point = {LASER_MIDPOINT, LASER_MIDPOINT, 0, 0, 0};
+        for (uint32_t seeks = 0; num_frames > 0 && !IldaShowNextPoint(s, &point); ++seeks) {
+            if (seeks == num_frames) {
+                point = (compact_point_t){LASER_MIDPOINT, LASER_MIDPOINT, 0, 0, 0};
+                break;
+            }
+            const int32_t offset = inputs[i].cv_in_middle - range_start;
+            s->step_phase += (uint32_t)(offset < 0 ? 0 : offset) * (1u << 16) / (uint32_t)REGION_SIZE;
+            s->step = (uint16_t)((s->step + (s->step_phase >> 16)) % num_frames);
+            s->step_phase &= 0xFFFFu;
+            const uint32_t selected = (uint32_t)inputs[i].cv_in_left * num_frames / (ADC_IN_MAX + 1);
+            IldaShowSeek(s, (uint16_t)((selected + s->step) % num_frames));
+        }
+        outputs->x[i] = point.x;
+        outputs->y[i] = point.y;
+        outputs->r[i] = point.r;
+        outputs->g[i] = point.g;
+        outputs->b[i] = point.b;
+    }
+}
+
+// Stateless modes have no reset and share offset 0, they never touch the state pointer.
+const mode_operator_t g_mode_operators[NUM_MODES] = {
+    {&operator_mode_audio_stereo, NULL, 0, NULL, false},
+    {&operator_mode_audio_mono, &reset_mode_audio_mono, offsetof(engine_context_t, audio_mono), NULL, false},
+    {&operator_mode_spinning_coin, &reset_mode_spinning_coin, offsetof(engine_context_t, spinning_coin), NULL, true},
+    {&operator_mode_spiral, &reset_mode_spiral, offsetof(engine_context_t, spiral), NULL, true},
+    {&operator_mode_messed_up_spiral, &reset_mode_messed_up_spiral, offsetof(engine_context_t, messed_up_spiral), NULL,
+     true},
+    {&operator_mode_rectangle, &reset_mode_rectangle, offsetof(engine_context_t, rectangle), &frame_points_rectangle,
+     true},
+    {&operator_mode_starry, &reset_mode_starry, offsetof(engine_context_t, starry), &frame_points_starry, true},
+    {&operator_mode_ilda, &reset_mode_ilda, offsetof(engine_context_t, ilda), NULL, true},
+    {&operator_mode_spectrum, &reset_mode_spectrum, offsetof(engine_context_t, spectrum), NULL, true},
 };
 
+static inline void* ModeState(engine_context_t* context, const GeneratorModeEnum mode) {
+    return (uint8_t*)context + g_mode_operators[mode].state_offset;
+}
+
+void InitEngine(engine_context_t* context) {
+    context->crossfade_enabled = true;
+    context->output_stages = true;
+    context->mode_selector = (mode_selector_t){
+        .config = {ENGINE_MODE_HYSTERESIS_DEFAULT, ENGINE_MODE_SETTLE_DEFAULT, ENGINE_MODE_DEADBAND_DEFAULT},
+    };
+    context->ilda.compact = false;
+    context->ilda.show = (ilda_file_t){0};
+    SetEngineIldaShow(context, g_ilda_default_show, g_ilda_default_show_size);
+    for (int mode = 0; mode < NUM_MODES; ++mode) {
+        ResetEngineMode(context, mode);
+    }
+}
+
+void ResetEngineMode(engine_context_t* context, const int mode) {
+    if (mode < 0 || mode >= NUM_MODES || g_mode_operators[mode].reset == NULL) {
+        return;
+    }
+    g_mode_operators[mode].reset(ModeState(context, (GeneratorModeEnum)mode));
+}
+
+bool SetEngineIldaShow(engine_context_t* context, const uint8_t* data, const size_t size) {
+    ilda_file_t show;
+    compact_show_t compact_show;
+    const bool compact = CompactShowOpen(&compact_show, data, size);
+    if (!compact && !IldaOpen(&show, data, size)) {
+        return false;
+    }
+    context->ilda.compact = compact;
+    context->ilda.show = compact ? (ilda_file_t){0} : show;
+    context->ilda.compact_show = compact ? compact_show : (compact_show_t){0};
+    ResetEngineMode(context, MODE_ILDA);
+    return true;
+}
+
 normalized_inputs_t NormalizeInputs(engine_inputs_t* inputs) {
     normalized_inputs_t result;
     result.audio_in_left = (float)(inputs->audio_in_left - ADC_IN_MIDPOINT) / (float)ADC_IN_MAX;
@@ -368,7 +697,7 @@ normalized_inputs_t NormalizeInputs(engine_inputs_t* inputs) {
 engine_outputs_t DenormalizeOutputs(normalized_outputs_t* outputs) {
     engine_outputs_t result;
     result.position_output_x = (int16_t)(outputs->position_output_x *  (float)ADC_IN_MAX) + ADC_IN_MIDPOINT;
-    result.position_output_x = (int16_t)(outputs->position_output_x *  (float)ADC_IN_MAX) + ADC_IN_MIDPOINT;
+    result.position_output_y = (int16_t)(outputs->position_output_y *  (float)ADC_IN_MAX) + ADC_IN_MIDPOINT;
     result.laser_pwm_output_r = (int16_t)(outputs->laser_pwm_output_r * (float)ADC_IN_MAX);
     result.laser_pwm_output_g = (int16_t)(outputs->laser_pwm_output_g * (float)ADC_IN_MAX);
     result.laser_pwm_output_b = (int16_t)(outputs->laser_pwm_output_b * (float)ADC_IN_MAX);
@@ -407,13 +736,202 @@ engine_outputs_t MixEngineOutputs(engine_outputs_t* out_a, engine_outputs_t* out
     return result;
 }
 
-void RunEngine(engine_inputs_t* inputs, engine_outputs_t* outputs) {
+/*
+ * Within ENGINE_CROSSFADE_HALF_WIDTH of a boundary of the selected mode the
+ * selection is that mode plus its neighbour across the boundary, weighted
+ * linearly so the mix is continuous and exactly 50/50 on the boundary
+ * itself. The weight depends on the CV alone, so it is the same whichever
+ * side of the hysteresis the selection is on. Past the crossfade, while a
+ * switch to the neighbour settles, the neighbour gets all of the weight;
+ * CVs further out keep the selected mode until it switches.
+ */
+static mode_mix_t GetModeMix(const int mode, const int16_t selection_point_adc_val) {
+    const int16_t cv = selection_point_adc_val;
+    mode_mix_t mix = {(GeneratorModeEnum)mode, (GeneratorModeEnum)mode, Q15_MAX};
+
+    int32_t distance;  // To the boundary, negative past it
+    if (cv < g_mode_region_start[mode] + ENGINE_CROSSFADE_HALF_WIDTH && mode > 0
+            && cv >= g_mode_region_start[mode - 1]) {
+        mix.mode_b = (GeneratorModeEnum)(mode - 1);
+        distance = cv - g_mode_region_start[mode];
+    } else if (cv >= g_mode_region_start[mode + 1] - ENGINE_CROSSFADE_HALF_WIDTH && mode < NUM_MODES - 1
+            && cv < g_mode_region_start[mode + 2]) {
+        mix.mode_b = (GeneratorModeEnum)(mode + 1);
+        distance = g_mode_region_start[mode + 1] - cv;
+    } else {
+        return mix;
+    }
+    distance = distance < -ENGINE_CROSSFADE_HALF_WIDTH ? -ENGINE_CROSSFADE_HALF_WIDTH : distance;
+    const int32_t weight = ((ENGINE_CROSSFADE_HALF_WIDTH + distance) << 15) / (2 * ENGINE_CROSSFADE_HALF_WIDTH);
+    mix.mix_ratio = SatQ15(weight);
+    return mix;
+}
 
-    const GeneratorModeEnum mode = GetMode(inputs->cv_in_middle);
+/*
+ * Runs one mode over a block. The middle CV is clamped into the mode's own
+ * region, so a mode rendered from across a boundary sees the nearest edge
+ * of its range instead of running backwards.
+ */
+static void RenderModeBlock(engine_context_t* context, const GeneratorModeEnum mode, const engine_inputs_t* inputs,
+                            const engine_audio_features_t* audio, engine_output_block_t* outputs, const int n) {
+    const modeFunctor functor = g_mode_operators[mode].render;
+    if (functor == NULL) {
+        return;
+    }
+    const int16_t region_start = g_mode_region_start[mode];
+    const int16_t region_end = g_mode_region_start[mode + 1] - 1;
+
+    engine_inputs_t* mode_inputs = context->mode_inputs;
+    for (int i = 0; i < n; ++i) {
+        mode_inputs[i] = inputs[i];
+        mode_inputs[i].cv_in_middle = inputs[i].cv_in_middle < region_start ? region_start :
+                                      inputs[i].cv_in_middle > region_end ? region_end : inputs[i].cv_in_middle;
+    }
+    PROFILE_SCOPE(PROFILE_MODE_BASE + mode) {
+        functor(ModeState(context, mode), mode_inputs, audio, outputs, n);
+    }
+}
 
-    modeFunctor functor = g_mode_functors[(uint8_t)mode];
-    
-    if (functor != NULL) {
-        functor(inputs, outputs);
+// Q15 blend of two blocks, one pass per channel so each loop vectorizes.
+static void MixOutputBlockQ15(engine_output_block_t* restrict out_a, const engine_output_block_t* restrict out_b, const q15_t ratio, const int n) {
+    for (int i = 0; i < n; ++i) {
+        out_a->x[i] = LerpQ15(out_a->x[i], out_b->x[i], ratio);
+    }
+    for (int i = 0; i < n; ++i) {
+        out_a->y[i] = LerpQ15(out_a->y[i], out_b->y[i], ratio);
+    }
+    for (int i = 0; i < n; ++i) {
+        out_a->r[i] = LerpQ15(out_a->r[i], out_b->r[i], ratio);
     }
-}
\ No newline at end of file
+    for (int i = 0; i < n; ++i) {
+        out_a->g[i] = LerpQ15(out_a->g[i], out_b->g[i], ratio);
+    }
+    for (int i = 0; i < n; ++i) {
+        out_a->b[i] = LerpQ15(out_a->b[i], out_b->b[i], ratio);
+    }
+}
+
+_Static_assert(SPECTRUM_WORK_PER_POINT * (SPECTRUM_FFT_SIZE - ENGINE_MAX_BLOCK) >= SPECTRUM_JOB_WORK,
+               "A spectrum job must finish within one capture");
+
+void InitAudioAnalyzer(engine_audio_analyzer_t* analyzer) {
+    AudioBandsInit(&analyzer->bands);
+    BeatTrackerInit(&analyzer->tracker);
+    SpectrumAnalyzerInit(&analyzer->spectrum);
+    analyzer->features = (engine_audio_features_t){{0}, 0, 0, 0, {{0}}, 0};
+    analyzer->frames = 0;
+}
+
+// The spectrum job is paid for frame by frame, so it spreads over the next capture.
+void AnalyzeAudioBlock(engine_audio_analyzer_t* analyzer, const engine_inputs_t* inputs, const int n) {
+    for (int i = 0; i < n; ++i) {
+        AudioBandsPush(&analyzer->bands, inputs[i].audio_in_left, inputs[i].audio_in_right);
+        BeatTrackerPush(&analyzer->tracker, analyzer->bands.level);
+        SpectrumAnalyzerPush(&analyzer->spectrum, inputs[i].audio_in_left, inputs[i].audio_in_right);
+    }
+    SpectrumAnalyzerRun(&analyzer->spectrum, n * SPECTRUM_WORK_PER_POINT);
+    engine_audio_features_t* features = &analyzer->features;
+    for (int band = 0; band < AUDIO_BANDS; ++band) {
+        features->bands[band] = analyzer->bands.level[band];
+    }
+    features->beat_phase = analyzer->tracker.phase;
+    features->onsets = analyzer->tracker.onsets;
+    features->beats = analyzer->tracker.beats;
+    if (features->spectra != analyzer->spectrum.spectra) {
+        for (int channel = 0; channel < SPECTRUM_NUM_CHANNELS; ++channel) {
+            for (int band = 0; band < SPECTRUM_NUM_BANDS; ++band) {
+                features->spectrum[channel][band] = analyzer->spectrum.level[channel][band];
+            }
+        }
+        features->spectra = analyzer->spectrum.spectra;
+    }
+    analyzer->frames += (uint32_t)n;
+}
+
+bool RunEngineBlock(engine_context_t* context, const engine_inputs_t* inputs, const engine_audio_features_t* audio,
+                    engine_output_block_t* outputs, const int n) {
+    const int mode = UpdateModeSelector(&context->mode_selector, inputs[0].cv_in_middle);
+    const mode_mix_t mix = GetModeMix(mode, inputs[0].cv_in_middle);
+
+    if (mix.mode_a == mix.mode_b) {
+        context->output_stages = g_mode_operators[mix.mode_a].output_stages;
+        RenderModeBlock(context, mix.mode_a, inputs, audio, outputs, n);
+        return false;
+    }
+    if (!context->crossfade_enabled || mix.mix_ratio == 0) {
+        const GeneratorModeEnum alone = mix.mix_ratio == 0 ? mix.mode_b : mix.mode_a;
+        context->output_stages = g_mode_operators[alone].output_stages;
+        RenderModeBlock(context, alone, inputs, audio, outputs, n);
+        return false;
+    }
+
+    context->output_stages = g_mode_operators[mix.mode_a].output_stages || g_mode_operators[mix.mode_b].output_stages;
+    RenderModeBlock(context, mix.mode_a, inputs, audio, outputs, n);
+    RenderModeBlock(context, mix.mode_b, inputs, audio, &context->crossfade_scratch, n);
+    MixOutputBlockQ15(outputs, &context->crossfade_scratch, mix.mix_ratio, n);
+    return true;
+}
+
+// Static frames hear nothing, like their parked audio inputs.
+static const engine_audio_features_t g_frame_audio = {{0}, 0, 0, 0, {{0}}, 0};
+
+// Middle of the quantization bin, so small CV noise around a bin does not move the picture.
+static inline int16_t QuantizeFrameCv(const int16_t value) {
+    return (int16_t)(((value >> ENGINE_FRAME_CV_SHIFT) << ENGINE_FRAME_CV_SHIFT) + (1 << (ENGINE_FRAME_CV_SHIFT - 1)));
+}
+
+bool GetEngineFrame(const engine_context_t* context, const engine_inputs_t* inputs, engine_frame_t* frame) {
+    const mode_mix_t mix = GetModeMix(context->mode_selector.mode, inputs->cv_in_middle);
+    if (mix.mode_a != mix.mode_b || g_mode_operators[mix.mode_a].frame_points == NULL) {
+        return false;
+    }
+
+    // The static modes do not read the audio inputs or features, park the inputs so they do not change the key.
+    engine_inputs_t quantized = {
+        ADC_IN_MIDPOINT, ADC_IN_MIDPOINT,
+        QuantizeFrameCv(inputs->cv_in_left), QuantizeFrameCv(inputs->cv_in_middle), QuantizeFrameCv(inputs->cv_in_right)
+    };
+    const int16_t region_start = g_mode_region_start[mix.mode_a];
+    const int16_t region_end = g_mode_region_start[mix.mode_a + 1] - 1;
+    quantized.cv_in_middle = quantized.cv_in_middle < region_start ? region_start :
+                             quantized.cv_in_middle > region_end ? region_end : quantized.cv_in_middle;
+
+    const int points = g_mode_operators[mix.mode_a].frame_points(&quantized);
+    if (points <= 0 || points > ENGINE_FRAME_MAX_POINTS) {
+        return false;
+    }
+    frame->key = ((uint32_t)quantized.cv_in_left >> ENGINE_FRAME_CV_SHIFT)
+               | ((uint32_t)quantized.cv_in_middle >> ENGINE_FRAME_CV_SHIFT << 8)
+               | ((uint32_t)quantized.cv_in_right >> ENGINE_FRAME_CV_SHIFT << 16)
+               | ((uint32_t)mix.mode_a << 24);
+    frame->mode = mix.mode_a;
+    frame->points = points;
+    frame->inputs = quantized;
+    return true;
+}
+
+void RenderEngineFrame(engine_context_t* context, const engine_frame_t* frame, engine_output_block_t* outputs,
+                       const int first, const int n) {
+    engine_inputs_t* mode_inputs = context->mode_inputs;
+    for (int i = 0; i < n; ++i) {
+        mode_inputs[i] = frame->inputs;
+    }
+    const mode_operator_t* op = &g_mode_operators[frame->mode];
+    if (first == 0 && op->reset != NULL) {
+        op->reset(&context->frame_state);
+    }
+    PROFILE_SCOPE(PROFILE_MODE_BASE + frame->mode) {
+        op->render(&context->frame_state, mode_inputs, &g_frame_audio, outputs, n);
+    }
+}
+
+void RunEngine(engine_context_t* context, engine_inputs_t* inputs, const engine_audio_features_t* audio,
+               engine_outputs_t* outputs) {
+    engine_output_block_t* point = &context->point_scratch;
+    RunEngineBlock(context, inputs, audio, point, 1);
+    outputs->position_output_x = point->x[0];
+    outputs->position_output_y = point->y[0];
+    outputs->laser_pwm_output_r = point->r[0];
+    outputs->laser_pwm_output_g = point->g[0];
+    outputs->laser_pwm_output_b = point->b[0];
+}
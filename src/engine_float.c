@@ -0,0 +1,67 @@
+/*
+ * engine.c built again with ENGINE_FIXED_POINT 0, the float reference
+ * "photon -t fixed" runs the fixed-point engine against. Host only. Every
+ * external symbol gets a Float prefix so both builds link into one binary.
+ */
+#undef ENGINE_FIXED_POINT
+#define ENGINE_FIXED_POINT 0
+
+#define AnalyzeAudioBlock               FloatAnalyzeAudioBlock
+#define DenormalizeOutputs              FloatDenormalizeOutputs
+#define GetEngineFrame                  FloatGetEngineFrame
+#define GetMode                         FloatGetMode
+#define InitAudioAnalyzer               FloatInitAudioAnalyzer
+#define InitEngine                      FloatInitEngine
+#define MixEngineOutputs                FloatMixEngineOutputs
+#define MixNormedOutputs                FloatMixNormedOutputs
+#define NormalizeInputs                 FloatNormalizeInputs
+#define REGION_SIZE                     FloatREGION_SIZE
+#define RenderEngineFrame               FloatRenderEngineFrame
+#define ResetEngineMode                 FloatResetEngineMode
+#define RunEngine                       FloatRunEngine
+#define RunEngineBlock                  FloatRunEngineBlock
+#define SetEngineIldaShow               FloatSetEngineIldaShow
+#define UpdateModeSelector              FloatUpdateModeSelector
+#define frame_points_rectangle          Float_frame_points_rectangle
+#define frame_points_starry             Float_frame_points_starry
+#define g_mode_operators                Float_g_mode_operators
+#define operator_mode_audio_mono        Float_operator_mode_audio_mono
+#define operator_mode_audio_stereo      Float_operator_mode_audio_stereo
+#define operator_mode_ilda              Float_operator_mode_ilda
+#define operator_mode_messed_up_spiral  Float_operator_mode_messed_up_spiral
+#define operator_mode_rectangle         Float_operator_mode_rectangle
+#define operator_mode_spectrum          Float_operator_mode_spectrum
+#define operator_mode_spinning_coin     Float_operator_mode_spinning_coin
+#define operator_mode_spiral            Float_operator_mode_spiral
+#define operator_mode_starry            Float_operator_mode_starry
+#define reset_mode_audio_mono           Float_reset_mode_audio_mono
+#define reset_mode_ilda                 Float_reset_mode_ilda
+#define reset_mode_messed_up_spiral     Float_reset_mode_messed_up_spiral
+#define reset_mode_rectangle            Float_reset_mode_rectangle
+#define reset_mode_spectrum             Float_reset_mode_spectrum
+#define reset_mode_spinning_coin        Float_reset_mode_spinning_coin
+#define reset_mode_spiral               Float_reset_mode_spiral
+#define reset_mode_starry               Float_reset_mode_starry
+
+#include <string.h>
+
+#include "engine.c"
+
+#include "engine_float.h"
+
+_Static_assert(sizeof(engine_amp_t) == sizeof(q30_t) && _Alignof(engine_amp_t) == _Alignof(q30_t),
+               "The float build must lay out engine_context_t like the fixed-point one");
+
+// The bits of a fixed-point build's Q30 envelope, as float.
+static void AmpFromQ30(engine_amp_t* amplitude) {
+    q30_t value;
+    memcpy(&value, amplitude, sizeof(value));
+    *amplitude = (float)value / (float)Q30_ONE;
+}
+
+void FloatCopyEngineContext(engine_context_t* reference, const engine_context_t* fixed) {
+    *reference = *fixed;
+    AmpFromQ30(&reference->spinning_coin.amplitude);
+    AmpFromQ30(&reference->spiral.amplitude);
+    AmpFromQ30(&reference->messed_up_spiral.amplitude);
+}
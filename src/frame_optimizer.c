@@ -0,0 +1,214 @@
+#include <stdlib.h>
+
+#include "frame_optimizer.h"
+
+static inline bool IsLit(const frame_points_t* points, const int i) {
+    return (points->r[i] | points->g[i] | points->b[i]) != 0;
+}
+
+// Point index of the k-th point of a segment in drawing order.
+static inline int SegmentPoint(const frame_optimizer_t* opt, const int segment, const int k) {
+    const int offset = opt->reversed[segment] ? opt->length[segment] - 1 - k : k;
+    return (opt->start[segment] + offset) % opt->points->n;
+}
+
+static inline int Entry(const frame_optimizer_t* opt, const int segment) {
+    return SegmentPoint(opt, segment, 0);
+}
+
+static inline int Exit(const frame_optimizer_t* opt, const int segment) {
+    return SegmentPoint(opt, segment, opt->length[segment] - 1);
+}
+
+static inline int32_t Distance(const frame_points_t* points, const int a, const int b) {
+    const int32_t dx = abs(points->x[a] - points->x[b]);
+    const int32_t dy = abs(points->y[a] - points->y[b]);
+    return dx > dy ? dx : dy;
+}
+
+static uint32_t TourTravel(const frame_optimizer_t* opt) {
+    uint32_t travel = 0;
+    for (int k = 0; k < opt->num_segments; ++k) {
+        const int next = opt->order[(k + 1) % opt->num_segments];
+        travel += (uint32_t)Distance(opt->points, Exit(opt, opt->order[k]), Entry(opt, next));
+    }
+    return travel;
+}
+
+void FrameOptimizerStart(frame_optimizer_t* opt, const frame_points_t* points) {
+    *opt = (frame_optimizer_t){0};
+    opt->points = points;
+    opt->phase = FRAME_OPT_DONE;
+
+    int first_dark = -1;
+    for (int i = 0; i < points->n && first_dark < 0; ++i) {
+        first_dark = IsLit(points, i) ? -1 : i;
+    }
+    if (first_dark < 0) {
+        return;
+    }
+
+    // From a dark point on, so no segment is split across the end of the frame.
+    bool in_segment = false;
+    for (int k = 1; k <= points->n; ++k) {
+        const int i = (first_dark + k) % points->n;
+        if (!IsLit(points, i)) {
+            in_segment = false;
+            continue;
+        }
+        if (!in_segment) {
+            if (opt->num_segments == FRAME_OPT_MAX_SEGMENTS) {
+                opt->num_segments = 0;
+                return;
+            }
+            opt->start[opt->num_segments] = (int16_t)i;
+            opt->length[opt->num_segments] = 0;
+            opt->order[opt->num_segments] = (uint8_t)opt->num_segments;
+            ++opt->num_segments;
+            in_segment = true;
+        }
+        ++opt->length[opt->num_segments - 1];
+    }
+
+    opt->travel_before = TourTravel(opt);
+    opt->travel_nearest = opt->travel_before;
+    opt->travel_after = opt->travel_before;
+    if (opt->num_segments > 1) {
+        opt->visited[0] = true;
+        opt->row = 1;
+        opt->phase = FRAME_OPT_NEAREST;
+    }
+}
+
+// Picks the closest unvisited segment, either way round, for tour position row.
+static void NearestRow(frame_optimizer_t* opt) {
+    const int from = Exit(opt, opt->order[opt->row - 1]);
+    int32_t best_distance = INT32_MAX;
+    int best = -1;
+    bool best_reversed = false;
+    for (int s = 0; s < opt->num_segments; ++s) {
+        if (opt->visited[s]) {
+            continue;
+        }
+        const int first = opt->start[s];
+        const int last = (opt->start[s] + opt->length[s] - 1) % opt->points->n;
+        const int32_t forward = Distance(opt->points, from, first);
+        const int32_t backward = Distance(opt->points, from, last);
+        if (forward < best_distance) {
+            best_distance = forward;
+            best = s;
+            best_reversed = false;
+        }
+        if (backward < best_distance) {
+            best_distance = backward;
+            best = s;
+            best_reversed = true;
+        }
+    }
+    opt->visited[best] = true;
+    opt->reversed[best] = best_reversed;
+    opt->order[opt->row] = (uint8_t)best;
+    opt->evaluations += (uint32_t)opt->num_segments;
+}
+
+/*
+ * Gain of reversing tour positions i..j, which also turns each of those
+ * segments round: prev -> [i .. j] -> next becomes prev -> [j' .. i'] -> next.
+ */
+static int32_t TwoOptGain(const frame_optimizer_t* opt, const int i, const int j) {
+    const int prev = Exit(opt, opt->order[i - 1]);
+    const int next = Entry(opt, opt->order[(j + 1) % opt->num_segments]);
+    const int head = Entry(opt, opt->order[i]);
+    const int tail = Exit(opt, opt->order[j]);
+    const int32_t before = Distance(opt->points, prev, head) + Distance(opt->points, tail, next);
+    const int32_t after = Distance(opt->points, prev, tail) + Distance(opt->points, head, next);
+    return before - after;
+}
+
+static void ReverseTour(frame_optimizer_t* opt, int i, int j) {
+    for (int k = i; k <= j; ++k) {
+        opt->reversed[opt->order[k]] = !opt->reversed[opt->order[k]];
+    }
+    for (; i < j; ++i, --j) {
+        const uint8_t swap = opt->order[i];
+        opt->order[i] = opt->order[j];
+        opt->order[j] = swap;
+    }
+}
+
+bool FrameOptimizerStep(frame_optimizer_t* opt, const int budget) {
+    int spent = 0;
+    while (opt->phase == FRAME_OPT_NEAREST && spent < budget) {
+        NearestRow(opt);
+        spent += opt->num_segments;
+        if (++opt->row == opt->num_segments) {
+            opt->travel_nearest = TourTravel(opt);
+            opt->travel_after = opt->travel_nearest;
+            opt->phase = FRAME_OPT_TWO_OPT;
+            opt->i = 1;
+            opt->j = 1;
+            opt->improved = false;
+        }
+    }
+
+    // Position 0 stays put, every other reversal of the loop is covered by one i..j.
+    for (; opt->phase == FRAME_OPT_TWO_OPT && spent < budget; ++spent) {
+        const int32_t gain = TwoOptGain(opt, opt->i, opt->j);
+        if (gain > 0) {
+            ReverseTour(opt, opt->i, opt->j);
+            opt->travel_after -= (uint32_t)gain;
+            opt->improved = true;
+        }
+        ++opt->evaluations;
+        if (++opt->j == opt->num_segments) {
+            ++opt->i;
+            opt->j = opt->i;
+        }
+        if (opt->i == opt->num_segments) {
+            ++opt->sweeps;
+            if (!opt->improved || opt->sweeps == FRAME_OPT_MAX_SWEEPS) {
+                opt->phase = FRAME_OPT_DONE;
+            }
+            opt->i = 1;
+            opt->j = 1;
+            opt->improved = false;
+        }
+    }
+    return opt->phase == FRAME_OPT_DONE;
+}
+
+static inline void CopyPoint(engine_output_block_t* out, const int o, const frame_points_t* points, const int i,
+                             const bool lit) {
+    out->x[o] = points->x[i];
+    out->y[o] = points->y[i];
+    out->r[o] = lit ? points->r[i] : 0;
+    out->g[o] = lit ? points->g[i] : 0;
+    out->b[o] = lit ? points->b[i] : 0;
+}
+
+int ReadOptimizedFrame(const frame_optimizer_t* opt, frame_cursor_t* cursor, engine_output_block_t* out, const int n) {
+    const frame_points_t* points = opt->points;
+    int count = 0;
+
+    if (opt->num_segments == 0) {
+        for (; count < n && cursor->offset < points->n; ++count, ++cursor->offset) {
+            CopyPoint(out, count, points, cursor->offset, true);
+        }
+        return count;
+    }
+
+    // Offset 0 is the dark lead-in point, the segment's points follow it.
+    while (count < n && cursor->segment < opt->num_segments) {
+        const int segment = opt->order[cursor->segment];
+        if (cursor->offset == 0) {
+            CopyPoint(out, count++, points, Entry(opt, segment), false);
+        } else {
+            CopyPoint(out, count++, points, SegmentPoint(opt, segment, cursor->offset - 1), true);
+        }
+        if (++cursor->offset > opt->length[segment]) {
+            cursor->offset = 0;
+            ++cursor->segment;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,76 @@
+#include <stdlib.h>
+
+#include "galvo_slew.h"
+
+#define SLEW_FRACTION_BITS 16
+
+static inline int16_t ClampPosition(const int16_t value) {
+    return value < 0 ? 0 : value > LASER_POS_MAX ? LASER_POS_MAX : value;
+}
+
+static inline void EmitPoint(engine_output_block_t* out, const int i, const int16_t x, const int16_t y,
+                             const int16_t r, const int16_t g, const int16_t b) {
+    out->x[i] = x;
+    out->y[i] = y;
+    out->r[i] = r;
+    out->g[i] = g;
+    out->b[i] = b;
+}
+
+void GalvoSlewInit(galvo_slew_t* slew, const galvo_slew_config_t* config) {
+    *slew = (galvo_slew_t){0};
+    slew->config = *config;
+    slew->config.max_delta = config->max_delta < GALVO_SLEW_MIN_DELTA ? GALVO_SLEW_MIN_DELTA :
+                             config->max_delta > LASER_POS_MAX ? LASER_POS_MAX : config->max_delta;
+}
+
+int GalvoSlewBlock(galvo_slew_t* slew, const engine_output_block_t* in, int first, const int n,
+                   engine_output_block_t* out, int* out_count, const int out_size) {
+    int count = *out_count;
+    int i = first;
+
+    while (i < n && count < out_size) {
+        const int16_t x = ClampPosition(in->x[i]);
+        const int16_t y = ClampPosition(in->y[i]);
+
+        if (!slew->config.enabled || !slew->started) {
+            slew->started = true;
+        } else if (!slew->moving) {
+            // New move: work out how many points it needs, once.
+            const int dx = x - slew->x;
+            const int dy = y - slew->y;
+            const int distance = abs(dx) > abs(dy) ? abs(dx) : abs(dy);
+            const int steps = (distance + slew->config.max_delta - 1) / slew->config.max_delta;
+            if (steps > 1) {
+                slew->step_x = dx * (1 << SLEW_FRACTION_BITS) / steps;
+                slew->step_y = dy * (1 << SLEW_FRACTION_BITS) / steps;
+                slew->move_x = slew->x << SLEW_FRACTION_BITS;
+                slew->move_y = slew->y << SLEW_FRACTION_BITS;
+                slew->steps_left = (int16_t)(steps - 1);
+                slew->moving = true;
+            }
+        }
+
+        if (slew->steps_left > 0) {
+            slew->move_x += slew->step_x;
+            slew->move_y += slew->step_y;
+            const bool dark = slew->config.blank_moves;
+            EmitPoint(out, count++, (int16_t)(slew->move_x >> SLEW_FRACTION_BITS),
+                      (int16_t)(slew->move_y >> SLEW_FRACTION_BITS),
+                      dark ? 0 : in->r[i], dark ? 0 : in->g[i], dark ? 0 : in->b[i]);
+            --slew->steps_left;
+            continue;
+        }
+
+        EmitPoint(out, count++, x, y, in->r[i], in->g[i], in->b[i]);
+        slew->moving = false;
+        slew->x = x;
+        slew->y = y;
+        ++i;
+    }
+
+    slew->points_in += (uint32_t)(i - first);
+    slew->points_out += (uint32_t)(count - *out_count);
+    *out_count = count;
+    return i - first;
+}
@@ -0,0 +1,1086 @@
+/*
+ * Host micro-benchmarks. Each one prints its own throughput and expansion
+ * figures; results feed the per-mode point-rate budget. The pass/fail
+ * checks are in host_test.c.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "audio_bands.h"
+#include "audio_decimator.h"
+#include "beat_tracker.h"
+#include "blank_dwell.h"
+#include "platform.h"
+#include "compact_show.h"
+#include "compact_show_encode.h"
+#include "engine.h"
+#include "frame_optimizer.h"
+#include "galvo_slew.h"
+#include "host_bench.h"
+#include "ilda.h"
+#include "shape_tables.h"
+#include "spectrum.h"
+#include "trig_lut.h"
+
+#define BENCH_TRIG_CALLS  20000000u
+#define BENCH_BLOCKS_PER_CV 64
+#define BENCH_ENGINE_BLOCKS 100000u
+
+typedef void (*benchFunctor)(void);
+
+typedef struct hostbenchmark {
+    const char* name;
+    const char* description;
+    benchFunctor run;
+} host_benchmark_t;
+
+// Sink so the compiler cannot drop the work being timed.
+static volatile int64_t g_bench_sink;
+
+// Audio features for the runs that leave the audio analysis out.
+static const engine_audio_features_t g_bench_silence = {{0}, 0, 0, 0, {{0}}, 0};
+
+static double NowSeconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+static void PrintRate(const char* label, const uint64_t calls, const double seconds) {
+    printf("  %-28s %8.2f Mcalls/s  %6.2f ns/call\n", label,
+           (double)calls / seconds * 1e-6, seconds / (double)calls * 1e9);
+}
+
+static void BenchTrig(void) {
+    const phase_t step = 0x9E3779B9u;  // Golden ratio step, visits phases evenly
+
+    double start = NowSeconds();
+    phase_t phase = 0;
+    int64_t acc = 0;
+    for (uint32_t i = 0; i < BENCH_TRIG_CALLS; ++i) {
+        acc += SinQ15(phase);
+        phase += step;
+    }
+    g_bench_sink = acc;
+    PrintRate("SinQ15 (LUT)", BENCH_TRIG_CALLS, NowSeconds() - start);
+
+    start = NowSeconds();
+    phase = 0;
+    acc = 0;
+    for (uint32_t i = 0; i < BENCH_TRIG_CALLS; ++i) {
+        acc += (int64_t)(sin((double)phase * (BENCH_TWO_PI / 4294967296.0)) * Q15_ONE);
+        phase += step;
+    }
+    g_bench_sink = acc;
+    PrintRate("sin (libm, double)", BENCH_TRIG_CALLS, NowSeconds() - start);
+
+    start = NowSeconds();
+    phase = 0;
+    acc = 0;
+    for (uint32_t i = 0; i < BENCH_TRIG_CALLS; ++i) {
+        acc += (int64_t)(sinf((float)phase * (float)(BENCH_TWO_PI / 4294967296.0)) * Q15_ONE);
+        phase += step;
+    }
+    g_bench_sink = acc;
+    PrintRate("sinf (libm, float)", BENCH_TRIG_CALLS, NowSeconds() - start);
+}
+
+// Deterministic xorshift so runs are comparable.
+uint32_t BenchRandom(void) {
+    static uint32_t state = 0x12345678u;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+int16_t BenchRandomAdc(void) {
+    return (int16_t)(BenchRandom() % (ADC_IN_MAX + 1));
+}
+
+/*
+ * The shape tables against the per-point trig they replace: CircleQ15()
+ * against SinQ15() and CosQ15(), and the starry table against the phase
+ * steps MODE_STARRY used to take.
+ */
+static void BenchShapeTables(void) {
+    const phase_t step = 0x9E3779B9u;
+
+    double start = NowSeconds();
+    phase_t phase = 0;
+    int64_t acc = 0;
+    for (uint32_t i = 0; i < BENCH_TRIG_CALLS; ++i) {
+        acc += CosQ15(phase) + SinQ15(phase);
+        phase += step;
+    }
+    g_bench_sink = acc;
+    PrintRate("CosQ15 + SinQ15", BENCH_TRIG_CALLS, NowSeconds() - start);
+
+    start = NowSeconds();
+    phase = 0;
+    acc = 0;
+    for (uint32_t i = 0; i < BENCH_TRIG_CALLS; ++i) {
+        const shape_point_t point = CircleQ15(phase);
+        acc += point.x + point.y;
+        phase += step;
+    }
+    g_bench_sink = acc;
+    PrintRate("CircleQ15", BENCH_TRIG_CALLS, NowSeconds() - start);
+
+    // Steps through the table the way the starry mode does, five points a turn.
+    start = NowSeconds();
+    phase = 0;
+    acc = 0;
+    for (uint32_t i = 0; i < BENCH_TRIG_CALLS; ++i) {
+        acc += CosQ15(phase) + SinQ15(phase);
+        phase += PHASE_HALF_TURN / 5u * 2u;
+    }
+    g_bench_sink = acc;
+    PrintRate("starry: CosQ15 + SinQ15", BENCH_TRIG_CALLS, NowSeconds() - start);
+
+    start = NowSeconds();
+    int32_t point = 0;
+    acc = 0;
+    for (uint32_t i = 0; i < BENCH_TRIG_CALLS; ++i) {
+        acc += g_shape_circle_starry[point].x + g_shape_circle_starry[point].y;
+        point += SHAPE_STARRY_POINTS / 5;
+        point -= point >= SHAPE_STARRY_POINTS ? SHAPE_STARRY_POINTS : 0;
+    }
+    g_bench_sink = acc;
+    PrintRate("starry: table", BENCH_TRIG_CALLS, NowSeconds() - start);
+    printf("  flash: %zu bytes circle, %zu bytes starry\n", sizeof(g_shape_circle), sizeof(g_shape_circle_starry));
+}
+
+#define BENCH_DECIMATOR_FRAMES      4000
+
+// Cost of the audio decimator per output sample against the frame period.
+static void BenchAudioDecimator(void) {
+    static uint16_t scans[BENCH_DECIMATOR_FRAMES * AUDIO_OVERSAMPLE * 2];
+    for (size_t i = 0; i < sizeof(scans) / sizeof(scans[0]); ++i) {
+        scans[i] = (uint16_t)BenchRandomAdc();
+    }
+    audio_decimator_t left;
+    audio_decimator_t right;
+    AudioDecimatorInit(&left);
+    AudioDecimatorInit(&right);
+    int64_t acc = 0;
+    const uint32_t passes = 250;
+    const double start = NowSeconds();
+    for (uint32_t pass = 0; pass < passes; ++pass) {
+        for (int frame = 0; frame < BENCH_DECIMATOR_FRAMES; ++frame) {
+            const uint16_t* scan = &scans[frame * AUDIO_OVERSAMPLE * 2];
+            acc += AudioDecimate(&left, &scan[0], 2) + AudioDecimate(&right, &scan[1], 2);
+        }
+    }
+    const double seconds = NowSeconds() - start;
+    g_bench_sink = acc;
+    const uint64_t calls = (uint64_t)passes * BENCH_DECIMATOR_FRAMES * 2;
+    PrintRate("AudioDecimate", calls, seconds);
+    printf("  both channels: %.2f%% of a frame at %d Hz\n",
+           100.0 * 2.0 * seconds / (double)calls * ADC_SAMPLE_RATE_DEFAULT_HZ, ADC_SAMPLE_RATE_DEFAULT_HZ);
+    printf("  per output sample: %d CIC input adds, %d comb subtracts, %d FIR multiplies\n",
+           AUDIO_OVERSAMPLE * AUDIO_CIC_ORDER, AUDIO_FIR_DECIMATION * AUDIO_CIC_ORDER, AUDIO_FIR_HALF_TAPS);
+}
+
+#define BENCH_BANDS_COST_SAMPLES 4000000u
+
+/*
+ * Cost of the band bank per sample, and how many band readouts land on one
+ * sample.
+ */
+static void BenchAudioBands(void) {
+    static audio_bands_t bands;
+    AudioBandsInit(&bands);
+    int readouts = 0;
+    int worst_readouts = 0;
+    int64_t acc = 0;
+    const double start = NowSeconds();
+    for (uint32_t n = 0; n < BENCH_BANDS_COST_SAMPLES; ++n) {
+        AudioBandsPush(&bands, BenchRandomAdc(), BenchRandomAdc());
+        int sample_readouts = 0;
+        for (int band = 0; band < AUDIO_BANDS; ++band) {
+            sample_readouts += bands.count[band] == 0 ? 1 : 0;
+        }
+        readouts += sample_readouts;
+        worst_readouts = sample_readouts > worst_readouts ? sample_readouts : worst_readouts;
+        acc += bands.level[0];
+    }
+    const double seconds = NowSeconds() - start;
+    g_bench_sink = acc;
+    PrintRate("AudioBandsPush", BENCH_BANDS_COST_SAMPLES, seconds);
+    printf("  %.2f%% of a frame at %d Hz, %d multiply-accumulates a sample, readouts %.3f a sample, at most %d\n",
+           100.0 * seconds / BENCH_BANDS_COST_SAMPLES * ADC_SAMPLE_RATE_DEFAULT_HZ, ADC_SAMPLE_RATE_DEFAULT_HZ,
+           AUDIO_BANDS, (double)readouts / BENCH_BANDS_COST_SAMPLES, worst_readouts);
+}
+
+#define BENCH_SPECTRUM_SPECTRA  20000
+
+/*
+ * Cost of the spectrum analyzer fed a block at a time, the way
+ * AnalyzeAudioBlock() runs it.
+ */
+static void BenchSpectrum(void) {
+    static int16_t samples[2 * SPECTRUM_FFT_SIZE];
+    for (int i = 0; i < 2 * SPECTRUM_FFT_SIZE; ++i) {
+        samples[i] = BenchRandomAdc();
+    }
+    static spectrum_analyzer_t analyzer;
+    SpectrumAnalyzerInit(&analyzer);
+    const double start = NowSeconds();
+    for (uint32_t spectrum = 0; spectrum < BENCH_SPECTRUM_SPECTRA; ++spectrum) {
+        for (int first = 0; first < SPECTRUM_FFT_SIZE; first += ENGINE_MAX_BLOCK) {
+            for (int i = first; i < first + ENGINE_MAX_BLOCK; ++i) {
+                SpectrumAnalyzerPush(&analyzer, samples[2 * i], samples[2 * i + 1]);
+            }
+            SpectrumAnalyzerRun(&analyzer, ENGINE_MAX_BLOCK * SPECTRUM_WORK_PER_POINT);
+        }
+    }
+    const double seconds = NowSeconds() - start;
+    g_bench_sink = analyzer.level[0][0];
+    PrintRate("spectrum per point", (uint64_t)BENCH_SPECTRUM_SPECTRA * SPECTRUM_FFT_SIZE, seconds);
+    printf("  per spectrum: %.2f us, %d work units, %.2f%% of a frame at %d Hz\n",
+           seconds / BENCH_SPECTRUM_SPECTRA * 1e6, SPECTRUM_JOB_WORK,
+           100.0 * seconds / BENCH_SPECTRUM_SPECTRA / SPECTRUM_FFT_SIZE * ADC_SAMPLE_RATE_DEFAULT_HZ,
+           ADC_SAMPLE_RATE_DEFAULT_HZ);
+}
+
+// Reads a whole file into a malloc'd buffer, NULL if it cannot be read or is empty.
+static uint8_t* ReadHostFile(const char* path, size_t* size) {
+    FILE* input = fopen(path, "rb");
+    if (input == NULL) {
+        perror(path);
+        return NULL;
+    }
+    fseek(input, 0, SEEK_END);
+    const long length = ftell(input);
+    fseek(input, 0, SEEK_SET);
+    uint8_t* data = malloc(length > 0 ? (size_t)length : 1);
+    if (data != NULL && (length <= 0 || fread(data, 1, (size_t)length, input) != (size_t)length)) {
+        fprintf(stderr, "%s: cannot read\n", path);
+        free(data);
+        data = NULL;
+    }
+    fclose(input);
+    *size = length > 0 ? (size_t)length : 0;
+    return data;
+}
+
+static uint32_t WavLe32(const uint8_t* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static int16_t WavLe16(const uint8_t* p) {
+    return (int16_t)((uint16_t)p[0] | ((uint16_t)p[1] << 8));
+}
+
+void FreeBenchAudio(bench_audio_t* audio) {
+    free(audio->left);
+    free(audio->right);
+    *audio = (bench_audio_t){0};
+}
+
+/*
+ * Reads a 16-bit PCM WAV file, mono or stereo, into ADC counts at the
+ * engine's audio rate. Mono goes to both channels. The resampling is
+ * linear, with no filter in front, so content above 10kHz aliases.
+ */
+bool ReadWavFile(const char* path, bench_audio_t* audio) {
+    size_t size;
+    uint8_t* data = ReadHostFile(path, &size);
+    if (data == NULL) {
+        return false;
+    }
+
+    uint16_t format = 0;
+    uint16_t channels = 0;
+    uint16_t bits = 0;
+    uint32_t rate = 0;
+    const uint8_t* samples = NULL;
+    size_t sample_bytes = 0;
+    bool ok = size >= 12 && memcmp(data, "RIFF", 4) == 0 && memcmp(data + 8, "WAVE", 4) == 0;
+    for (size_t chunk = 12; ok && chunk + 8 <= size;) {
+        const size_t body = chunk + 8;
+        const size_t length = WavLe32(data + chunk + 4);
+        const size_t available = length < size - body ? length : size - body;
+        if (memcmp(data + chunk, "fmt ", 4) == 0 && available >= 16) {
+            format = (uint16_t)WavLe16(data + body);
+            channels = (uint16_t)WavLe16(data + body + 2);
+            rate = WavLe32(data + body + 4);
+            bits = (uint16_t)WavLe16(data + body + 14);
+        } else if (memcmp(data + chunk, "data", 4) == 0) {
+            samples = data + body;
+            sample_bytes = available;
+        }
+        chunk = body + length + (length & 1);
+    }
+    if (!ok || samples == NULL || format != 1 || bits != 16 || (channels != 1 && channels != 2) || rate == 0) {
+        fprintf(stderr, "%s: not a 16-bit PCM WAV file, mono or stereo\n", path);
+        free(data);
+        return false;
+    }
+
+    const size_t in_frames = sample_bytes / (2u * channels);
+    audio->frames = (size_t)((double)in_frames * ADC_SAMPLE_RATE_DEFAULT_HZ / rate);
+    audio->left = malloc((audio->frames > 0 ? audio->frames : 1) * sizeof(int16_t));
+    audio->right = malloc((audio->frames > 0 ? audio->frames : 1) * sizeof(int16_t));
+    if (audio->left == NULL || audio->right == NULL) {
+        FreeBenchAudio(audio);
+        free(data);
+        return false;
+    }
+    for (size_t n = 0; n < audio->frames; ++n) {
+        const double position = (double)n * rate / ADC_SAMPLE_RATE_DEFAULT_HZ;
+        const size_t i = (size_t)position;
+        const size_t next = i + 1 < in_frames ? i + 1 : i;
+        const double fraction = position - (double)i;
+        for (int channel = 0; channel < 2; ++channel) {
+            const int source = channels == 2 ? channel : 0;
+            const double a = WavLe16(samples + 2 * (i * channels + (size_t)source));
+            const double b = WavLe16(samples + 2 * (next * channels + (size_t)source));
+            const int16_t adc = (int16_t)lround(ADC_IN_MIDPOINT + (a + (b - a) * fraction) * ADC_IN_MIDPOINT / 32768.0);
+            (channel == 0 ? audio->left : audio->right)[n] = adc;
+        }
+    }
+    free(data);
+    return true;
+}
+
+void FreeBenchBeats(bench_beats_t* beats) {
+    free(beats->onsets);
+    free(beats->beats);
+    *beats = (bench_beats_t){0};
+}
+
+/*
+ * Runs audio through RunEngineBlock() in the spectrum mode, the way the
+ * platform would, and notes the blocks the engine counted onsets and beats
+ * in and how often the mode stepped its colours.
+ */
+bool TrackBeats(const bench_audio_t* audio, bench_beats_t* beats) {
+    static engine_context_t context;
+    static engine_output_block_t outputs;
+    static engine_audio_analyzer_t analyzer;
+    engine_inputs_t inputs[ENGINE_MAX_BLOCK];
+    InitEngine(&context);
+    InitAudioAnalyzer(&analyzer);
+
+    // Beats cannot come faster than one a hop, nor onsets, see BEAT_REFRACTORY_HOPS.
+    const size_t capacity = audio->frames / BEAT_HOP + 1;
+    *beats = (bench_beats_t){0};
+    beats->onsets = malloc(capacity * sizeof(uint32_t));
+    beats->beats = malloc(capacity * sizeof(uint32_t));
+    if (beats->onsets == NULL || beats->beats == NULL) {
+        FreeBenchBeats(beats);
+        return false;
+    }
+
+    const int16_t region = ADC_IN_MAX / ENGINE_NUM_MODES + 1;
+    const int16_t spectrum_cv = (int16_t)((ENGINE_NUM_MODES - 1) * region + region / 2);
+    for (size_t frame = 0; frame < audio->frames; frame += ENGINE_MAX_BLOCK) {
+        const int n = audio->frames - frame < ENGINE_MAX_BLOCK ? (int)(audio->frames - frame) : ENGINE_MAX_BLOCK;
+        for (int i = 0; i < n; ++i) {
+            inputs[i] = (engine_inputs_t){
+                audio->left[frame + (size_t)i], audio->right[frame + (size_t)i],
+                ADC_IN_MAX, spectrum_cv, ADC_IN_MIDPOINT
+            };
+        }
+        const int16_t color = context.spectrum.beat_color;
+        const engine_audio_features_t last = analyzer.features;
+        AnalyzeAudioBlock(&analyzer, inputs, n);
+        RunEngineBlock(&context, inputs, &analyzer.features, &outputs, n);
+        beats->color_steps += context.spectrum.beat_color != color ? 1u : 0u;
+        // At most one of each a block, noted on its last frame.
+        const uint32_t end = (uint32_t)(frame + (size_t)n - 1);
+        if (analyzer.features.onsets != last.onsets && beats->num_onsets < capacity) {
+            beats->onsets[beats->num_onsets++] = end;
+        }
+        if (analyzer.features.beats != last.beats && beats->num_beats < capacity) {
+            beats->beats[beats->num_beats++] = end;
+        }
+    }
+    beats->bpm = 60.0 * ADC_SAMPLE_RATE_DEFAULT_HZ * 256.0 / BeatTrackerPeriodQ8(&analyzer.tracker);
+    return true;
+}
+
+#define BENCH_BEAT_COST_FRAMES  4000000u
+
+// Cost of the beat tracker per frame.
+static void BenchBeatTracker(void) {
+    // Band levels as the bank would move them, a new set every 32 frames.
+    static beat_tracker_t tracker;
+    BeatTrackerInit(&tracker);
+    q15_t levels[AUDIO_BANDS] = {0};
+    int64_t acc = 0;
+    const double start = NowSeconds();
+    for (uint32_t n = 0; n < BENCH_BEAT_COST_FRAMES; ++n) {
+        if ((n & 31u) == 0) {
+            levels[BenchRandom() % AUDIO_BANDS] = (q15_t)(BenchRandom() & 0x7fffu);
+        }
+        BeatTrackerPush(&tracker, levels);
+        acc += tracker.phase;
+    }
+    const double seconds = NowSeconds() - start;
+    g_bench_sink = acc;
+    PrintRate("BeatTrackerPush", BENCH_BEAT_COST_FRAMES, seconds);
+    printf("  %.2f%% of a frame at %d Hz, %u onsets\n",
+           100.0 * seconds / BENCH_BEAT_COST_FRAMES * ADC_SAMPLE_RATE_DEFAULT_HZ, ADC_SAMPLE_RATE_DEFAULT_HZ,
+           tracker.onsets);
+}
+
+// Cost of one selector update, the CV swept over the whole range.
+static void BenchModeSelector(void) {
+    mode_selector_t selector = {
+        .config = {ENGINE_MODE_HYSTERESIS_DEFAULT, ENGINE_MODE_SETTLE_DEFAULT, ENGINE_MODE_DEADBAND_DEFAULT},
+    };
+    UpdateModeSelector(&selector, 0);
+    int64_t acc = 0;
+    const double start = NowSeconds();
+    for (uint32_t i = 0; i < BENCH_TRIG_CALLS; ++i) {
+        acc += UpdateModeSelector(&selector, (int16_t)((i >> 4) & ADC_IN_MAX));
+    }
+    g_bench_sink = acc;
+    PrintRate("UpdateModeSelector", BENCH_TRIG_CALLS, NowSeconds() - start);
+}
+
+/*
+ * Sweeps the mode CV over its whole range and times every block, split by
+ * whether RunEngineBlock() crossfaded it. The ratio is what the dual render
+ * costs over a single mode.
+ */
+static void BenchCrossfade(void) {
+    static engine_context_t context;
+    engine_inputs_t inputs[ENGINE_MAX_BLOCK];
+    static engine_output_block_t outputs;
+    InitEngine(&context);
+
+    double seconds[2] = {0.0, 0.0};
+    double worst[2] = {0.0, 0.0};
+    uint64_t points[2] = {0, 0};
+    int64_t acc = 0;
+    for (int16_t cv = 0; cv <= ADC_IN_MAX; ++cv) {
+        for (int block = 0; block < BENCH_BLOCKS_PER_CV; ++block) {
+            for (int i = 0; i < ENGINE_MAX_BLOCK; ++i) {
+                inputs[i] = (engine_inputs_t){
+                    BenchRandomAdc(), BenchRandomAdc(), ADC_IN_MIDPOINT, cv, ADC_IN_MIDPOINT
+                };
+            }
+            const double start = NowSeconds();
+            const int mixed = RunEngineBlock(&context, inputs, &g_bench_silence, &outputs, ENGINE_MAX_BLOCK)
+                              ? 1 : 0;
+            const double elapsed = NowSeconds() - start;
+            seconds[mixed] += elapsed;
+            worst[mixed] = elapsed > worst[mixed] ? elapsed : worst[mixed];
+            points[mixed] += ENGINE_MAX_BLOCK;
+            acc += outputs.x[0];
+        }
+    }
+    g_bench_sink = acc;
+
+    const double single_ns = seconds[0] / (double)points[0] * 1e9;
+    const double mixed_ns = points[1] > 0 ? seconds[1] / (double)points[1] * 1e9 : 0.0;
+    printf("  single mode: %6.2f ns/point  worst block %7.0f ns  (%llu points)\n",
+           single_ns, worst[0] * 1e9, (unsigned long long)points[0]);
+    printf("  crossfade:   %6.2f ns/point  worst block %7.0f ns  (%llu points)\n",
+           mixed_ns, worst[1] * 1e9, (unsigned long long)points[1]);
+    printf("  dual render cost: %.2fx a single mode\n", single_ns > 0.0 ? mixed_ns / single_ns : 0.0);
+}
+
+/*
+ * Points per second through RunEngine() one point at a time against
+ * RunEngineBlock(), at the centre of each mode region so no block
+ * crossfades. Both start from a fresh context and see the same inputs.
+ */
+static void BenchEngineBlock(void) {
+    static engine_context_t context;
+    static engine_inputs_t inputs[ENGINE_MAX_BLOCK];
+    static engine_output_block_t block;
+    engine_outputs_t point;
+
+    const int16_t region = ADC_IN_MAX / ENGINE_NUM_MODES + 1;
+    for (int mode = 0; mode < ENGINE_NUM_MODES; ++mode) {
+        const int16_t cv = (int16_t)(mode * region + region / 2);
+        for (int i = 0; i < ENGINE_MAX_BLOCK; ++i) {
+            inputs[i] = (engine_inputs_t){
+                BenchRandomAdc(), BenchRandomAdc(), ADC_IN_MIDPOINT, cv, ADC_IN_MAX * 3 / 4
+            };
+        }
+
+        InitEngine(&context);
+        int64_t acc = 0;
+        double start = NowSeconds();
+        for (uint32_t n = 0; n < BENCH_ENGINE_BLOCKS; ++n) {
+            for (int i = 0; i < ENGINE_MAX_BLOCK; ++i) {
+                RunEngine(&context, &inputs[i], &g_bench_silence, &point);
+                acc += point.position_output_x;
+            }
+        }
+        const double per_point = NowSeconds() - start;
+
+        InitEngine(&context);
+        start = NowSeconds();
+        for (uint32_t n = 0; n < BENCH_ENGINE_BLOCKS; ++n) {
+            RunEngineBlock(&context, inputs, &g_bench_silence, &block, ENGINE_MAX_BLOCK);
+            acc += block.x[0];
+        }
+        const double per_block = NowSeconds() - start;
+        g_bench_sink = acc;
+
+        const double points = (double)BENCH_ENGINE_BLOCKS * ENGINE_MAX_BLOCK;
+        printf("  mode %d: RunEngine %7.2f Mpoints/s  RunEngineBlock %7.2f Mpoints/s  %5.2fx\n", mode,
+               points / per_point * 1e-6, points / per_block * 1e-6, per_point / per_block);
+    }
+}
+
+/*
+ * Every mode through the slew limiter at a few step sizes. The expansion is
+ * output points per rendered point, i.e. how much the point rate has to rise
+ * to keep the same picture rate.
+ */
+static void BenchGalvoSlew(void) {
+    static const int16_t deltas[] = {GALVO_SLEW_MIN_DELTA, 512, 1024, 2048};
+    static engine_context_t context;
+    static engine_inputs_t inputs[ENGINE_MAX_BLOCK];
+    static engine_output_block_t block;
+    static engine_output_block_t out;
+
+    printf("  %-6s", "delta");
+    for (int mode = 0; mode < ENGINE_NUM_MODES; ++mode) {
+        printf("  mode %d", mode);
+    }
+    printf("\n");
+
+    const int16_t region = ADC_IN_MAX / ENGINE_NUM_MODES + 1;
+    for (size_t d = 0; d < sizeof(deltas) / sizeof(deltas[0]); ++d) {
+        printf("  %-6d", deltas[d]);
+        double start = NowSeconds();
+        uint64_t total_out = 0;
+        for (int mode = 0; mode < ENGINE_NUM_MODES; ++mode) {
+            const galvo_slew_config_t config = {true, deltas[d], false};
+            galvo_slew_t slew;
+            GalvoSlewInit(&slew, &config);
+            InitEngine(&context);
+
+            const int16_t cv = (int16_t)(mode * region + region / 2);
+            for (uint32_t n = 0; n < BENCH_ENGINE_BLOCKS / 10; ++n) {
+                for (int i = 0; i < ENGINE_MAX_BLOCK; ++i) {
+                    inputs[i] = (engine_inputs_t){
+                        BenchRandomAdc(), BenchRandomAdc(), ADC_IN_MIDPOINT, cv, ADC_IN_MAX * 3 / 4
+                    };
+                }
+                RunEngineBlock(&context, inputs, &g_bench_silence, &block, ENGINE_MAX_BLOCK);
+                int consumed = 0;
+                while (consumed < ENGINE_MAX_BLOCK) {
+                    int count = 0;
+                    consumed += GalvoSlewBlock(&slew, &block, consumed, ENGINE_MAX_BLOCK, &out, &count, ENGINE_MAX_BLOCK);
+                }
+            }
+            printf("  %5.2fx", (double)slew.points_out / (double)slew.points_in);
+            total_out += slew.points_out;
+        }
+        const double seconds = NowSeconds() - start;
+        printf("  %6.2f ns/output point\n", seconds / (double)total_out * 1e9);
+    }
+}
+
+/*
+ * Runs every mode through the blank and dwell stage with the default settings
+ * and reports the point expansion.
+ */
+static void BenchBlankDwell(void) {
+    static engine_context_t context;
+    static engine_inputs_t inputs[ENGINE_MAX_BLOCK];
+    static engine_output_block_t block;
+    static engine_output_block_t out;
+
+    const blank_dwell_config_t config = {
+        true, BLANK_DWELL_DEFAULT_PRE, BLANK_DWELL_DEFAULT_POST, BLANK_DWELL_DEFAULT_DWELL, BLANK_DWELL_DEFAULT_CORNER
+    };
+    const int16_t region = ADC_IN_MAX / ENGINE_NUM_MODES + 1;
+    double start = NowSeconds();
+    uint64_t total_out = 0;
+    printf(" ");
+    for (int mode = 0; mode < ENGINE_NUM_MODES; ++mode) {
+        blank_dwell_t stage;
+        BlankDwellInit(&stage, &config);
+        InitEngine(&context);
+
+        const int16_t cv = (int16_t)(mode * region + region / 2);
+        for (uint32_t n = 0; n < BENCH_ENGINE_BLOCKS / 10; ++n) {
+            for (int i = 0; i < ENGINE_MAX_BLOCK; ++i) {
+                inputs[i] = (engine_inputs_t){
+                    BenchRandomAdc(), BenchRandomAdc(), ADC_IN_MIDPOINT, cv, ADC_IN_MAX * 3 / 4
+                };
+            }
+            RunEngineBlock(&context, inputs, &g_bench_silence, &block, ENGINE_MAX_BLOCK);
+            int consumed = 0;
+            while (consumed < ENGINE_MAX_BLOCK) {
+                int count = 0;
+                consumed += BlankDwellBlock(&stage, &block, consumed, ENGINE_MAX_BLOCK, &out, &count, ENGINE_MAX_BLOCK);
+            }
+        }
+        printf(" mode %d %5.2fx", mode, (double)stage.points_out / (double)stage.points_in);
+        total_out += stage.points_out;
+    }
+    const double seconds = NowSeconds() - start;
+    printf("  %6.2f ns/output point\n", seconds / (double)total_out * 1e9);
+}
+
+/*
+ * Random frames of short strokes at random places, the worst case for
+ * generation order. Reports blank travel in generation order, after the
+ * nearest neighbour chain and after 2-opt, and how many engine blocks the
+ * optimizer needs at FRAME_OPT_STEP_BUDGET evaluations per block.
+ */
+static void BenchFrameOptimizer(void) {
+    static const int segment_counts[] = {4, 16, 32, FRAME_OPT_MAX_SEGMENTS};
+    static frame_points_t points;
+    static frame_optimizer_t opt;
+    const int trials = 200;
+
+    printf("  %-8s %10s %10s %10s %8s %8s %10s\n", "segments", "before", "nearest", "2-opt", "evals", "blocks",
+           "us/frame");
+    for (size_t c = 0; c < sizeof(segment_counts) / sizeof(segment_counts[0]); ++c) {
+        const int segments = segment_counts[c];
+        const int stroke = ENGINE_FRAME_MAX_POINTS / segments - 1;
+        uint64_t before = 0;
+        uint64_t nearest = 0;
+        uint64_t after = 0;
+        uint64_t evaluations = 0;
+        uint64_t blocks = 0;
+        double seconds = 0.0;
+
+        for (int t = 0; t < trials; ++t) {
+            points.n = 0;
+            for (int s = 0; s < segments; ++s) {
+                const int16_t x = (int16_t)(BenchRandom() % (LASER_POS_MAX - 200));
+                const int16_t y = (int16_t)(BenchRandom() % (LASER_POS_MAX - 200));
+                for (int k = 0; k <= stroke; ++k) {
+                    const int i = points.n++;
+                    const bool lit = k > 0;
+                    points.x[i] = (int16_t)(x + k * 200 / stroke);
+                    points.y[i] = y;
+                    points.r[i] = lit ? LASER_PWM_MAX : 0;
+                    points.g[i] = 0;
+                    points.b[i] = lit ? LASER_PWM_MAX : 0;
+                }
+            }
+
+            const double start = NowSeconds();
+            FrameOptimizerStart(&opt, &points);
+            int steps = 1;
+            while (!FrameOptimizerStep(&opt, FRAME_OPT_STEP_BUDGET)) {
+                ++steps;
+            }
+            seconds += NowSeconds() - start;
+            before += opt.travel_before;
+            nearest += opt.travel_nearest;
+            after += opt.travel_after;
+            evaluations += opt.evaluations;
+            blocks += (uint64_t)steps;
+        }
+        printf("  %-8d %10.0f %10.0f %10.0f %8.0f %8.1f %10.2f\n", segments, (double)before / trials,
+               (double)nearest / trials, (double)after / trials, (double)evaluations / trials,
+               (double)blocks / trials, seconds / trials * 1e6);
+    }
+}
+
+// Decode speed of the ILDA reader on the built-in show.
+static void BenchIlda(void) {
+    ilda_file_t show;
+    if (!IldaOpen(&show, g_ilda_default_show, g_ilda_default_show_size)) {
+        printf("  built-in show               FAIL\n");
+        return;
+    }
+    ilda_cursor_t cursor = {0};
+    ilda_point_t point;
+    uint64_t points = 0;
+    int64_t acc = 0;
+    const double start = NowSeconds();
+    for (uint32_t pass = 0; pass < BENCH_ENGINE_BLOCKS; ++pass) {
+        IldaSeekFrame(&show, &cursor, (uint16_t)(pass % show.num_frames));
+        while (IldaNextPoint(&show, &cursor, &point)) {
+            acc += point.x + point.r;
+            ++points;
+        }
+    }
+    g_bench_sink = acc;
+    printf("  built-in show: %u frames, %zu bytes\n", show.num_frames, show.size);
+    PrintRate("IldaNextPoint", points, NowSeconds() - start);
+}
+
+void FreeBenchShow(bench_show_t* show) {
+    free(show->points);
+    free(show->frame_points);
+    *show = (bench_show_t){0};
+}
+
+static bool AddBenchShowPoint(bench_show_t* show, size_t* capacity, const compact_point_t point) {
+    if (show->frame_points[show->num_frames - 1] == UINT16_MAX) {
+        return false;
+    }
+    if (show->num_points == *capacity) {
+        *capacity = *capacity == 0 ? 1024 : *capacity * 2;
+        compact_point_t* grown = realloc(show->points, *capacity * sizeof(*grown));
+        if (grown == NULL) {
+            return false;
+        }
+        show->points = grown;
+    }
+    show->points[show->num_points++] = point;
+    ++show->frame_points[show->num_frames - 1];
+    return true;
+}
+
+bool LoadIldaShow(bench_show_t* show, const uint8_t* data, const size_t size) {
+    *show = (bench_show_t){0};
+    ilda_file_t file;
+    if (!IldaOpen(&file, data, size)) {
+        return false;
+    }
+    show->frame_points = calloc(file.num_frames, sizeof(uint16_t));
+    if (show->frame_points == NULL) {
+        return false;
+    }
+    size_t capacity = 0;
+    ilda_cursor_t cursor = {0};
+    for (uint16_t f = 0; f < file.num_frames; ++f) {
+        IldaSeekFrame(&file, &cursor, f);
+        ++show->num_frames;
+        ilda_point_t point;
+        while (IldaNextPoint(&file, &cursor, &point)) {
+            if (!AddBenchShowPoint(show, &capacity, (compact_point_t){point.x, point.y, point.r, point.g, point.b})) {
+                FreeBenchShow(show);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// "x,y,r,g,b" lines as written by "photon -o", a blank line between frames.
+static bool LoadCsvShow(bench_show_t* show, FILE* input) {
+    *show = (bench_show_t){0};
+    size_t capacity = 0;
+    size_t frames_capacity = 0;
+    bool frame_open = false;
+    char line[128];
+    while (fgets(line, sizeof(line), input) != NULL) {
+        int values[5];
+        if (sscanf(line, " %d , %d , %d , %d , %d", &values[0], &values[1], &values[2], &values[3], &values[4]) != 5) {
+            frame_open = false;
+            continue;
+        }
+        if (!frame_open) {
+            if (show->num_frames == UINT16_MAX) {
+                FreeBenchShow(show);
+                return false;
+            }
+            if (show->num_frames == frames_capacity) {
+                frames_capacity = frames_capacity == 0 ? 16 : frames_capacity * 2;
+                uint16_t* grown = realloc(show->frame_points, frames_capacity * sizeof(*grown));
+                if (grown == NULL) {
+                    FreeBenchShow(show);
+                    return false;
+                }
+                show->frame_points = grown;
+            }
+            show->frame_points[show->num_frames++] = 0;
+            frame_open = true;
+        }
+        const compact_point_t point = {(int16_t)values[0], (int16_t)values[1], (int16_t)values[2],
+                                       (int16_t)values[3], (int16_t)values[4]};
+        if (!AddBenchShowPoint(show, &capacity, point)) {
+            FreeBenchShow(show);
+            return false;
+        }
+    }
+    return show->num_frames > 0;
+}
+
+// Encodes into a malloc'd buffer, returns its size or 0.
+size_t EncodeBenchShow(const bench_show_t* show, uint8_t** out) {
+    compact_encoder_t encoder;
+    CompactEncoderInit(&encoder, NULL, 0, show->num_frames);
+    const compact_point_t* points = show->points;
+    for (uint16_t f = 0; f < show->num_frames; points += show->frame_points[f++]) {
+        CompactEncodeFrame(&encoder, points, show->frame_points[f]);
+    }
+    const size_t size = encoder.size;
+    *out = malloc(size);
+    if (*out == NULL) {
+        return 0;
+    }
+
+    CompactEncoderInit(&encoder, *out, size, show->num_frames);
+    points = show->points;
+    for (uint16_t f = 0; f < show->num_frames; points += show->frame_points[f++]) {
+        CompactEncodeFrame(&encoder, points, show->frame_points[f]);
+    }
+    return CompactEncoderFinish(&encoder);
+}
+
+static inline int16_t BenchClampPosition(const int16_t value) {
+    return value < 0 ? 0 : (value > LASER_POS_MAX ? LASER_POS_MAX : value);
+}
+
+// What the format keeps of a colour level: its top 8 bits.
+static inline int16_t BenchCompactLevel(const int16_t level) {
+    return CompactColorLevel((uint8_t)(level <= 0 ? 0 : (level > LASER_PWM_MAX ? LASER_PWM_MAX : level) >> 4));
+}
+
+bool CheckCompactShow(const bench_show_t* show, const uint8_t* data, const size_t size) {
+    compact_show_t compact;
+    if (!CompactShowOpen(&compact, data, size) || compact.num_frames != show->num_frames) {
+        return false;
+    }
+    compact_cursor_t cursor;
+    const compact_point_t* expected = show->points;
+    for (uint16_t f = 0; f < show->num_frames; ++f) {
+        CompactShowSeek(&compact, &cursor, f);
+        compact_point_t point;
+        uint16_t k = 0;
+        for (; CompactNextPoint(&cursor, &point); ++k, ++expected) {
+            if (k >= show->frame_points[f] || point.x != BenchClampPosition(expected->x)
+                    || point.y != BenchClampPosition(expected->y) || point.r != BenchCompactLevel(expected->r)
+                    || point.g != BenchCompactLevel(expected->g) || point.b != BenchCompactLevel(expected->b)) {
+                return false;
+            }
+        }
+        if (k != show->frame_points[f]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Bytes per point of the two uncompressed references: raw 16-bit XY+RGB and ILDA format 5.
+#define BENCH_RAW_POINT_SIZE    10
+#define BENCH_ILDA5_POINT_SIZE  8
+
+static void PrintCompactSizes(const bench_show_t* show, const size_t size) {
+    const size_t raw = show->num_points * BENCH_RAW_POINT_SIZE;
+    const size_t ilda = (size_t)(show->num_frames + 1) * ILDA_HEADER_SIZE + show->num_points * BENCH_ILDA5_POINT_SIZE;
+    printf("  %u frames, %zu points\n", show->num_frames, show->num_points);
+    printf("  raw XY+RGB %8zu bytes\n", raw);
+    printf("  ILDA 5     %8zu bytes\n", ilda);
+    printf("  compact    %8zu bytes, %.2f bytes/point, %.2fx raw, %.2fx ILDA\n", size,
+           show->num_points > 0 ? (double)size / (double)show->num_points : 0.0,
+           size > 0 ? (double)raw / (double)size : 0.0, size > 0 ? (double)ilda / (double)size : 0.0);
+}
+
+#define BENCH_COMPACT_POINTS    2000
+
+bool BuildRandomWalkShow(bench_show_t* show) {
+    *show = (bench_show_t){0};
+    show->points = malloc(BENCH_COMPACT_POINTS * sizeof(compact_point_t));
+    show->frame_points = malloc(2 * sizeof(uint16_t));
+    if (show->points == NULL || show->frame_points == NULL) {
+        FreeBenchShow(show);
+        return false;
+    }
+    show->num_points = BENCH_COMPACT_POINTS;
+    show->num_frames = 2;
+    show->frame_points[0] = BENCH_COMPACT_POINTS / 4;
+    show->frame_points[1] = BENCH_COMPACT_POINTS - BENCH_COMPACT_POINTS / 4;
+    int16_t x = ADC_IN_MIDPOINT;
+    int16_t y = ADC_IN_MIDPOINT;
+    for (int i = 0; i < BENCH_COMPACT_POINTS; ++i) {
+        const bool jump = BenchRandom() % 16 == 0;
+        x = (int16_t)(jump ? (int)(BenchRandom() % 5000) - 400 : x + (int)(BenchRandom() % 65) - 32);
+        y = (int16_t)(jump ? (int)(BenchRandom() % 5000) - 400 : y + (int)(BenchRandom() % 65) - 32);
+        const bool lit = BenchRandom() % 8 != 0;
+        show->points[i] = (compact_point_t){x, y, (int16_t)(lit ? BenchRandom() % 4400 : 0), (int16_t)(lit ? 4095 : 0), 0};
+    }
+    return true;
+}
+
+/*
+ * Size of the built-in show and of a random walk against raw points and
+ * ILDA, then decode speed.
+ */
+static void BenchCompactShow(void) {
+    bench_show_t show;
+    uint8_t* blob = NULL;
+    if (!LoadIldaShow(&show, g_ilda_default_show, g_ilda_default_show_size)) {
+        printf("  built-in show               FAIL\n");
+        return;
+    }
+    const size_t size = EncodeBenchShow(&show, &blob);
+    PrintCompactSizes(&show, size);
+
+    compact_show_t compact;
+    if (size > 0 && CompactShowOpen(&compact, blob, size)) {
+        compact_cursor_t cursor;
+        compact_point_t point;
+        uint64_t points = 0;
+        int64_t acc = 0;
+        const double start = NowSeconds();
+        for (uint32_t pass = 0; pass < BENCH_ENGINE_BLOCKS; ++pass) {
+            CompactShowSeek(&compact, &cursor, (uint16_t)(pass % compact.num_frames));
+            while (CompactNextPoint(&cursor, &point)) {
+                acc += point.x + point.r;
+                ++points;
+            }
+        }
+        g_bench_sink = acc;
+        PrintRate("CompactNextPoint", points, NowSeconds() - start);
+    }
+    FreeBenchShow(&show);
+    free(blob);
+
+    if (BuildRandomWalkShow(&show)) {
+        PrintCompactSizes(&show, EncodeBenchShow(&show, &blob));
+        FreeBenchShow(&show);
+        free(blob);
+    }
+}
+
+static const host_benchmark_t g_benchmarks[] = {
+    {"trig", "LUT sine vs libm throughput", BenchTrig},
+    {"shapes", "Shape table lookups vs per-point trig, speed and flash", BenchShapeTables},
+    {"decimator", "Audio CIC+FIR decimator cost per sample", BenchAudioDecimator},
+    {"bands", "Goertzel band bank cost per sample", BenchAudioBands},
+    {"spectrum", "Fixed-point FFT spectrum analyzer cost per point", BenchSpectrum},
+    {"beat", "Beat tracker cost per frame", BenchBeatTracker},
+    {"crossfade", "RunEngineBlock cost per point, single mode vs crossfade", BenchCrossfade},
+    {"selector", "Mode selector cost per block", BenchModeSelector},
+    {"block", "RunEngineBlock vs per-point RunEngine throughput", BenchEngineBlock},
+    {"slew", "Galvo slew limiter point expansion per mode", BenchGalvoSlew},
+    {"dwell", "Blanking and corner dwell expansion per mode", BenchBlankDwell},
+    {"reorder", "Frame segment reordering, blank travel before and after", BenchFrameOptimizer},
+    {"ilda", "ILDA reader decode speed", BenchIlda},
+    {"compact", "Compact show size against raw and ILDA, decode speed", BenchCompactShow},
+};
+
+#define NUM_BENCHMARKS (sizeof(g_benchmarks) / sizeof(g_benchmarks[0]))
+
+bool RunHostBenchmark(const char* name) {
+    bool found = false;
+    for (size_t i = 0; i < NUM_BENCHMARKS; ++i) {
+        if (strcmp(name, "all") == 0 || strcmp(name, g_benchmarks[i].name) == 0) {
+            printf("%s: %s\n", g_benchmarks[i].name, g_benchmarks[i].description);
+            g_benchmarks[i].run();
+            found = true;
+        }
+    }
+    return found;
+}
+
+void ListHostBenchmarks(void) {
+    for (size_t i = 0; i < NUM_BENCHMARKS; ++i) {
+        fprintf(stderr, "  %-10s %s\n", g_benchmarks[i].name, g_benchmarks[i].description);
+    }
+}
+
+bool DecodeIldaFile(const char* path) {
+    size_t size;
+    uint8_t* data = ReadHostFile(path, &size);
+    if (data == NULL) {
+        return false;
+    }
+
+    ilda_file_t file;
+    if (!IldaOpen(&file, data, size)) {
+        fprintf(stderr, "%s: not a valid ILDA file\n", path);
+        free(data);
+        return false;
+    }
+
+    ilda_cursor_t cursor = {0};
+    uint64_t total = 0;
+    printf("%-6s %6s %7s %7s %11s %11s\n", "frame", "format", "points", "blanked", "x", "y");
+    for (uint16_t f = 0; f < file.num_frames; ++f) {
+        IldaSeekFrame(&file, &cursor, f);
+        ilda_point_t point;
+        int points = 0;
+        int blanked = 0;
+        int16_t x_min = LASER_POS_MAX;
+        int16_t x_max = 0;
+        int16_t y_min = LASER_POS_MAX;
+        int16_t y_max = 0;
+        for (; IldaNextPoint(&file, &cursor, &point); ++points) {
+            blanked += point.blanked ? 1 : 0;
+            x_min = point.x < x_min ? point.x : x_min;
+            x_max = point.x > x_max ? point.x : x_max;
+            y_min = point.y < y_min ? point.y : y_min;
+            y_max = point.y > y_max ? point.y : y_max;
+        }
+        printf("%-6u %6u %7d %7d %5d..%-5d %5d..%-5d\n", f, cursor.format, points, blanked, x_min, x_max, y_min, y_max);
+        total += (uint64_t)points;
+    }
+    printf("frames: %u\npoints: %llu\n", file.num_frames, (unsigned long long)total);
+    free(data);
+    return true;
+}
+
+bool EncodeCompactShowFile(const char* path, FILE* output) {
+    size_t size;
+    uint8_t* data = ReadHostFile(path, &size);
+    if (data == NULL) {
+        return false;
+    }
+
+    bench_show_t show;
+    bool loaded = LoadIldaShow(&show, data, size);
+    if (!loaded) {
+        FILE* input = fopen(path, "r");
+        loaded = input != NULL && LoadCsvShow(&show, input);
+        if (input != NULL) {
+            fclose(input);
+        }
+    }
+    free(data);
+    if (!loaded) {
+        fprintf(stderr, "%s: neither ILDA nor x,y,r,g,b CSV\n", path);
+        return false;
+    }
+
+    uint8_t* blob = NULL;
+    const size_t encoded = EncodeBenchShow(&show, &blob);
+    const bool ok = encoded > 0 && CheckCompactShow(&show, blob, encoded);
+    if (!ok) {
+        fprintf(stderr, "%s: round trip through the compact format failed\n", path);
+    } else {
+        PrintCompactSizes(&show, encoded);
+    }
+    const bool written = ok && (output == NULL || fwrite(blob, 1, encoded, output) == encoded);
+    FreeBenchShow(&show);
+    free(blob);
+    return written;
+}
+
+bool AnalyzeWavFile(const char* path) {
+    bench_audio_t audio = {0};
+    if (!ReadWavFile(path, &audio)) {
+        return false;
+    }
+    bench_beats_t beats;
+    const bool tracked = TrackBeats(&audio, &beats);
+    const double seconds = (double)audio.frames / ADC_SAMPLE_RATE_DEFAULT_HZ;
+    FreeBenchAudio(&audio);
+    if (!tracked) {
+        return false;
+    }
+
+    printf("%10s  %s\n", "time (s)", "event");
+    for (size_t onset = 0, beat = 0; onset < beats.num_onsets || beat < beats.num_beats;) {
+        const bool is_beat = beat < beats.num_beats
+                             && (onset == beats.num_onsets || beats.beats[beat] <= beats.onsets[onset]);
+        const uint32_t frame = is_beat ? beats.beats[beat++] : beats.onsets[onset++];
+        printf("%10.3f  %s\n", (double)frame / ADC_SAMPLE_RATE_DEFAULT_HZ, is_beat ? "beat" : "onset");
+    }
+    printf("%s: %.2f s, %zu onsets, %zu beats", path, seconds, beats.num_onsets, beats.num_beats);
+    if (beats.num_beats > 0) {
+        printf(", first at %.3f s, tempo %.2f BPM", (double)beats.beats[0] / ADC_SAMPLE_RATE_DEFAULT_HZ, beats.bpm);
+    }
+    printf("\n");
+    FreeBenchBeats(&beats);
+    return true;
+}
\ No newline at end of file
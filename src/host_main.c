@@ -0,0 +1,180 @@
+/*
+ * Native entry point, built with "make host". Runs the engine loop through
+ * platform_posix.c at full speed and reports the point rate.
+ *
+ *   build/host/photon [-n points] [-i frames.csv] [-o points.csv]
+ *                     [-l cv_left] [-c cv_middle] [-r cv_right]
+ *   build/host/photon -b <benchmark|all>
+ *   build/host/photon -t <test|all>
+ *   build/host/photon -d <file.ild>
+ *   build/host/photon -e <file.ild|points.csv> [-o show.bin]
+ *   build/host/photon -w <file.wav>
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "app.h"
+#include "host_bench.h"
+#include "host_test.h"
+#include "platform.h"
+#include "platform_posix.h"
+#include "profile.h"
+
+#define DEFAULT_NUM_POINTS 10000000
+
+static double NowSeconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+#if ENABLE_PROFILING
+static const char* const g_profile_stage_names[PROFILE_MODE_BASE] = {"input", "engine", "output", "tick"};
+
+/*
+ * Cost per stage against the time one point may take at the default output rate. Every slot but
+ * the tick times a whole block, so it is charged per point.
+ */
+static void PrintProfile(void) {
+    const double budget = (double)PlatformCyclesPerSecond() / OUTPUT_RATE_DEFAULT_HZ;
+    printf("\n%-8s %10s %8s %10s %8s %7s  histogram (log2 cycles)\n",
+           "stage", "count", "min", "mean", "max", "budget");
+    for (unsigned slot = 0; slot < PROFILE_NUM_SLOTS; ++slot) {
+        const profile_stats_t* stats = ProfileGetStats(slot);
+        if (stats->count == 0) {
+            continue;
+        }
+        char name[16];
+        if (slot < PROFILE_MODE_BASE) {
+            snprintf(name, sizeof(name), "%s", g_profile_stage_names[slot]);
+        } else {
+            snprintf(name, sizeof(name), "mode %u", slot - PROFILE_MODE_BASE);
+        }
+        const double mean = (double)stats->total / stats->count;
+        const double per_point = slot == PROFILE_TICK ? mean : mean / OUTPUT_BLOCK_SIZE;
+        printf("%-8s %10u %8u %10.1f %8u %6.2f%% ", name, stats->count, stats->min, mean, stats->max,
+               100.0 * per_point / budget);
+        for (unsigned bin = 0; bin < PROFILE_HIST_BINS; ++bin) {
+            printf(" %u", stats->histogram[bin]);
+        }
+        printf("\n");
+    }
+}
+#endif
+
+static void PrintUsage(const char* name) {
+    fprintf(stderr, "usage: %s [-n points] [-i frames.csv] [-o points.csv] "
+                    "[-l cv_left] [-c cv_middle] [-r cv_right]\n"
+                    "       %s -b <benchmark|all>\n"
+                    "       %s -t <test|all>\n"
+                    "       %s -d <file.ild>\n"
+                    "       %s -e <file.ild|points.csv> [-o show.bin]\n"
+                    "       %s -w <file.wav>\n", name, name, name, name, name, name);
+    fprintf(stderr, "benchmarks:\n");
+    ListHostBenchmarks();
+    fprintf(stderr, "tests:\n");
+    ListHostTests();
+}
+
+int main(int argc, char** argv) {
+    posix_platform_config_t config = {
+        .input = NULL,
+        .output = NULL,
+        .num_points = DEFAULT_NUM_POINTS,
+        .synthetic = {0, 0, ADC_IN_MIDPOINT, ADC_IN_MIDPOINT, ADC_IN_MIDPOINT}
+    };
+
+    const char* encode = NULL;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:i:o:l:c:r:b:t:d:e:w:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                config.num_points = strtoull(optarg, NULL, 0);
+                break;
+            case 'i':
+                config.input = fopen(optarg, "r");
+                if (config.input == NULL) {
+                    perror(optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'o':
+                config.output = fopen(optarg, "w");
+                if (config.output == NULL) {
+                    perror(optarg);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'l':
+                config.synthetic.cv_in_left = (int16_t)atoi(optarg);
+                break;
+            case 'c':
+                config.synthetic.cv_in_middle = (int16_t)atoi(optarg);
+                break;
+            case 'r':
+                config.synthetic.cv_in_right = (int16_t)atoi(optarg);
+                break;
+            case 'b':
+                if (!RunHostBenchmark(optarg)) {
+                    PrintUsage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+                return EXIT_SUCCESS;
+            case 't': {
+                const int failed = RunHostTests(optarg);
+                if (failed < 0) {
+                    PrintUsage(argv[0]);
+                }
+                return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+            }
+            case 'd':
+                return DecodeIldaFile(optarg) ? EXIT_SUCCESS : EXIT_FAILURE;
+            case 'e':
+                encode = optarg;
+                break;
+            case 'w':
+                return AnalyzeWavFile(optarg) ? EXIT_SUCCESS : EXIT_FAILURE;
+            case 'h':
+            default:
+                PrintUsage(argv[0]);
+                return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    if (encode != NULL) {
+        const bool encoded = EncodeCompactShowFile(encode, config.output);
+        if (config.output != NULL) {
+            fclose(config.output);
+        }
+        return encoded ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    PosixPlatformConfigure(&config);
+    PlatformStart();
+    AppInit();
+
+    const double start = NowSeconds();
+    while (AppStep()) {
+    }
+    const double elapsed = NowSeconds() - start;
+
+    const uint64_t points = PosixPlatformPointCount();
+    printf("points: %llu\n", (unsigned long long)points);
+    printf("time:   %.3f s\n", elapsed);
+    printf("rate:   %.0f points/s\n", elapsed > 0.0 ? (double)points / elapsed : 0.0);
+#if ENABLE_PROFILING
+    PrintProfile();
+#endif
+
+    if (config.input != NULL) {
+        fclose(config.input);
+    }
+    if (config.output != NULL) {
+        fclose(config.output);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,1777 @@
+/*
+ * Host checks, selected with "photon -t <name>" and run by "make host-test".
+ * Each prints what it measured against its tolerance and returns whether
+ * every case passed, so a run with any failure exits non-zero. Throughput
+ * figures are in host_bench.c.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "app.h"
+#include "audio_bands.h"
+#include "audio_decimator.h"
+#include "beat_tracker.h"
+#include "blank_dwell.h"
+#include "platform.h"
+#include "board.h"
+#include "compact_show.h"
+#include "dac_mcp4822.h"
+#include "engine.h"
+#include "engine_float.h"
+#include "frame_optimizer.h"
+#include "hal.h"
+#include "host_bench.h"
+#include "host_test.h"
+#include "ilda.h"
+#include "laser_pwm.h"
+#include "platform_posix.h"
+#include "point_ring.h"
+#include "shape_tables.h"
+#include "spectrum.h"
+#include "trig_lut.h"
+
+#define TEST_FIXED_RUNS     64      // Per mode, each with its own CVs
+#define TEST_FIXED_POINTS   8192
+#define TEST_BLOCKS_PER_CV  64
+
+typedef bool (*testFunctor)(void);
+
+typedef struct hosttest {
+    const char* name;
+    const char* description;
+    testFunctor run;
+} host_test_t;
+
+// Audio features for the checks that leave the audio analysis out.
+static const engine_audio_features_t g_test_silence = {{0}, 0, 0, 0, {{0}}, 0};
+
+// SinQ15() over the whole turn against libm. Stated tolerance: 2 LSB.
+static bool TestTrig(void) {
+    double max_error = 0.0;
+    for (uint64_t p = 0; p < (1ull << 32); p += 97) {
+        const double reference = sin((double)p * (BENCH_TWO_PI / 4294967296.0)) * Q15_ONE;
+        const double error = fabs((double)SinQ15((phase_t)p) - reference);
+        max_error = error > max_error ? error : max_error;
+    }
+    const bool ok = max_error <= 2.0;
+    printf("  SinQ15 max error vs libm:        %.3f LSB (Q15)  %s\n", max_error, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+/*
+ * CircleQ15() and the starry table against libm, in Q15 LSB. Stated
+ * tolerance: 2 LSB.
+ */
+static bool TestShapeTables(void) {
+    double circle_error = 0.0;
+    for (uint64_t p = 0; p < (1ull << 32); p += 97) {
+        const double angle = (double)p * (BENCH_TWO_PI / 4294967296.0);
+        const shape_point_t circle = CircleQ15((phase_t)p);
+        const double error_x = fabs((double)circle.x - cos(angle) * Q15_ONE);
+        const double error_y = fabs((double)circle.y - sin(angle) * Q15_ONE);
+        circle_error = error_x > circle_error ? error_x : circle_error;
+        circle_error = error_y > circle_error ? error_y : circle_error;
+    }
+    double starry_error = 0.0;
+    for (int p = 0; p < SHAPE_STARRY_POINTS; ++p) {
+        const double angle = BENCH_TWO_PI * p / SHAPE_STARRY_POINTS;
+        const double error_x = fabs((double)g_shape_circle_starry[p].x - cos(angle) * Q15_ONE);
+        const double error_y = fabs((double)g_shape_circle_starry[p].y - sin(angle) * Q15_ONE);
+        starry_error = error_x > starry_error ? error_x : starry_error;
+        starry_error = error_y > starry_error ? error_y : starry_error;
+    }
+    printf("  CircleQ15 max error vs libm:     %.3f LSB (Q15)\n", circle_error);
+    printf("  starry table max error vs libm:  %.3f LSB (Q15)\n", starry_error);
+    const bool ok = circle_error <= 2.0 && starry_error <= 2.0;
+    printf("  tolerance:                       2 LSB  %s\n", ok ? "ok" : "FAIL");
+    return ok;
+}
+
+// Largest difference between the first points of two blocks, over every channel.
+static int PointDiff(const engine_output_block_t* a, const engine_output_block_t* b) {
+    const int diffs[] = {
+        abs(a->x[0] - b->x[0]), abs(a->y[0] - b->y[0]), abs(a->r[0] - b->r[0]), abs(a->g[0] - b->g[0]),
+        abs(a->b[0] - b->b[0]),
+    };
+    int max_diff = 0;
+    for (size_t i = 0; i < sizeof(diffs) / sizeof(diffs[0]); ++i) {
+        max_diff = diffs[i] > max_diff ? diffs[i] : max_diff;
+    }
+    return max_diff;
+}
+
+/*
+ * Every mode through RunEngineBlock() against the float reference build,
+ * engine_float.c, on random audio and CVs anywhere in the mode's region,
+ * crossfades included. The envelopes integrate, so the builds can turn one
+ * a point apart and that offset would carry on. The float build takes the
+ * fixed-point one's state before every point, each is checked on its own
+ * arithmetic. Stated tolerance: 2 LSB of the 12-bit outputs.
+ */
+static bool TestFixedPoint(void) {
+    static engine_context_t fixed;
+    static engine_context_t reference;
+    static engine_output_block_t fixed_point;
+    static engine_output_block_t reference_point;
+    const int16_t region = ADC_IN_MAX / ENGINE_NUM_MODES + 1;
+    int max_diff = 0;
+    for (int mode = 0; mode < ENGINE_NUM_MODES; ++mode) {
+        int mode_diff = 0;
+        for (int run = 0; run < TEST_FIXED_RUNS; ++run) {
+            InitEngine(&fixed);
+            const int16_t cv_left = BenchRandomAdc();
+            const int16_t cv_middle = (int16_t)(mode * region + (int)(BenchRandom() % (uint32_t)region));
+            const int16_t cv_right = BenchRandomAdc();
+            for (int point = 0; point < TEST_FIXED_POINTS; ++point) {
+                const engine_inputs_t inputs = {BenchRandomAdc(), BenchRandomAdc(), cv_left, cv_middle, cv_right};
+                FloatCopyEngineContext(&reference, &fixed);
+                RunEngineBlock(&fixed, &inputs, &g_test_silence, &fixed_point, 1);
+                FloatRunEngineBlock(&reference, &inputs, &g_test_silence, &reference_point, 1);
+                const int diff = PointDiff(&fixed_point, &reference_point);
+                mode_diff = diff > mode_diff ? diff : mode_diff;
+            }
+        }
+        printf("  mode %d max error:  %d LSB\n", mode, mode_diff);
+        max_diff = mode_diff > max_diff ? mode_diff : max_diff;
+    }
+    const bool ok = max_diff <= 2;
+    printf("  tolerance:          2 LSB  %s\n", ok ? "ok" : "FAIL");
+    return ok;
+}
+
+#define TEST_DECIMATOR_FRAMES      4000
+#define TEST_DECIMATOR_SETTLE      64
+#define TEST_DECIMATOR_AMPLITUDE   1800.0
+
+typedef struct testdecimatortone {
+    double hz;                  // At the default 20kHz frame rate
+    double min_db;              // Gain must stay within [min_db, max_db]
+    double max_db;
+} test_decimator_tone_t;
+
+/*
+ * The passband, the FIR's stopband (13..27kHz, which folds onto 0..7kHz)
+ * and the CIC's (33kHz up, which folds through the FIR onto the same band).
+ */
+static const test_decimator_tone_t g_decimator_tones[] = {
+    {100.0, -0.1, 0.1}, {1000.0, -0.1, 0.1}, {3000.0, -0.1, 0.1}, {5000.0, -0.1, 0.1}, {6000.0, -0.2, 0.1},
+    {7000.0, -1.0, 0.1}, {8500.0, -10.0, 0.1}, {10000.0, -20.0, 0.1},
+    {13000.0, -INFINITY, -50.0}, {17000.0, -INFINITY, -50.0}, {23000.0, -INFINITY, -50.0}, {27000.0, -INFINITY, -50.0},
+    {33000.0, -INFINITY, -30.0}, {37000.0, -INFINITY, -30.0}, {39000.0, -INFINITY, -30.0},
+};
+
+// Gain in dB of a tone through the decimator, aliases included, from output and input RMS.
+static double DecimatorGain(const double hz) {
+    static uint16_t scans[TEST_DECIMATOR_FRAMES * AUDIO_OVERSAMPLE];
+    const double scan_hz = (double)ADC_SAMPLE_RATE_DEFAULT_HZ * AUDIO_OVERSAMPLE;
+    for (int i = 0; i < TEST_DECIMATOR_FRAMES * AUDIO_OVERSAMPLE; ++i) {
+        scans[i] = (uint16_t)lround(ADC_IN_MIDPOINT + TEST_DECIMATOR_AMPLITUDE * sin(BENCH_TWO_PI * hz * i / scan_hz));
+    }
+
+    audio_decimator_t decimator;
+    AudioDecimatorInit(&decimator);
+    double sum = 0.0;
+    double sum_squares = 0.0;
+    int count = 0;
+    for (int frame = 0; frame < TEST_DECIMATOR_FRAMES; ++frame) {
+        const double value = AudioDecimate(&decimator, &scans[frame * AUDIO_OVERSAMPLE], 1) - ADC_IN_MIDPOINT;
+        if (frame >= TEST_DECIMATOR_SETTLE) {
+            sum += value;
+            sum_squares += value * value;
+            ++count;
+        }
+    }
+    const double mean = sum / count;
+    const double rms = sqrt(sum_squares / count - mean * mean);
+    return 20.0 * log10((rms > 1e-9 ? rms : 1e-9) / (TEST_DECIMATOR_AMPLITUDE / sqrt(2.0)));
+}
+
+// Response of the audio decimator to tones across the oversampled band.
+static bool TestAudioDecimator(void) {
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(g_decimator_tones) / sizeof(g_decimator_tones[0]); ++i) {
+        const test_decimator_tone_t* tone = &g_decimator_tones[i];
+        const double gain = DecimatorGain(tone->hz);
+        const bool pass = gain >= tone->min_db && gain <= tone->max_db;
+        ok = ok && pass;
+        printf("  %7.0f Hz %8.2f dB  [%6.1f, %5.1f] %s\n", tone->hz, gain, tone->min_db, tone->max_db,
+               pass ? "ok" : "FAIL");
+    }
+    return ok;
+}
+
+#define TEST_BANDS_SAMPLES     8000    // 0.4s at 20kHz, past every band's attack
+
+static const double g_band_centres[AUDIO_BANDS] = {63.0, 125.0, 250.0, 500.0, 1000.0, 2000.0, 4000.0, 8000.0};
+
+// Level in dB below full scale, the way the bank maps it.
+static double BandLevelDb(const q15_t level) {
+    return (level / 32768.0 - 1.0) * AUDIO_BANDS_RANGE_LOG2 * 6.0206;
+}
+
+// Feeds a tone to both channels from sample first on, 0 amplitude for silence.
+static void PushBandsTone(audio_bands_t* bands, const double hz, const double amplitude, const int first, const int count) {
+    for (int n = first; n < first + count; ++n) {
+        const int16_t sample = (int16_t)lround(ADC_IN_MIDPOINT + amplitude * sin(BENCH_TWO_PI * hz * n / ADC_SAMPLE_RATE_DEFAULT_HZ));
+        AudioBandsPush(bands, sample, sample);
+    }
+}
+
+// Samples until a band's level crosses target_db, rising to it with a tone or falling to it without.
+static int BandsCrossingSamples(audio_bands_t* bands, const int band, const double hz, const double amplitude,
+                                const double target_db) {
+    for (int n = 0; n < TEST_BANDS_SAMPLES; ++n) {
+        PushBandsTone(bands, hz, amplitude, n, 1);
+        const double db = BandLevelDb(bands->level[band]);
+        if (amplitude > 0.0 ? db >= target_db : db <= target_db) {
+            return n + 1;
+        }
+    }
+    return TEST_BANDS_SAMPLES;
+}
+
+/*
+ * A tone at every band centre, 6 dB below full scale: its own band must read
+ * it within 1 dB and loudest. Then one band tracking level down to 46 dB
+ * below full scale and out of its range, silence, and the attack and release
+ * times.
+ */
+static bool TestAudioBands(void) {
+    static audio_bands_t bands;
+    const double amplitude = ADC_IN_MIDPOINT / 2.0;
+    const double expected_db = 20.0 * log10(amplitude / (1 << AUDIO_BANDS_FULL_SCALE_LOG2));
+    bool ok = true;
+    for (int band = 0; band < AUDIO_BANDS; ++band) {
+        AudioBandsInit(&bands);
+        PushBandsTone(&bands, g_band_centres[band], amplitude, 0, TEST_BANDS_SAMPLES);
+        double loudest_other = -INFINITY;
+        for (int other = 0; other < AUDIO_BANDS; ++other) {
+            const double db = BandLevelDb(bands.level[other]);
+            loudest_other = other != band && db > loudest_other ? db : loudest_other;
+        }
+        const double own_db = BandLevelDb(bands.level[band]);
+        const bool pass = fabs(own_db - expected_db) <= 1.0 && own_db > loudest_other;
+        ok = ok && pass;
+        printf("  %5.0f Hz tone: own band %6.2f dB (expected %6.2f), loudest other %6.2f dB  %s\n",
+               g_band_centres[band], own_db, expected_db, loudest_other, pass ? "ok" : "FAIL");
+    }
+
+    // The last step is under the range, at the floor.
+    for (int step = 1; step <= 3; ++step) {
+        const double quiet = amplitude / pow(10.0, step);
+        AudioBandsInit(&bands);
+        PushBandsTone(&bands, 1000.0, quiet, 0, TEST_BANDS_SAMPLES);
+        const double own_db = BandLevelDb(bands.level[4]);
+        const double floor_db = BandLevelDb(0);
+        const double quiet_db = expected_db - 20.0 * step;
+        const bool pass = fabs(own_db - (quiet_db > floor_db ? quiet_db : floor_db)) <= 1.0;
+        ok = ok && pass;
+        printf("  1000 Hz at %6.2f dB: band %6.2f dB  %s\n", expected_db - 20.0 * step, own_db, pass ? "ok" : "FAIL");
+    }
+
+    AudioBandsInit(&bands);
+    PushBandsTone(&bands, 0.0, 0.0, 0, TEST_BANDS_SAMPLES);
+    bool silent = true;
+    for (int band = 0; band < AUDIO_BANDS; ++band) {
+        silent = silent && bands.level[band] == 0;
+    }
+    ok = ok && silent;
+    printf("  silence: %s\n", silent ? "all bands at 0  ok" : "FAIL");
+
+    // Attack to within 3 dB of the tone, release to 20 dB below it.
+    static const int timed_bands[] = {0, 4, 7};
+    for (size_t i = 0; i < sizeof(timed_bands) / sizeof(timed_bands[0]); ++i) {
+        const int band = timed_bands[i];
+        AudioBandsInit(&bands);
+        const int attack = BandsCrossingSamples(&bands, band, g_band_centres[band], amplitude, expected_db - 3.0);
+        PushBandsTone(&bands, g_band_centres[band], amplitude, attack, TEST_BANDS_SAMPLES);
+        const int release = BandsCrossingSamples(&bands, band, 0.0, 0.0, expected_db - 20.0);
+        printf("  %5.0f Hz band: attack %5.1f ms, release %5.1f ms\n", g_band_centres[band],
+               1e3 * attack / ADC_SAMPLE_RATE_DEFAULT_HZ, 1e3 * release / ADC_SAMPLE_RATE_DEFAULT_HZ);
+    }
+    return ok;
+}
+
+#define TEST_SPECTRUM_MARGIN_DB 12.0
+
+typedef struct testspectrumsignal {
+    const char* name;
+    double left_hz;             // 0 for noise
+    double left_amplitude;      // ADC counts
+    double right_hz;
+    double right_amplitude;
+} test_spectrum_signal_t;
+
+static const test_spectrum_signal_t g_spectrum_signals[] = {
+    {"stereo tones", 1000.0, 1800.0, 3100.0, 900.0},
+    {"full scale", 6000.0, 2040.0, 200.0, 2040.0},
+    {"quiet tone", 500.0, 30.0, 0.0, 0.0},
+    {"noise", 0.0, 1800.0, 0.0, 1800.0},
+};
+
+static int16_t TestSpectrumSample(const double hz, const double amplitude, const int n) {
+    if (amplitude == 0.0) {
+        return ADC_IN_MIDPOINT;
+    }
+    if (hz == 0.0) {
+        return (int16_t)(ADC_IN_MIDPOINT + (int)(BenchRandom() % (uint32_t)(2.0 * amplitude + 1.0)) - (int)amplitude);
+    }
+    return (int16_t)lround(ADC_IN_MIDPOINT + amplitude * sin(BENCH_TWO_PI * hz * n / ADC_SAMPLE_RATE_DEFAULT_HZ));
+}
+
+// Band level the analyzer would give for an exact magnitude.
+static double TestSpectrumLevel(const double magnitude) {
+    if (magnitude <= 0.0) {
+        return 0.0;
+    }
+    const double octaves = log2(magnitude) - (SPECTRUM_FULL_SCALE_LOG2 - SPECTRUM_RANGE_LOG2);
+    return octaves <= 0.0 ? 0.0 : (octaves >= SPECTRUM_RANGE_LOG2 ? 1.0 : octaves / SPECTRUM_RANGE_LOG2);
+}
+
+/*
+ * One capture of a signal through the analyzer against a double-precision
+ * DFT of the same samples: the packed transform's SNR and RMS error per
+ * bin, and the worst band level error in dB. Bands within
+ * TEST_SPECTRUM_MARGIN_DB of the floor are left out, one LSB there is
+ * already a couple of dB.
+ */
+static bool CheckSpectrumSignal(const test_spectrum_signal_t* signal) {
+    static spectrum_analyzer_t analyzer;
+    double re[SPECTRUM_FFT_SIZE];
+    double im[SPECTRUM_FFT_SIZE];
+    SpectrumAnalyzerInit(&analyzer);
+    for (int n = 0; n < SPECTRUM_FFT_SIZE; ++n) {
+        const int16_t left = TestSpectrumSample(signal->left_hz, signal->left_amplitude, n);
+        const int16_t right = TestSpectrumSample(signal->right_hz, signal->right_amplitude, n);
+        const double window = 0.5 - 0.5 * cos(BENCH_TWO_PI * n / SPECTRUM_FFT_SIZE);
+        re[n] = (double)((left - ADC_IN_MIDPOINT) * 8) * window;
+        im[n] = (double)((right - ADC_IN_MIDPOINT) * 8) * window;
+        SpectrumAnalyzerPush(&analyzer, left, right);
+    }
+    while (!SpectrumAnalyzerRun(&analyzer, 1)) {
+    }
+
+    // Scaled by 1 / N like the fixed-point stages.
+    double z_re[SPECTRUM_FFT_SIZE];
+    double z_im[SPECTRUM_FFT_SIZE];
+    const spectrum_complex_t* z = analyzer.buffer[analyzer.capture ^ 1];
+    double signal_power = 0.0;
+    double error_power = 0.0;
+    for (int k = 0; k < SPECTRUM_FFT_SIZE; ++k) {
+        z_re[k] = 0.0;
+        z_im[k] = 0.0;
+        for (int n = 0; n < SPECTRUM_FFT_SIZE; ++n) {
+            const double angle = BENCH_TWO_PI * (double)((k * n) % SPECTRUM_FFT_SIZE) / SPECTRUM_FFT_SIZE;
+            z_re[k] += re[n] * cos(angle) + im[n] * sin(angle);
+            z_im[k] += im[n] * cos(angle) - re[n] * sin(angle);
+        }
+        z_re[k] /= SPECTRUM_FFT_SIZE;
+        z_im[k] /= SPECTRUM_FFT_SIZE;
+        signal_power += z_re[k] * z_re[k] + z_im[k] * z_im[k];
+        error_power += (z[k].re - z_re[k]) * (z[k].re - z_re[k]) + (z[k].im - z_im[k]) * (z[k].im - z_im[k]);
+    }
+    const double snr = 10.0 * log10(signal_power / (error_power > 1e-12 ? error_power : 1e-12));
+
+    double peak[SPECTRUM_NUM_CHANNELS][SPECTRUM_NUM_BANDS] = {{0.0}};
+    for (int k = 1; k < SPECTRUM_FFT_SIZE / 2; ++k) {
+        const int m = SPECTRUM_FFT_SIZE - k;
+        const double left = 0.5 * hypot(z_re[k] + z_re[m], z_im[k] - z_im[m]);
+        const double right = 0.5 * hypot(z_im[k] + z_im[m], z_re[k] - z_re[m]);
+        int band = 0;
+        while (k >= g_spectrum_band_edges[band + 1]) {
+            ++band;
+        }
+        peak[0][band] = left > peak[0][band] ? left : peak[0][band];
+        peak[1][band] = right > peak[1][band] ? right : peak[1][band];
+    }
+    double worst_db = 0.0;
+    for (int channel = 0; channel < SPECTRUM_NUM_CHANNELS; ++channel) {
+        for (int band = 0; band < SPECTRUM_NUM_BANDS; ++band) {
+            const double expected = TestSpectrumLevel(peak[channel][band]);
+            if (expected * SPECTRUM_RANGE_LOG2 * 6.0206 < TEST_SPECTRUM_MARGIN_DB) {
+                continue;
+            }
+            const double error = fabs(analyzer.level[channel][band] / 32768.0 - expected) * SPECTRUM_RANGE_LOG2 * 6.0206;
+            worst_db = error > worst_db ? error : worst_db;
+        }
+    }
+    const double rms_lsb = sqrt(error_power / SPECTRUM_FFT_SIZE);
+    const bool ok = rms_lsb <= 1.5 && worst_db <= 1.0;
+    printf("  %-14s transform SNR %5.1f dB, error %.2f LSB rms, band levels within %.2f dB  %s\n", signal->name, snr,
+           rms_lsb, worst_db, ok ? "ok" : "FAIL");
+    return ok;
+}
+
+/*
+ * The analyzer against a double-precision reference on tones and noise, then
+ * whether any job overran its capture fed a block at a time the way
+ * AnalyzeAudioBlock() runs it, and a frame at a time, the least a block can
+ * pay for.
+ */
+static bool TestSpectrum(void) {
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(g_spectrum_signals) / sizeof(g_spectrum_signals[0]); ++i) {
+        ok = CheckSpectrumSignal(&g_spectrum_signals[i]) && ok;
+    }
+
+    static int16_t samples[2 * SPECTRUM_FFT_SIZE];
+    for (int i = 0; i < 2 * SPECTRUM_FFT_SIZE; ++i) {
+        samples[i] = BenchRandomAdc();
+    }
+    static spectrum_analyzer_t analyzer;
+    SpectrumAnalyzerInit(&analyzer);
+    for (uint32_t spectrum = 0; spectrum < 100; ++spectrum) {
+        for (int first = 0; first < SPECTRUM_FFT_SIZE; first += ENGINE_MAX_BLOCK) {
+            for (int i = first; i < first + ENGINE_MAX_BLOCK; ++i) {
+                SpectrumAnalyzerPush(&analyzer, samples[2 * i], samples[2 * i + 1]);
+            }
+            SpectrumAnalyzerRun(&analyzer, ENGINE_MAX_BLOCK * SPECTRUM_WORK_PER_POINT);
+        }
+    }
+
+    static spectrum_analyzer_t single;
+    SpectrumAnalyzerInit(&single);
+    for (uint32_t i = 0; i < 100 * SPECTRUM_FFT_SIZE; ++i) {
+        SpectrumAnalyzerPush(&single, samples[2 * (i % SPECTRUM_FFT_SIZE)], samples[2 * (i % SPECTRUM_FFT_SIZE) + 1]);
+        SpectrumAnalyzerRun(&single, SPECTRUM_WORK_PER_POINT);
+    }
+    const bool on_time = analyzer.overruns == 0 && single.overruns == 0;
+    printf("  overruns: %u in %u spectra by block, %u in %u by point  %s\n", analyzer.overruns, analyzer.spectra,
+           single.overruns, single.spectra, on_time ? "ok" : "FAIL");
+    return ok && on_time;
+}
+
+#define TEST_BEAT_WAV_RATE     44100
+#define TEST_BEAT_SECONDS      20.0
+#define TEST_BEAT_START        0.5     // Seconds of silence before the first hit
+#define TEST_BEAT_MATCH        0.1     // Seconds after a hit an onset is put down to it
+#define TEST_BEAT_LOCK_SECONDS 6.0
+#define TEST_BEAT_TEMPO_ERROR  0.02
+#define TEST_BEAT_MAX_ERROR    0.04    // Seconds a beat may land from its kick
+#define TEST_BEAT_MAX_HITS     256
+
+typedef struct testbeatpattern {
+    const char* name;
+    double bpm;                 // Of the kick, 0 for none
+    bool snare;                 // On beats 2 and 4
+    bool hats;                  // On the off-beats
+    double noise_db;            // Steady noise under it, 0 for none
+} test_beat_pattern_t;
+
+static const test_beat_pattern_t g_beat_patterns[] = {
+    {"120 BPM kick, hats", 120.0, false, true, 0.0},
+    {"90 BPM kick, snare, hats", 90.0, true, true, 0.0},
+    {"140 BPM kick in noise", 140.0, false, false, -30.0},
+    {"100 BPM kick", 100.0, false, false, 0.0},
+    {"noise", 0.0, false, false, -20.0},
+    {"silence", 0.0, false, false, 0.0},
+};
+
+static void PutWavLe32(uint8_t* p, const uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        p[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static void PutWavLe16(uint8_t* p, const uint16_t value) {
+    p[0] = (uint8_t)value;
+    p[1] = (uint8_t)(value >> 8);
+}
+
+// Writes mono 16-bit PCM samples as a WAV file.
+static bool WriteWavFile(FILE* output, const int16_t* samples, const size_t count, const uint32_t rate) {
+    uint8_t header[44];
+    memcpy(header, "RIFF", 4);
+    PutWavLe32(header + 4, (uint32_t)(36 + 2 * count));
+    memcpy(header + 8, "WAVEfmt ", 8);
+    PutWavLe32(header + 16, 16);
+    PutWavLe16(header + 20, 1);
+    PutWavLe16(header + 22, 1);
+    PutWavLe32(header + 24, rate);
+    PutWavLe32(header + 28, rate * 2);
+    PutWavLe16(header + 32, 2);
+    PutWavLe16(header + 34, 16);
+    memcpy(header + 36, "data", 4);
+    PutWavLe32(header + 40, (uint32_t)(2 * count));
+    bool ok = fwrite(header, 1, sizeof(header), output) == sizeof(header);
+    for (size_t i = 0; ok && i < count; ++i) {
+        uint8_t sample[2];
+        PutWavLe16(sample, (uint16_t)samples[i]);
+        ok = fwrite(sample, 1, sizeof(sample), output) == sizeof(sample);
+    }
+    return ok;
+}
+
+// Uniform in [-1, 1).
+static double TestNoise(void) {
+    return (double)(BenchRandom() & 0xffffu) / 32768.0 - 1.0;
+}
+
+/*
+ * Renders a pattern at TEST_BEAT_WAV_RATE: a kick sweeping from 150Hz to
+ * 50Hz on every beat, a noise and 180Hz snare on 2 and 4, a short
+ * high-passed noise hat on the off-beats, over steady noise from the
+ * start. Every hit's
+ * time goes into hits, the kicks' into kicks, TEST_BEAT_MAX_HITS at most.
+ * Returns the samples.
+ */
+static int16_t* RenderBeatPattern(const test_beat_pattern_t* pattern, double* hits, size_t* num_hits,
+                                  double* kicks, size_t* num_kicks) {
+    const size_t count = (size_t)(TEST_BEAT_SECONDS * TEST_BEAT_WAV_RATE);
+    double* mix = calloc(count, sizeof(double));
+    int16_t* samples = malloc(count * sizeof(int16_t));
+    if (mix == NULL || samples == NULL) {
+        free(mix);
+        free(samples);
+        return NULL;
+    }
+
+    const double noise = pattern->noise_db < 0.0 ? pow(10.0, pattern->noise_db / 20.0) : 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        mix[i] = noise * TestNoise();
+    }
+    // The noise coming in is a hit of its own.
+    *num_hits = noise > 0.0 ? 1 : 0;
+    hits[0] = 0.0;
+    *num_kicks = 0;
+    const double beat = pattern->bpm > 0.0 ? 60.0 / pattern->bpm : 0.0;
+    for (int k = 0; beat > 0.0 && TEST_BEAT_START + k * beat < TEST_BEAT_SECONDS - 1.0
+                    && *num_hits + 2 <= TEST_BEAT_MAX_HITS; ++k) {
+        const double start = TEST_BEAT_START + k * beat;
+        const size_t first = (size_t)lround(start * TEST_BEAT_WAV_RATE);
+        hits[(*num_hits)++] = start;
+        kicks[(*num_kicks)++] = start;
+        double phase = 0.0;
+        for (size_t i = 0; i < (size_t)(0.4 * TEST_BEAT_WAV_RATE); ++i) {
+            const double t = (double)i / TEST_BEAT_WAV_RATE;
+            phase += BENCH_TWO_PI * (50.0 + 100.0 * exp(-t / 0.03)) / TEST_BEAT_WAV_RATE;
+            mix[first + i] += 0.7 * exp(-t / 0.12) * sin(phase);
+        }
+        if (pattern->snare && k % 2 == 1) {
+            for (size_t i = 0; i < (size_t)(0.2 * TEST_BEAT_WAV_RATE); ++i) {
+                const double t = (double)i / TEST_BEAT_WAV_RATE;
+                mix[first + i] += 0.3 * exp(-t / 0.08) * TestNoise() + 0.2 * exp(-t / 0.05) * sin(BENCH_TWO_PI * 180.0 * t);
+            }
+        }
+        if (pattern->hats) {
+            const double off = start + beat / 2.0;
+            const size_t off_first = (size_t)lround(off * TEST_BEAT_WAV_RATE);
+            hits[(*num_hits)++] = off;
+            double last = 0.0;
+            for (size_t i = 0; i < (size_t)(0.05 * TEST_BEAT_WAV_RATE); ++i) {
+                const double white = TestNoise();
+                mix[off_first + i] += 0.15 * exp(-(double)i / (0.015 * TEST_BEAT_WAV_RATE)) * (white - last);
+                last = white;
+            }
+        }
+    }
+    for (size_t i = 0; i < count; ++i) {
+        const double value = mix[i] * 32767.0;
+        samples[i] = (int16_t)(value > 32767.0 ? 32767 : (value < -32768.0 ? -32768 : lround(value)));
+    }
+    free(mix);
+    return samples;
+}
+
+// Seconds from the latest time in times at or before t, or -1 if there is none within TEST_BEAT_MATCH.
+static double SinceLatest(const double* times, const size_t count, const double t) {
+    double since = -1.0;
+    for (size_t i = 0; i < count; ++i) {
+        if (times[i] <= t && t - times[i] <= TEST_BEAT_MATCH) {
+            since = t - times[i];
+        }
+    }
+    return since;
+}
+
+// Renders a pattern and reads it back through a WAV file, as the engine's audio.
+static bool LoadBeatPattern(const test_beat_pattern_t* pattern, double* hits, size_t* num_hits,
+                            double* kicks, size_t* num_kicks, bench_audio_t* audio) {
+    *audio = (bench_audio_t){0};
+    int16_t* samples = RenderBeatPattern(pattern, hits, num_hits, kicks, num_kicks);
+    if (samples == NULL) {
+        return false;
+    }
+
+    char path[] = "/tmp/photon_beat_XXXXXX";
+    const int fd = mkstemp(path);
+    FILE* file = fd >= 0 ? fdopen(fd, "wb") : NULL;
+    bool written = file != NULL && WriteWavFile(file, samples, (size_t)(TEST_BEAT_SECONDS * TEST_BEAT_WAV_RATE),
+                                                TEST_BEAT_WAV_RATE);
+    if (file != NULL) {
+        written = fclose(file) == 0 && written;
+    } else if (fd >= 0) {
+        close(fd);
+    }
+    free(samples);
+    const bool read = written && ReadWavFile(path, audio);
+    if (fd >= 0) {
+        unlink(path);
+    }
+    return read;
+}
+
+/*
+ * Writes each pattern out as a 44.1kHz WAV file, reads it back and runs it
+ * through the engine. Every kick must be detected, and no onset may fall
+ * where nothing was played. The tempo must come out within 2%, beats lock
+ * within 6s and then land within 40ms of every kick, one colour step each.
+ * Latency is from the start of a hit to the onset flag.
+ */
+static bool CheckBeatPattern(const test_beat_pattern_t* pattern) {
+    double hits[TEST_BEAT_MAX_HITS];
+    double kicks[TEST_BEAT_MAX_HITS];
+    size_t num_hits;
+    size_t num_kicks;
+    bench_audio_t audio;
+    const bool read = LoadBeatPattern(pattern, hits, &num_hits, kicks, &num_kicks, &audio);
+    bench_beats_t beats;
+    if (!read || !TrackBeats(&audio, &beats)) {
+        FreeBenchAudio(&audio);
+        printf("  %-26s cannot write, read or track the WAV file  FAIL\n", pattern->name);
+        return false;
+    }
+    FreeBenchAudio(&audio);
+
+    int false_onsets = 0;
+    double latency_sum = 0.0;
+    double latency_max = 0.0;
+    int kick_onsets = 0;
+    for (size_t i = 0; i < beats.num_onsets; ++i) {
+        const double t = (double)beats.onsets[i] / ADC_SAMPLE_RATE_DEFAULT_HZ;
+        const double since_hit = SinceLatest(hits, num_hits, t);
+        false_onsets += since_hit < 0.0 ? 1 : 0;
+        const double since_kick = SinceLatest(kicks, num_kicks, t);
+        if (since_kick >= 0.0 && since_kick == since_hit) {
+            ++kick_onsets;
+            latency_sum += since_kick;
+            latency_max = since_kick > latency_max ? since_kick : latency_max;
+        }
+    }
+
+    if (pattern->bpm <= 0.0) {
+        const bool pass = false_onsets == 0 && beats.num_beats == 0;
+        printf("  %-26s onsets %zu, beats %zu  %s\n", pattern->name, beats.num_onsets, beats.num_beats,
+               pass ? "ok" : "FAIL");
+        FreeBenchBeats(&beats);
+        return pass;
+    }
+
+    // The beat phase runs on past the last kick, those beats are not scored.
+    const double end = kicks[num_kicks - 1] + 30.0 / pattern->bpm;
+    double error_sum = 0.0;
+    double error_max = 0.0;
+    size_t scored = 0;
+    for (size_t i = 0; i < beats.num_beats && (double)beats.beats[i] / ADC_SAMPLE_RATE_DEFAULT_HZ < end; ++i) {
+        const double t = (double)beats.beats[i] / ADC_SAMPLE_RATE_DEFAULT_HZ;
+        ++scored;
+        double error = INFINITY;
+        for (size_t k = 0; k < num_kicks; ++k) {
+            error = fabs(t - kicks[k]) < fabs(error) ? t - kicks[k] : error;
+        }
+        error_sum += error;
+        error_max = fabs(error) > error_max ? fabs(error) : error_max;
+    }
+    const double lock = beats.num_beats > 0 ? (double)beats.beats[0] / ADC_SAMPLE_RATE_DEFAULT_HZ : INFINITY;
+    size_t expected_beats = 0;
+    for (size_t k = 0; k < num_kicks; ++k) {
+        expected_beats += kicks[k] >= lock - TEST_BEAT_MAX_ERROR ? 1 : 0;
+    }
+    const double tempo_error = fabs(beats.bpm - pattern->bpm) / pattern->bpm;
+    const bool pass = kick_onsets == (int)num_kicks && false_onsets == 0 && tempo_error <= TEST_BEAT_TEMPO_ERROR
+                      && lock <= TEST_BEAT_LOCK_SECONDS && scored == expected_beats
+                      && error_max <= TEST_BEAT_MAX_ERROR && beats.color_steps == beats.num_beats;
+    printf("  %-26s onsets %3d/%-3zu false %d, latency %4.1f ms mean %4.1f max, tempo %6.2f BPM, lock %4.2f s, "
+           "beats %3zu/%-3zu error %+5.1f ms mean %4.1f max  %s\n",
+           pattern->name, kick_onsets, num_kicks, false_onsets, 1e3 * latency_sum / (kick_onsets > 0 ? kick_onsets : 1),
+           1e3 * latency_max, beats.bpm, lock, scored, expected_beats,
+           1e3 * error_sum / (scored > 0 ? (double)scored : 1.0), 1e3 * error_max, pass ? "ok" : "FAIL");
+    FreeBenchBeats(&beats);
+    return pass;
+}
+
+static bool TestBeatTracker(void) {
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(g_beat_patterns) / sizeof(g_beat_patterns[0]); ++i) {
+        ok = CheckBeatPattern(&g_beat_patterns[i]) && ok;
+    }
+    return ok;
+}
+
+/*
+ * A 120 BPM kick played through AppStep() in the spectrum mode, whose
+ * blanked jumps between bars the output stages stretch into more points
+ * than the engine renders. The ADC keeps time with the points written, so
+ * the engine renders fewer blocks than arrive. Every block must still be
+ * analysed once, every capture make a spectrum, and the tempo come out as
+ * in the beat check.
+ */
+static bool TestAppAnalysis(void) {
+    const test_beat_pattern_t* pattern = &g_beat_patterns[0];
+    double hits[TEST_BEAT_MAX_HITS];
+    double kicks[TEST_BEAT_MAX_HITS];
+    size_t num_hits;
+    size_t num_kicks;
+    bench_audio_t audio;
+    FILE* input = tmpfile();
+    bool ok = input != NULL && LoadBeatPattern(pattern, hits, &num_hits, kicks, &num_kicks, &audio);
+    if (!ok) {
+        if (input != NULL) {
+            fclose(input);
+        }
+        FreeBenchAudio(&audio);
+        printf("  cannot write or read the recording  FAIL\n");
+        return false;
+    }
+    const int16_t region = ADC_IN_MAX / ENGINE_NUM_MODES + 1;
+    for (size_t i = 0; i < audio.frames; ++i) {
+        fprintf(input, "%d,%d,%d,%d,%d\n", audio.left[i], audio.right[i], ADC_IN_MAX,
+                (ENGINE_NUM_MODES - 1) * region + region / 2, ADC_IN_MIDPOINT);
+    }
+    rewind(input);
+
+    const posix_platform_config_t config = {input, NULL, 0, {0, 0, 0, 0, 0}};
+    PosixPlatformConfigure(&config);
+    PlatformStart();
+    AppInit();
+    uint64_t steps = 0;
+    while (AppStep()) {
+        ++steps;
+    }
+    fclose(input);
+
+    const engine_audio_analyzer_t* analyzer = PosixPlatformAudioAnalyzer();
+    const uint64_t blocks = PosixPlatformInputBlocks();
+    const uint64_t clock_blocks = PosixPlatformPointCount() / INPUT_BLOCK_FRAMES;
+    const bool analysed = blocks == audio.frames / INPUT_BLOCK_FRAMES && analyzer->frames == blocks * INPUT_BLOCK_FRAMES
+                          && clock_blocks + 1 >= blocks;
+    // The job of the last capture may still be running.
+    const uint32_t captures = analyzer->frames / SPECTRUM_FFT_SIZE;
+    const bool spectra = analyzer->spectrum.spectra + 1 >= captures && analyzer->spectrum.spectra <= captures
+                         && analyzer->spectrum.overruns == 0 && analyzer->features.spectra == analyzer->spectrum.spectra;
+    const bool expanded = steps < blocks;
+    printf("  %-26s %llu blocks analysed of %zu, %llu rendered, %llu by the clock  %s\n", "once per ADC block",
+           (unsigned long long)blocks, audio.frames / INPUT_BLOCK_FRAMES, (unsigned long long)steps,
+           (unsigned long long)clock_blocks, analysed && expanded ? "ok" : "FAIL");
+    printf("  %-26s %u spectra of %u captures, %u overruns  %s\n", "spectrum every capture",
+           analyzer->spectrum.spectra, captures, analyzer->spectrum.overruns, spectra ? "ok" : "FAIL");
+    ok = analysed && expanded && spectra;
+    FreeBenchAudio(&audio);
+
+    const double bpm = 60.0 * ADC_SAMPLE_RATE_DEFAULT_HZ * 256.0 / BeatTrackerPeriodQ8(&analyzer->tracker);
+    const double tempo_error = fabs(bpm - pattern->bpm) / pattern->bpm;
+    size_t expected_beats = 0;
+    for (size_t k = 0; k < num_kicks; ++k) {
+        expected_beats += kicks[k] >= TEST_BEAT_LOCK_SECONDS ? 1 : 0;
+    }
+    const bool tempo = tempo_error <= TEST_BEAT_TEMPO_ERROR && analyzer->features.beats >= expected_beats
+                       && analyzer->features.beats <= num_kicks;
+    printf("  %-26s tempo %6.2f BPM, beats %u, %zu kicks  %s\n", pattern->name, bpm, analyzer->features.beats,
+           num_kicks, tempo ? "ok" : "FAIL");
+    return ok && tempo;
+}
+
+#define TEST_SELECTOR_BLOCKS   20000
+#define TEST_SELECTOR_NOISE    12      // Peak CV noise, counts
+
+static int16_t TestCvNoise(void) {
+    // Triangular, the sum of two uniform draws.
+    return (int16_t)((int)(BenchRandom() % (TEST_SELECTOR_NOISE + 1)) + (int)(BenchRandom() % (TEST_SELECTOR_NOISE + 1))
+                     - TEST_SELECTOR_NOISE);
+}
+
+static void PrimeSelector(mode_selector_t* selector, const int16_t cv) {
+    *selector = (mode_selector_t){
+        .config = {ENGINE_MODE_HYSTERESIS_DEFAULT, ENGINE_MODE_SETTLE_DEFAULT, ENGINE_MODE_DEADBAND_DEFAULT},
+    };
+    UpdateModeSelector(selector, cv);
+}
+
+/*
+ * Noisy middle CV traces through the mode selector, each against the raw
+ * region lookup it replaces: dither on a boundary, a slow noisy sweep,
+ * one-block spikes, a jump, and values outside the ADC range.
+ */
+static bool TestModeSelector(void) {
+    const int16_t region = ADC_IN_MAX / ENGINE_NUM_MODES + 1;
+    mode_selector_t selector;
+
+    // Dither across the boundary between modes 2 and 3.
+    PrimeSelector(&selector, (int16_t)(3 * region - 100));
+    int raw_flips = 0;
+    int raw_mode = GetMode((int16_t)(3 * region - 100));
+    for (int i = 0; i < TEST_SELECTOR_BLOCKS; ++i) {
+        const int16_t cv = (int16_t)(3 * region + TestCvNoise());
+        UpdateModeSelector(&selector, cv);
+        raw_flips += GetMode(cv) != raw_mode ? 1 : 0;
+        raw_mode = GetMode(cv);
+    }
+    const bool dither_ok = selector.switches <= 1;
+    printf("  %-24s raw %5d flips, selector %3u switches  %s\n", "boundary dither", raw_flips, selector.switches,
+           dither_ok ? "ok" : "FAIL");
+
+    // Sweep the whole range, each switch must land within hysteresis and settling of its boundary.
+    PrimeSelector(&selector, 0);
+    raw_flips = 0;
+    raw_mode = 0;
+    int worst_lag = 0;
+    bool in_order = true;
+    for (int i = 0; i < TEST_SELECTOR_BLOCKS; ++i) {
+        const int32_t clean = (int32_t)i * ADC_IN_MAX / (TEST_SELECTOR_BLOCKS - 1);
+        const int32_t noisy = clean + TestCvNoise();
+        const int16_t cv = (int16_t)(noisy < 0 ? 0 : (noisy > ADC_IN_MAX ? ADC_IN_MAX : noisy));
+        const int before = selector.mode;
+        UpdateModeSelector(&selector, cv);
+        raw_flips += GetMode(cv) != raw_mode ? 1 : 0;
+        raw_mode = GetMode(cv);
+        if (selector.mode != before) {
+            in_order = in_order && selector.mode == before + 1;
+            const int lag = (int)clean - selector.mode * region;
+            worst_lag = lag > worst_lag ? lag : worst_lag;
+        }
+    }
+    const int max_lag = ENGINE_MODE_HYSTERESIS_DEFAULT + TEST_SELECTOR_NOISE
+                        + (ENGINE_MODE_SETTLE_DEFAULT + 1) * ADC_IN_MAX / TEST_SELECTOR_BLOCKS + 1;
+    const bool sweep_ok = selector.switches == ENGINE_NUM_MODES - 1 && in_order && worst_lag <= max_lag;
+    printf("  %-24s raw %5d flips, selector %3u switches, lag <= %d counts (max %d)  %s\n", "noisy sweep", raw_flips,
+           selector.switches, worst_lag, max_lag, sweep_ok ? "ok" : "FAIL");
+
+    // Parked mid-region with one-block spikes anywhere.
+    PrimeSelector(&selector, (int16_t)(2 * region + region / 2));
+    for (int i = 0; i < TEST_SELECTOR_BLOCKS; ++i) {
+        const bool spike = i % 50 == 0;
+        UpdateModeSelector(&selector, spike ? (int16_t)(BenchRandom() % (ADC_IN_MAX + 1))
+                                            : (int16_t)(2 * region + region / 2 + TestCvNoise()));
+    }
+    const bool spikes_ok = selector.switches == 0 && selector.mode == 2;
+    printf("  %-24s selector %3u switches  %s\n", "one-block spikes", selector.switches, spikes_ok ? "ok" : "FAIL");
+
+    // A static scene is framed in the mode the selector holds, a spike two regions away does not end it.
+    static engine_context_t context;
+    InitEngine(&context);
+    PrimeSelector(&context.mode_selector, (int16_t)(5 * region + region / 2));
+    const engine_inputs_t spike = {
+        0, 0, ADC_IN_MIDPOINT, (int16_t)(7 * region + region / 2), ADC_IN_MIDPOINT
+    };
+    engine_frame_t frame;
+    const bool framed = GetEngineFrame(&context, &spike, &frame) && frame.mode == 5;
+    printf("  %-24s %s\n", "frames follow selector", framed ? "ok" : "FAIL");
+
+    // A clean jump from mode 1 to mode 6 is taken after exactly settle_blocks calls.
+    PrimeSelector(&selector, (int16_t)(region + region / 2));
+    int calls = 0;
+    while (selector.mode == 1 && calls < 100) {
+        UpdateModeSelector(&selector, (int16_t)(6 * region + region / 2));
+        ++calls;
+    }
+    const bool jump_ok = selector.mode == 6 && calls == ENGINE_MODE_SETTLE_DEFAULT;
+    printf("  %-24s mode %d after %d calls  %s\n", "jump", selector.mode, calls, jump_ok ? "ok" : "FAIL");
+
+    // Out of range clamps to the end modes instead of hanging.
+    static const int16_t out_of_range[] = {INT16_MIN, -3000, -1, ADC_IN_MAX + 1, 5000, INT16_MAX};
+    bool clamped = true;
+    for (size_t i = 0; i < sizeof(out_of_range) / sizeof(out_of_range[0]); ++i) {
+        const int expected = out_of_range[i] < 0 ? 0 : ENGINE_NUM_MODES - 1;
+        PrimeSelector(&selector, out_of_range[i]);
+        clamped = clamped && GetMode(out_of_range[i]) == expected && selector.mode == expected;
+    }
+    printf("  %-24s %s\n", "out of range clamps", clamped ? "ok" : "FAIL");
+    return dither_ok && sweep_ok && spikes_ok && framed && jump_ok && clamped;
+}
+
+/*
+ * Which blocks go through blanking, dwell and slew: every mode but the audio
+ * XY ones on its own, and any crossfade that mixes in a mode that wants them.
+ */
+static bool TestOutputStages(void) {
+    static engine_context_t context;
+    static engine_inputs_t inputs[ENGINE_MAX_BLOCK];
+    static engine_output_block_t block;
+
+    const int16_t region = ADC_IN_MAX / ENGINE_NUM_MODES + 1;
+    bool all = true;
+    for (int mode = 0; mode < ENGINE_NUM_MODES; ++mode) {
+        const int16_t cv = (int16_t)(mode * region + region / 2);
+        InitEngine(&context);
+        PrimeSelector(&context.mode_selector, cv);
+        for (int i = 0; i < ENGINE_MAX_BLOCK; ++i) {
+            inputs[i] = (engine_inputs_t){
+                BenchRandomAdc(), BenchRandomAdc(), ADC_IN_MIDPOINT, cv, ADC_IN_MIDPOINT
+            };
+        }
+        RunEngineBlock(&context, inputs, &g_test_silence, &block, ENGINE_MAX_BLOCK);
+        const bool expected = mode != 0 && mode != 1;
+        const bool ok = context.output_stages == expected;
+        printf("  mode %d %-22s %s\n", mode, expected ? "through the stages" : "straight out", ok ? "ok" : "FAIL");
+        all = all && ok;
+    }
+
+    // Just below the boundary between modes 1 and 2 both render, the spinning coin wants the stages.
+    const int16_t boundary = (int16_t)(2 * region - 1);
+    InitEngine(&context);
+    PrimeSelector(&context.mode_selector, boundary);
+    for (int i = 0; i < ENGINE_MAX_BLOCK; ++i) {
+        inputs[i].cv_in_middle = boundary;
+    }
+    const bool crossfaded = RunEngineBlock(&context, inputs, &g_test_silence, &block, ENGINE_MAX_BLOCK);
+    const bool mixed = crossfaded && context.output_stages;
+    printf("  %-29s %s\n", "audio and coin crossfade", mixed ? "ok" : "FAIL");
+    return all && mixed;
+}
+
+typedef struct testdwellpoint {
+    int16_t x;
+    int16_t y;
+    bool lit;
+} test_dwell_point_t;
+
+typedef struct testdwellcase {
+    const char* name;
+    const test_dwell_point_t* input;
+    int num_input;
+    const test_dwell_point_t* expected;
+    int num_expected;
+} test_dwell_case_t;
+
+// Lit square corner: pre-blank at the start, a dwell at the 90 degree turn. The last point waits for its successor.
+static const test_dwell_point_t g_dwell_corner_in[] = {
+    {0, 0, true}, {50, 0, true}, {100, 0, true}, {100, 50, true}, {100, 100, true}, {100, 150, true}
+};
+static const test_dwell_point_t g_dwell_corner_out[] = {
+    {0, 0, false}, {0, 0, false}, {0, 0, true}, {50, 0, true},
+    {100, 0, true}, {100, 0, true}, {100, 0, true}, {100, 0, true}, {100, 50, true}, {100, 100, true}
+};
+// Blanked move between two lit strokes: post-blank before it, pre-blank after it.
+static const test_dwell_point_t g_dwell_blank_in[] = {
+    {0, 0, true}, {10, 0, true}, {500, 500, false}, {1000, 0, true}, {1010, 0, true}, {1020, 0, true}
+};
+static const test_dwell_point_t g_dwell_blank_out[] = {
+    {0, 0, false}, {0, 0, false}, {0, 0, true}, {10, 0, true}, {10, 0, false}, {10, 0, false},
+    {500, 500, false}, {1000, 0, false}, {1000, 0, false}, {1000, 0, true}, {1010, 0, true}
+};
+// A shallow 45 degree turn is below the corner angle and passes through.
+static const test_dwell_point_t g_dwell_shallow_in[] = {
+    {0, 0, false}, {0, 0, true}, {100, 0, true}, {200, 100, true}, {300, 200, true}
+};
+static const test_dwell_point_t g_dwell_shallow_out[] = {
+    {0, 0, false}, {0, 0, false}, {0, 0, false}, {0, 0, true}, {100, 0, true}, {200, 100, true}
+};
+
+#define TEST_DWELL_CASE(name, in, out) \
+    {name, in, sizeof(in) / sizeof(in[0]), out, sizeof(out) / sizeof(out[0])}
+
+static const test_dwell_case_t g_dwell_cases[] = {
+    TEST_DWELL_CASE("corner", g_dwell_corner_in, g_dwell_corner_out),
+    TEST_DWELL_CASE("blanked move", g_dwell_blank_in, g_dwell_blank_out),
+    TEST_DWELL_CASE("shallow turn", g_dwell_shallow_in, g_dwell_shallow_out),
+};
+
+/*
+ * Runs a case through a fresh stage, collecting out_size points per call so
+ * queued points have to carry over between output blocks.
+ */
+static bool CheckBlankDwellCase(const test_dwell_case_t* test, const int out_size) {
+    const blank_dwell_config_t config = {
+        true, BLANK_DWELL_DEFAULT_PRE, BLANK_DWELL_DEFAULT_POST, BLANK_DWELL_DEFAULT_DWELL, BLANK_DWELL_DEFAULT_CORNER
+    };
+    static engine_output_block_t in;
+    static engine_output_block_t out;
+    blank_dwell_t stage;
+    BlankDwellInit(&stage, &config);
+
+    for (int i = 0; i < test->num_input; ++i) {
+        const int16_t level = test->input[i].lit ? LASER_PWM_MAX : 0;
+        in.x[i] = test->input[i].x;
+        in.y[i] = test->input[i].y;
+        in.r[i] = level;
+        in.g[i] = 0;
+        in.b[i] = level;
+    }
+
+    int produced = 0;
+    int consumed = 0;
+    bool ok = true;
+    for (;;) {
+        int count = 0;
+        consumed += BlankDwellBlock(&stage, &in, consumed, test->num_input, &out, &count, out_size);
+        if (count == 0) {
+            break;
+        }
+        for (int i = 0; i < count; ++i, ++produced) {
+            const test_dwell_point_t* expected = &test->expected[produced];
+            const bool lit = (out.r[i] | out.g[i] | out.b[i]) != 0;
+            ok = ok && produced < test->num_expected && out.x[i] == expected->x && out.y[i] == expected->y
+                    && lit == expected->lit;
+        }
+    }
+    return ok && produced == test->num_expected;
+}
+
+#define TEST_DWELL_RANDOM_POINTS  20000
+#define TEST_DWELL_RANGE          12000   // Either side of 0, three times the DAC range
+#define TEST_DWELL_COS_MARGIN     1e-3    // Turns this close to the corner angle may go either way
+
+static inline int16_t TestClampPosition(const int32_t value) {
+    return (int16_t)(value < 0 ? 0 : value > LASER_POS_MAX ? LASER_POS_MAX : value);
+}
+
+// Whether previous -> current -> next turns past the corner angle, in double, with margin either way.
+static void CountDwellCorner(const int16_t* previous, const int16_t* current, const int16_t* next, int* surely,
+                             int* maybe) {
+    const double ax = current[0] - previous[0];
+    const double ay = current[1] - previous[1];
+    const double bx = next[0] - current[0];
+    const double by = next[1] - current[1];
+    const double lengths = sqrt((ax * ax + ay * ay) * (bx * bx + by * by));
+    if (lengths == 0.0) {
+        return;
+    }
+    const double turn_cos = (ax * bx + ay * by) / lengths;
+    const double corner_cos = (double)BLANK_DWELL_DEFAULT_CORNER / Q15_ONE;
+    *surely += turn_cos < corner_cos - TEST_DWELL_COS_MARGIN ? 1 : 0;
+    *maybe += turn_cos < corner_cos + TEST_DWELL_COS_MARGIN ? 1 : 0;
+}
+
+/*
+ * A lit random path far outside the DAC range, as a mode's unclamped output
+ * can be. Every point must come out in range and the corners be those of
+ * the clamped path, found in double.
+ */
+static bool CheckBlankDwellRange(void) {
+    const blank_dwell_config_t config = {
+        true, BLANK_DWELL_DEFAULT_PRE, BLANK_DWELL_DEFAULT_POST, BLANK_DWELL_DEFAULT_DWELL, BLANK_DWELL_DEFAULT_CORNER
+    };
+    static engine_output_block_t in;
+    static engine_output_block_t out;
+    blank_dwell_t stage;
+    BlankDwellInit(&stage, &config);
+
+    int surely = 0;
+    int maybe = 0;
+    int produced = 0;
+    bool in_range = true;
+    bool have_previous = false;
+    int16_t previous[2] = {0, 0};
+    int16_t current[2] = {0, 0};
+    for (int first = 0; first < TEST_DWELL_RANDOM_POINTS; first += ENGINE_MAX_BLOCK) {
+        for (int i = 0; i < ENGINE_MAX_BLOCK; ++i) {
+            in.x[i] = (int16_t)((int)(BenchRandom() % (2 * TEST_DWELL_RANGE + 1)) - TEST_DWELL_RANGE);
+            in.y[i] = (int16_t)((int)(BenchRandom() % (2 * TEST_DWELL_RANGE + 1)) - TEST_DWELL_RANGE);
+            in.r[i] = LASER_PWM_MAX;
+            in.g[i] = LASER_PWM_MAX;
+            in.b[i] = LASER_PWM_MAX;
+            // The stage's window: the last position that moved, the point waiting, and this one.
+            const int16_t next[2] = {TestClampPosition(in.x[i]), TestClampPosition(in.y[i])};
+            if (first + i > 0) {
+                if (have_previous) {
+                    CountDwellCorner(previous, current, next, &surely, &maybe);
+                }
+                if (!have_previous || previous[0] != current[0] || previous[1] != current[1]) {
+                    previous[0] = current[0];
+                    previous[1] = current[1];
+                    have_previous = true;
+                }
+            }
+            current[0] = next[0];
+            current[1] = next[1];
+        }
+        int consumed = 0;
+        while (consumed < ENGINE_MAX_BLOCK) {
+            int count = 0;
+            consumed += BlankDwellBlock(&stage, &in, consumed, ENGINE_MAX_BLOCK, &out, &count, ENGINE_MAX_BLOCK);
+            for (int i = 0; i < count; ++i) {
+                in_range = in_range && out.x[i] >= 0 && out.x[i] <= LASER_POS_MAX && out.y[i] >= 0
+                           && out.y[i] <= LASER_POS_MAX;
+            }
+            produced += count;
+        }
+    }
+    // All lit: the first point gets its pre-blank, the last waits for a successor.
+    const int dwells = produced - (TEST_DWELL_RANDOM_POINTS - 1) - BLANK_DWELL_DEFAULT_PRE;
+    const int corners = dwells / BLANK_DWELL_DEFAULT_DWELL;
+    const bool ok = in_range && dwells % BLANK_DWELL_DEFAULT_DWELL == 0 && corners >= surely && corners <= maybe;
+    printf("  %-28s %d corners, %d..%d in double  %s\n", "out of range path", corners, surely, maybe,
+           ok ? "ok" : "FAIL");
+    return ok;
+}
+
+/*
+ * Checks the inserted points on scripted paths, collected in output blocks of
+ * several sizes, then a path far outside the DAC range.
+ */
+static bool TestBlankDwell(void) {
+    static const int out_sizes[] = {1, 3, ENGINE_MAX_BLOCK};
+    bool all = true;
+    for (size_t c = 0; c < sizeof(g_dwell_cases) / sizeof(g_dwell_cases[0]); ++c) {
+        bool ok = true;
+        for (size_t s = 0; s < sizeof(out_sizes) / sizeof(out_sizes[0]); ++s) {
+            ok = ok && CheckBlankDwellCase(&g_dwell_cases[c], out_sizes[s]);
+        }
+        printf("  %-28s %s\n", g_dwell_cases[c].name, ok ? "ok" : "FAIL");
+        all = all && ok;
+    }
+    return CheckBlankDwellRange() && all;
+}
+
+// Rendering a held scene's loop leaves the state the rectangle streams from alone.
+static bool CheckFrameRenderScratch(void) {
+    static engine_context_t context;
+    static engine_inputs_t inputs[ENGINE_MAX_BLOCK];
+    static engine_output_block_t block;
+
+    InitEngine(&context);
+    const int16_t region = ADC_IN_MAX / ENGINE_NUM_MODES + 1;
+    for (int i = 0; i < ENGINE_MAX_BLOCK; ++i) {
+        inputs[i] = (engine_inputs_t){
+            0, 0, ADC_IN_MIDPOINT, (int16_t)(5 * region + region / 2), ADC_IN_MIDPOINT
+        };
+    }
+    for (int n = 0; n < 3; ++n) {
+        RunEngineBlock(&context, inputs, &g_test_silence, &block, ENGINE_MAX_BLOCK);
+    }
+    const mode_state_rectangle_t streamed = context.rectangle;
+    engine_frame_t frame;
+    if (!GetEngineFrame(&context, &inputs[0], &frame)) {
+        return false;
+    }
+    for (int first = 0; first < frame.points; first += ENGINE_MAX_BLOCK) {
+        const int n = frame.points - first < ENGINE_MAX_BLOCK ? frame.points - first : ENGINE_MAX_BLOCK;
+        RenderEngineFrame(&context, &frame, &block, first, n);
+    }
+    return memcmp(&streamed, &context.rectangle, sizeof(streamed)) == 0;
+}
+
+/*
+ * Random frames of short strokes at random places: 2-opt must never lengthen
+ * the nearest neighbour chain. Then a held scene's loop rendered next to the
+ * stream it came from.
+ */
+static bool TestFrameOptimizer(void) {
+    static frame_points_t points;
+    static frame_optimizer_t opt;
+    const int segments = FRAME_OPT_MAX_SEGMENTS;
+    const int stroke = ENGINE_FRAME_MAX_POINTS / segments - 1;
+    bool shorter = true;
+    for (int t = 0; t < 200; ++t) {
+        points.n = 0;
+        for (int s = 0; s < segments; ++s) {
+            const int16_t x = (int16_t)(BenchRandom() % (LASER_POS_MAX - 200));
+            const int16_t y = (int16_t)(BenchRandom() % (LASER_POS_MAX - 200));
+            for (int k = 0; k <= stroke; ++k) {
+                const int i = points.n++;
+                const bool lit = k > 0;
+                points.x[i] = (int16_t)(x + k * 200 / stroke);
+                points.y[i] = y;
+                points.r[i] = lit ? LASER_PWM_MAX : 0;
+                points.g[i] = 0;
+                points.b[i] = lit ? LASER_PWM_MAX : 0;
+            }
+        }
+        FrameOptimizerStart(&opt, &points);
+        while (!FrameOptimizerStep(&opt, FRAME_OPT_STEP_BUDGET)) {
+        }
+        shorter = shorter && opt.travel_after <= opt.travel_nearest;
+    }
+    printf("  %-30s %s\n", "2-opt never lengthens", shorter ? "ok" : "FAIL");
+    const bool scratch = CheckFrameRenderScratch();
+    printf("  %-30s %s\n", "frame render leaves stream", scratch ? "ok" : "FAIL");
+    return shorter && scratch;
+}
+
+#define TEST_ILDA_FRAMES   3
+#define TEST_ILDA_POINTS   50
+
+// Writes a big-endian ILDA section header, returns the bytes written.
+static size_t PutIldaHeader(uint8_t* out, const uint8_t format, const uint16_t records, const uint16_t frame) {
+    memset(out, 0, ILDA_HEADER_SIZE);
+    memcpy(out, "ILDA", 4);
+    out[7] = format;
+    out[24] = (uint8_t)(records >> 8);
+    out[25] = (uint8_t)records;
+    out[26] = (uint8_t)(frame >> 8);
+    out[27] = (uint8_t)frame;
+    out[29] = TEST_ILDA_FRAMES;
+    return ILDA_HEADER_SIZE;
+}
+
+// Reference point k of frame f, full-scale ILDA coordinates.
+static int16_t TestIldaX(const int f, const int k) {
+    return (int16_t)(-32768 + k * 1311 + f * 7);
+}
+
+static int16_t TestIldaY(const int f, const int k) {
+    return (int16_t)(32767 - k * 1311 - f * 5);
+}
+
+/*
+ * Builds a file of TEST_ILDA_FRAMES frames in one format, led by a palette
+ * section the reader has to skip. Every third point is blanked, colours are
+ * palette index 0 (red) or 40 (blue), or the same as true colour.
+ */
+static size_t BuildIldaFile(uint8_t* out, const uint8_t format) {
+    static const uint8_t record_sizes[6] = {8, 6, 3, 0, 10, 8};
+    const int size = record_sizes[format];
+    const bool is_3d = format == 0 || format == 4;
+    size_t at = PutIldaHeader(out, 2, 2, 0);
+    memset(&out[at], 0x80, 6);
+    at += 6;
+
+    for (int f = 0; f < TEST_ILDA_FRAMES; ++f) {
+        at += PutIldaHeader(&out[at], format, TEST_ILDA_POINTS, (uint16_t)f);
+        for (int k = 0; k < TEST_ILDA_POINTS; ++k) {
+            uint8_t* record = &out[at];
+            const uint16_t x = (uint16_t)TestIldaX(f, k);
+            const uint16_t y = (uint16_t)TestIldaY(f, k);
+            const bool blue = (k & 1) != 0;
+            record[0] = (uint8_t)(x >> 8);
+            record[1] = (uint8_t)x;
+            record[2] = (uint8_t)(y >> 8);
+            record[3] = (uint8_t)y;
+            uint8_t* status = &record[is_3d ? 6 : 4];
+            status[0] = (uint8_t)((k % 3 == 0 ? 0x40 : 0) | (k == TEST_ILDA_POINTS - 1 ? 0x80 : 0));
+            if (format <= 1) {
+                status[1] = blue ? 40 : 0;
+            } else {
+                status[1] = blue ? 255 : 0;     // B
+                status[2] = 0;                  // G
+                status[3] = blue ? 0 : 255;     // R
+            }
+            at += (size_t)size;
+        }
+    }
+    return at + PutIldaHeader(&out[at], format, 0, 0);
+}
+
+// Decodes a reference file and checks every point against what was written.
+static bool CheckIldaFormat(const uint8_t format) {
+    static uint8_t blob[ILDA_HEADER_SIZE * (TEST_ILDA_FRAMES + 2) + 6 + TEST_ILDA_FRAMES * TEST_ILDA_POINTS * 10];
+    const size_t size = BuildIldaFile(blob, format);
+    ilda_file_t file;
+    if (!IldaOpen(&file, blob, size) || file.num_frames != TEST_ILDA_FRAMES) {
+        return false;
+    }
+
+    ilda_cursor_t cursor = {0};
+    bool ok = true;
+    for (int f = 0; f < TEST_ILDA_FRAMES; ++f) {
+        IldaSeekFrame(&file, &cursor, (uint16_t)f);
+        ilda_point_t point;
+        int k = 0;
+        for (; IldaNextPoint(&file, &cursor, &point); ++k) {
+            const bool blanked = k % 3 == 0;
+            const bool blue = (k & 1) != 0;
+            ok = ok && point.x == (TestIldaX(f, k) + 32768) >> 4 && point.y == (TestIldaY(f, k) + 32768) >> 4;
+            ok = ok && point.blanked == blanked && point.last == (k == TEST_ILDA_POINTS - 1);
+            ok = ok && point.r == (blanked || blue ? 0 : LASER_PWM_MAX) && point.g == 0
+                    && point.b == (blanked || !blue ? 0 : LASER_PWM_MAX);
+        }
+        ok = ok && k == TEST_ILDA_POINTS;
+    }
+    // Backwards seeks restart from the first frame.
+    IldaSeekFrame(&file, &cursor, 0);
+    ilda_point_t first;
+    return ok && IldaNextPoint(&file, &cursor, &first) && first.x == 0 && first.y == (32767 + 32768) >> 4;
+}
+
+// Round trip of formats 0, 1, 4 and 5 through the reader.
+static bool TestIlda(void) {
+    static const uint8_t formats[] = {0, 1, 4, 5};
+    bool all = true;
+    for (size_t i = 0; i < sizeof(formats) / sizeof(formats[0]); ++i) {
+        const bool ok = CheckIldaFormat(formats[i]);
+        printf("  format %u %-19s %s\n", formats[i], "points and coords", ok ? "ok" : "FAIL");
+        all = all && ok;
+    }
+    return all;
+}
+
+// The ILDA mode on the built-in show and on its compact encoding, point for point.
+static bool CheckCompactIldaMode(const uint8_t* blob, const size_t size) {
+    static engine_context_t ilda;
+    static engine_context_t compact;
+    static engine_inputs_t inputs[ENGINE_MAX_BLOCK];
+    static engine_output_block_t expected;
+    static engine_output_block_t block;
+
+    InitEngine(&ilda);
+    InitEngine(&compact);
+    if (!SetEngineIldaShow(&compact, blob, size) || !compact.ilda.compact) {
+        return false;
+    }
+    const int16_t region = ADC_IN_MAX / ENGINE_NUM_MODES + 1;
+    for (int i = 0; i < ENGINE_MAX_BLOCK; ++i) {
+        inputs[i] = (engine_inputs_t){
+            0, 0, ADC_IN_MIDPOINT, (int16_t)(7 * region + region * 3 / 4), ADC_IN_MIDPOINT
+        };
+    }
+    bool ok = true;
+    for (int n = 0; n < TEST_BLOCKS_PER_CV && ok; ++n) {
+        RunEngineBlock(&ilda, inputs, &g_test_silence, &expected, ENGINE_MAX_BLOCK);
+        RunEngineBlock(&compact, inputs, &g_test_silence, &block, ENGINE_MAX_BLOCK);
+        ok = memcmp(expected.x, block.x, sizeof(block.x)) == 0 && memcmp(expected.y, block.y, sizeof(block.y)) == 0
+             && memcmp(expected.r, block.r, sizeof(block.r)) == 0 && memcmp(expected.g, block.g, sizeof(block.g)) == 0
+             && memcmp(expected.b, block.b, sizeof(block.b)) == 0;
+    }
+    return ok;
+}
+
+// The middle CV at the bottom of the ILDA region holds the selected frame.
+static bool CheckIldaModePaused(void) {
+    static engine_context_t context;
+    static engine_inputs_t inputs[ENGINE_MAX_BLOCK];
+    static engine_output_block_t block;
+
+    InitEngine(&context);
+    const int16_t region = ADC_IN_MAX / ENGINE_NUM_MODES + 1;
+    for (int i = 0; i < ENGINE_MAX_BLOCK; ++i) {
+        inputs[i] = (engine_inputs_t){
+            0, 0, ADC_IN_MIDPOINT, (int16_t)(7 * region), ADC_IN_MIDPOINT
+        };
+    }
+    for (int n = 0; n < TEST_BLOCKS_PER_CV; ++n) {
+        RunEngineBlock(&context, inputs, &g_test_silence, &block, ENGINE_MAX_BLOCK);
+    }
+    return context.ilda.step == 0 && context.ilda.step_phase == 0;
+}
+
+/*
+ * Round trip of the built-in show and of a random walk with long jumps and
+ * out of range points, malformed blobs rejected, and the ILDA mode playing
+ * the compact show like the ILDA one.
+ */
+static bool TestCompactShow(void) {
+    bench_show_t show;
+    uint8_t* blob = NULL;
+    if (!LoadIldaShow(&show, g_ilda_default_show, g_ilda_default_show_size)) {
+        printf("  built-in show                  FAIL\n");
+        return false;
+    }
+    size_t size = EncodeBenchShow(&show, &blob);
+    const bool built_in = size > 0 && CheckCompactShow(&show, blob, size);
+    printf("  %-30s %s\n", "built-in show round trip", built_in ? "ok" : "FAIL");
+
+    compact_show_t compact;
+    bool rejected = true;
+    for (size_t cut = 0; cut < size && rejected; ++cut) {
+        rejected = !CompactShowOpen(&compact, blob, cut);
+    }
+    printf("  %-30s %s\n", "truncated blobs rejected", rejected ? "ok" : "FAIL");
+    static const uint8_t empty_frame[] = {'P', 'H', 'C', 'S', COMPACT_SHOW_VERSION, 0, 1, 0, 12, 0, 0, 0, 0};
+    const bool empty = !CompactShowOpen(&compact, empty_frame, sizeof(empty_frame));
+    printf("  %-30s %s\n", "empty frame rejected", empty ? "ok" : "FAIL");
+    const bool same = CheckCompactIldaMode(blob, size);
+    printf("  %-30s %s\n", "ILDA mode plays it the same", same ? "ok" : "FAIL");
+    const bool paused = CheckIldaModePaused();
+    printf("  %-30s %s\n", "ILDA mode pauses", paused ? "ok" : "FAIL");
+    FreeBenchShow(&show);
+    free(blob);
+
+    const bool built = BuildRandomWalkShow(&show);
+    size = built ? EncodeBenchShow(&show, &blob) : 0;
+    const bool walk = size > 0 && CheckCompactShow(&show, blob, size);
+    printf("  %-30s %s\n", "random walk round trip", walk ? "ok" : "FAIL");
+    FreeBenchShow(&show);
+    free(blob);
+    return built_in && rejected && empty && same && paused && walk;
+}
+
+#define TEST_RING_POINTS   (1u << 21)
+#define TEST_RING_PAUSE    4096u   // Points between the pauses that force the ring full and empty
+static const struct timespec g_ring_pause = {0, 200000};   // Ample for the other side to fill or drain the ring
+
+/*
+ * One side of the ring stress. The producer pushes points numbered in order,
+ * in blocks of 1..ENGINE_MAX_BLOCK, and the consumer pops them. Each counts
+ * the calls the ring turned down, which it has to count the same.
+ */
+typedef struct testringside {
+    point_ring_t* ring;
+    uint32_t refused;
+    uint32_t errors;    // Consumer: points out of sequence or torn
+} test_ring_side_t;
+
+// The number in the low half and its complement in the high, a torn read breaks the pair.
+static packed_point_t RingTestPoint(const uint32_t seq) {
+    return (packed_point_t)seq | ((packed_point_t)~seq << 32);
+}
+
+static void* RingProducer(void* arg) {
+    test_ring_side_t* side = arg;
+    packed_point_t block[ENGINE_MAX_BLOCK];
+    uint32_t seq = 0;
+    uint32_t n = 1;
+    while (seq < TEST_RING_POINTS) {
+        n = n % ENGINE_MAX_BLOCK + 1;
+        n = n < TEST_RING_POINTS - seq ? n : TEST_RING_POINTS - seq;
+        for (uint32_t i = 0; i < n; ++i) {
+            block[i] = RingTestPoint(seq + i);
+        }
+        const bool pushed = n == 1 ? PointRingPush(side->ring, block[0]) : PointRingPushBlock(side->ring, block, n);
+        if (!pushed) {
+            ++side->refused;
+            sched_yield();
+            continue;
+        }
+        if (seq / TEST_RING_PAUSE != (seq + n) / TEST_RING_PAUSE) {
+            nanosleep(&g_ring_pause, NULL);
+        }
+        seq += n;
+    }
+    return NULL;
+}
+
+static void* RingConsumer(void* arg) {
+    test_ring_side_t* side = arg;
+    uint32_t seq = 0;
+    while (seq < TEST_RING_POINTS) {
+        packed_point_t point;
+        if (!PointRingPop(side->ring, &point)) {
+            ++side->refused;
+            sched_yield();
+            continue;
+        }
+        if (point != RingTestPoint(seq)) {
+            ++side->errors;
+        }
+        if (++seq % TEST_RING_PAUSE == TEST_RING_PAUSE / 2) {
+            nanosleep(&g_ring_pause, NULL);
+        }
+    }
+    return NULL;
+}
+
+/*
+ * The point ring between two threads, the engine and output ISR sides. Both
+ * pause in turn so the ring runs full and empty. Passes if every point comes
+ * out once and in order, each refused call is counted as an overrun or an
+ * underrun, and both actually happened.
+ */
+static bool TestPointRing(void) {
+    static point_ring_t ring;
+    PointRingInit(&ring);
+    test_ring_side_t producer = {&ring, 0, 0};
+    test_ring_side_t consumer = {&ring, 0, 0};
+    pthread_t producer_thread;
+    pthread_t consumer_thread;
+    if (pthread_create(&consumer_thread, NULL, RingConsumer, &consumer) != 0) {
+        return false;
+    }
+    if (pthread_create(&producer_thread, NULL, RingProducer, &producer) != 0) {
+        pthread_detach(consumer_thread);        // Waits for points that never come
+        return false;
+    }
+    pthread_join(producer_thread, NULL);
+    pthread_join(consumer_thread, NULL);
+
+    const bool sequence = consumer.errors == 0 && PointRingCount(&ring) == 0;
+    const bool overruns = ring.overruns == producer.refused && producer.refused > 0;
+    const bool underruns = ring.underruns == consumer.refused && consumer.refused > 0;
+    printf("  %-30s %s\n", "sequence", sequence ? "ok" : "FAIL");
+    printf("  %-30s %s\n", "overruns counted", overruns ? "ok" : "FAIL");
+    printf("  %-30s %s\n", "underruns counted", underruns ? "ok" : "FAIL");
+    printf("  points %u, out of sequence %u, overruns %u/%u, underruns %u/%u\n", TEST_RING_POINTS,
+           consumer.errors, ring.overruns, producer.refused, ring.underruns, consumer.refused);
+    return sequence && overruns && underruns;
+}
+
+#define TEST_DAC_WIRE_EVENTS   8       // Two words and a latch per point, with room to spare
+#define TEST_DAC_RANDOM_POINTS 100000
+#define TEST_DAC_LATCH         0x10000u
+
+/*
+ * The pins the MCP4822 sees, decoded the way it reads them: SDI sampled on
+ * SCK rising edges while CS is low, a command word taken on CS rising and both
+ * channels put out on LDAC falling. Events are the words, TEST_DAC_LATCH for
+ * the latch and anything else for a frame that was not 16 bits.
+ */
+typedef struct testdacwire {
+    bool cs;
+    bool sck;
+    bool sdi;
+    bool ldac;
+    uint32_t shift;
+    int bits;
+    uint32_t events[TEST_DAC_WIRE_EVENTS];
+    int num_events;
+} test_dac_wire_t;
+
+static void ResetDacWire(test_dac_wire_t* wire) {
+    *wire = (test_dac_wire_t){.cs = true, .ldac = true};
+}
+
+static void PushDacWireEvent(test_dac_wire_t* wire, const uint32_t event) {
+    if (wire->num_events < TEST_DAC_WIRE_EVENTS) {
+        wire->events[wire->num_events++] = event;
+    }
+}
+
+static void SetDacCs(test_dac_wire_t* wire, const bool level) {
+    if (level && !wire->cs) {
+        PushDacWireEvent(wire, wire->bits == 16 ? wire->shift : 0x20000u | (uint32_t)wire->bits);
+    }
+    wire->shift = 0;
+    wire->bits = 0;
+    wire->cs = level;
+}
+
+static void SetDacSck(test_dac_wire_t* wire, const bool level) {
+    if (level && !wire->sck && !wire->cs) {
+        wire->shift = ((wire->shift << 1) | (wire->sdi ? 1u : 0u)) & 0xFFFFu;
+        ++wire->bits;
+    }
+    wire->sck = level;
+}
+
+static void SetDacLdac(test_dac_wire_t* wire, const bool level) {
+    if (!level && wire->ldac) {
+        PushDacWireEvent(wire, TEST_DAC_LATCH);
+    }
+    wire->ldac = level;
+}
+
+// TransmitSamples() as it was bit-banged before the SPI peripheral took over, delays left out.
+static uint16_t BitBangCommandPacket(int16_t value, const bool is_left) {
+    if (value < 0) {
+        value = 0;
+    }
+    const uint16_t twelve_bit_cmd = (uint16_t)(value);
+    const uint16_t gain_selection = 1 << 13;
+    const uint16_t channel_bit = is_left ? (1 << 15) : 0;
+    const uint16_t power_on_bit = 1 << 12;
+    return (twelve_bit_cmd | gain_selection | channel_bit | power_on_bit);
+}
+
+static void BitBangFrame(test_dac_wire_t* wire, const uint16_t frame) {
+    SetDacCs(wire, false);
+    for (int i = 0; i < 16; ++i) {
+        const uint16_t mask = 1 << (15 - i);
+        wire->sdi = (frame & mask) != 0;
+        SetDacSck(wire, true);
+        SetDacSck(wire, false);
+    }
+    SetDacCs(wire, true);
+}
+
+static void BitBangSamples(test_dac_wire_t* wire, const int16_t ch1_out, const int16_t ch2_out) {
+    SetDacLdac(wire, true);
+    BitBangFrame(wire, BitBangCommandPacket(ch1_out, true));
+    BitBangFrame(wire, BitBangCommandPacket(ch2_out, false));
+    SetDacLdac(wire, false);
+}
+
+/*
+ * The real driver, dac_mcp4822.c, on the HAL stand-in (resources/host/chibios):
+ * its pad writes and the frames the stand-in SPI shifts out by the driver's
+ * CR1 go to g_dac_wire.
+ */
+static test_dac_wire_t g_dac_wire;
+static int g_dac_latches;
+static int g_dac_latch_events;      // Wire events the latch hook saw, the latch should be the last
+
+static void TraceDacPin(ioportid_t port, unsigned pad, bool level) {
+    if (port != GPIOB) {
+        return;
+    }
+    switch (pad) {
+    case GPIO_PB12_DAC_CS:
+        SetDacCs(&g_dac_wire, level);
+        break;
+    case GPIO_PB13_DAC_SCK:
+        SetDacSck(&g_dac_wire, level);
+        break;
+    case GPIO_PB14_DAC_MISO:
+        SetDacLdac(&g_dac_wire, level);
+        break;
+    case GPIO_PB15_DAC_MOSI:
+        g_dac_wire.sdi = level;
+        break;
+    default:
+        break;
+    }
+}
+
+static void CountDacLatch(void) {
+    ++g_dac_latches;
+    g_dac_latch_events = g_dac_wire.num_events;
+}
+
+/*
+ * Sends one pair through TransmitWordsI(), or TransmitSamplesI() if words is
+ * NULL, and plays the SPI interrupts until the driver goes idle. While the
+ * pair is in flight the driver must report busy and turn another away.
+ */
+static bool SendDacPair(const uint16_t* words, const int16_t x, const int16_t y) {
+    g_dac_wire.num_events = 0;
+    g_dac_latches = 0;
+    chSysLock();
+    const bool queued = words != NULL ? TransmitWordsI(words) : TransmitSamplesI(x, y);
+    const bool busy = !DacIdle() && !TransmitSamplesI(0, 0);
+    chSysUnlock();
+    int frames = 0;
+    while (MockSpiFinishFrame(&SPID2)) {
+        ++frames;
+    }
+    return queued && busy && frames == 2 && DacIdle() && g_dac_latches == 1 && g_dac_latch_events == 3;
+}
+
+/*
+ * Checks the wire trace of one point sent through the driver against the
+ * bit-banged original. The original did not clamp above DAC_OUT_MAX and let
+ * those values spill into the command bits, so there the driver has to match
+ * the original at full scale instead.
+ */
+static bool CheckDacPoint(const uint16_t* words, const int16_t x, const int16_t y) {
+    test_dac_wire_t bit_bang;
+    ResetDacWire(&bit_bang);
+    BitBangSamples(&bit_bang, x > DAC_OUT_MAX ? DAC_OUT_MAX : x, y > DAC_OUT_MAX ? DAC_OUT_MAX : y);
+    return SendDacPair(words, x, y) && g_dac_wire.num_events == 3 && bit_bang.num_events == 3 &&
+           memcmp(g_dac_wire.events, bit_bang.events, sizeof(g_dac_wire.events[0]) * 3) == 0;
+}
+
+/*
+ * The DAC bit stream of the SPI driver against the bit-banged transmit it
+ * replaced: every 12-bit code and a margin either side on each channel
+ * through TransmitSamplesI() and PackPoint(), then random points over the
+ * whole int16_t range through PackPointBlock(), as the output clock sends them.
+ */
+static bool TestDacStream(void) {
+    static engine_output_block_t block;
+    static packed_point_t packed[ENGINE_MAX_BLOCK];
+    MockHalSetPinHook(TraceDacPin);
+    InitDac();
+    SetDacLatchHook(CountDacLatch);
+    ResetDacWire(&g_dac_wire);
+    g_dac_wire.ldac = (GPIOB->odr & (1u << GPIO_PB14_DAC_MISO)) != 0;
+    const bool idle = DacIdle() && (GPIOB->odr & (1u << GPIO_PB12_DAC_CS)) != 0;
+
+    int points = 0;
+    int mismatches = 0;
+    for (int code = -64; code <= DAC_OUT_MAX + 64; ++code) {
+        const int16_t other = (int16_t)(DAC_OUT_MAX - code);
+        const engine_outputs_t ch1 = {(int16_t)code, other, 0, 0, 0};
+        const engine_outputs_t ch2 = {other, (int16_t)code, 0, 0, 0};
+        const packed_point_t point = PackPoint(&ch1);
+        const uint16_t words[2] = {(uint16_t)point, (uint16_t)(point >> 16)};
+        mismatches += CheckDacPoint(words, ch1.position_output_x, ch1.position_output_y) ? 0 : 1;
+        mismatches += CheckDacPoint(NULL, ch2.position_output_x, ch2.position_output_y) ? 0 : 1;
+        points += 2;
+    }
+    const bool sweep = mismatches == 0;
+    for (int i = 0; i < TEST_DAC_RANDOM_POINTS; i += ENGINE_MAX_BLOCK) {
+        for (int p = 0; p < ENGINE_MAX_BLOCK; ++p) {
+            block.x[p] = (int16_t)BenchRandom();
+            block.y[p] = (int16_t)BenchRandom();
+            block.r[p] = block.g[p] = block.b[p] = 0;
+        }
+        PackPointBlock(&block, packed, ENGINE_MAX_BLOCK);
+        for (int p = 0; p < ENGINE_MAX_BLOCK; ++p) {
+            const uint16_t words[2] = {(uint16_t)packed[p], (uint16_t)(packed[p] >> 16)};
+            mismatches += CheckDacPoint(words, block.x[p], block.y[p]) ? 0 : 1;
+            ++points;
+        }
+    }
+    const bool random = mismatches == 0;
+    SetDacLatchHook(NULL);
+    MockHalSetPinHook(NULL);
+    printf("  %-30s %s\n", "idle after InitDac()", idle ? "ok" : "FAIL");
+    printf("  %-30s %s\n", "every code, both channels", sweep ? "ok" : "FAIL");
+    printf("  %-30s %s\n", "random points, packed blocks", random ? "ok" : "FAIL");
+    printf("  points against bit-bang:       %d, %d mismatched\n", points, mismatches);
+    return idle && sweep && random;
+}
+
+/*
+ * LaserDutyFromLevel() over every level and past both ends: the ends map onto
+ * off and full on, out of range levels clamp, the duty never falls as the
+ * level rises and rounds to the nearest tick. Then the duties through a packed
+ * point. Stated tolerance: 0.5 tick.
+ */
+static bool TestLaserDuty(void) {
+    const bool ends = LaserDutyFromLevel(0) == 0 && LaserDutyFromLevel(LASER_PWM_MAX) == LASER_PWM_PERIOD;
+    const bool clamped = LaserDutyFromLevel(-1) == 0 && LaserDutyFromLevel(INT16_MIN) == 0 &&
+                         LaserDutyFromLevel(LASER_PWM_MAX + 1) == LASER_PWM_PERIOD &&
+                         LaserDutyFromLevel(INT16_MAX) == LASER_PWM_PERIOD;
+    bool monotonic = true;
+    double max_error = 0.0;
+    for (int level = 0; level <= LASER_PWM_MAX; ++level) {
+        const uint16_t duty = LaserDutyFromLevel((int16_t)level);
+        monotonic = monotonic && (level == 0 || duty >= LaserDutyFromLevel((int16_t)(level - 1)));
+        const double error = fabs(duty - (double)level * LASER_PWM_PERIOD / LASER_PWM_MAX);
+        max_error = error > max_error ? error : max_error;
+    }
+    bool packed = true;
+    for (int level = -8; level <= LASER_PWM_MAX + 8; ++level) {
+        const engine_outputs_t outputs = {
+            0, 0, (int16_t)level, (int16_t)(LASER_PWM_MAX - level), (int16_t)(level / 2)
+        };
+        const packed_point_t point = PackPoint(&outputs);
+        packed = packed &&
+                 PackedPointDuty(point, PACKED_POINT_R_SHIFT) == LaserDutyFromLevel(outputs.laser_pwm_output_r) &&
+                 PackedPointDuty(point, PACKED_POINT_G_SHIFT) == LaserDutyFromLevel(outputs.laser_pwm_output_g) &&
+                 PackedPointDuty(point, PACKED_POINT_B_SHIFT) == LaserDutyFromLevel(outputs.laser_pwm_output_b);
+    }
+    printf("  %-30s %s\n", "ends", ends ? "ok" : "FAIL");
+    printf("  %-30s %s\n", "out of range clamps", clamped ? "ok" : "FAIL");
+    printf("  %-30s %s\n", "monotonic", monotonic ? "ok" : "FAIL");
+    printf("  %-30s %s\n", "packed point duties", packed ? "ok" : "FAIL");
+    const bool rounded = max_error <= 0.5;
+    printf("  max error vs exact duty:       %.3f tick\n", max_error);
+    printf("  tolerance:                     0.5 tick  %s\n", rounded ? "ok" : "FAIL");
+    return ends && clamped && monotonic && packed && rounded;
+}
+
+static const host_test_t g_tests[] = {
+    {"trig", "LUT sine error against libm", TestTrig},
+    {"shapes", "Shape table error against libm", TestShapeTables},
+    {"fixed", "Every mode in the fixed-point engine against the float build", TestFixedPoint},
+    {"decimator", "Audio CIC+FIR decimator frequency response", TestAudioDecimator},
+    {"bands", "Goertzel band bank response, level tracking, attack and release", TestAudioBands},
+    {"spectrum", "Fixed-point FFT spectrum analyzer against double precision, overruns", TestSpectrum},
+    {"beat", "Onsets, tempo and beat phase through the engine from WAV files", TestBeatTracker},
+    {"app", "Audio analysed once per ADC block through AppStep() while the output expands", TestAppAnalysis},
+    {"selector", "Mode selection hysteresis and settling on noisy CV traces", TestModeSelector},
+    {"stages", "Blocks routed through or around the output stages per mode", TestOutputStages},
+    {"dwell", "Blanking and corner dwell inserted points", TestBlankDwell},
+    {"reorder", "Frame segment reordering and frame rendering", TestFrameOptimizer},
+    {"ilda", "ILDA reader round trip per format", TestIlda},
+    {"compact", "Compact show round trip, malformed blobs, ILDA mode playback", TestCompactShow},
+    {"ring", "Point ring between two threads, sequence, overruns and underruns", TestPointRing},
+    {"dac", "DAC SPI driver bit stream against the bit-banged original", TestDacStream},
+    {"laser", "Laser PWM duty mapping, clamping and rounding", TestLaserDuty},
+};
+
+#define NUM_TESTS (sizeof(g_tests) / sizeof(g_tests[0]))
+
+int RunHostTests(const char* name) {
+    int run = 0;
+    int failed = 0;
+    for (size_t i = 0; i < NUM_TESTS; ++i) {
+        if (strcmp(name, "all") == 0 || strcmp(name, g_tests[i].name) == 0) {
+            printf("%s: %s\n", g_tests[i].name, g_tests[i].description);
+            const bool ok = g_tests[i].run();
+            printf("%s: %s\n", g_tests[i].name, ok ? "pass" : "FAIL");
+            failed += ok ? 0 : 1;
+            ++run;
+        }
+    }
+    if (run == 0) {
+        return -1;
+    }
+    printf("%d tests, %d failed\n", run, failed);
+    return failed;
+}
+
+void ListHostTests(void) {
+    for (size_t i = 0; i < NUM_TESTS; ++i) {
+        fprintf(stderr, "  %-10s %s\n", g_tests[i].name, g_tests[i].description);
+    }
+}
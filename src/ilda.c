@@ -0,0 +1,149 @@
+#include <string.h>
+
+#include "ilda.h"
+
+#define ILDA_FORMAT_3D_INDEXED      0
+#define ILDA_FORMAT_2D_INDEXED      1
+#define ILDA_FORMAT_PALETTE         2
+#define ILDA_FORMAT_3D_TRUE_COLOR   4
+#define ILDA_FORMAT_2D_TRUE_COLOR   5
+
+#define ILDA_STATUS_LAST            0x80
+#define ILDA_STATUS_BLANKED         0x40
+
+// ILDA standard default palette, R G B.
+static const uint8_t g_ilda_palette[ILDA_PALETTE_SIZE][3] = {
+    {255, 0, 0}, {255, 16, 0}, {255, 32, 0}, {255, 48, 0}, {255, 64, 0}, {255, 80, 0}, {255, 96, 0}, {255, 112, 0},
+    {255, 128, 0}, {255, 144, 0}, {255, 160, 0}, {255, 176, 0}, {255, 192, 0}, {255, 208, 0}, {255, 224, 0}, {255, 240, 0},
+    {255, 255, 0}, {224, 255, 0}, {192, 255, 0}, {160, 255, 0}, {128, 255, 0}, {96, 255, 0}, {64, 255, 0}, {32, 255, 0},
+    {0, 255, 0}, {0, 255, 36}, {0, 255, 73}, {0, 255, 109}, {0, 255, 146}, {0, 255, 182}, {0, 255, 219}, {0, 255, 255},
+    {0, 227, 255}, {0, 198, 255}, {0, 170, 255}, {0, 142, 255}, {0, 113, 255}, {0, 85, 255}, {0, 56, 255}, {0, 28, 255},
+    {0, 0, 255}, {32, 0, 255}, {64, 0, 255}, {96, 0, 255}, {128, 0, 255}, {160, 0, 255}, {192, 0, 255}, {224, 0, 255},
+    {255, 0, 255}, {255, 32, 255}, {255, 64, 255}, {255, 96, 255}, {255, 128, 255}, {255, 160, 255}, {255, 192, 255}, {255, 224, 255},
+    {255, 255, 255}, {255, 224, 224}, {255, 192, 192}, {255, 160, 160}, {255, 128, 128}, {255, 96, 96}, {255, 64, 64}, {255, 32, 32},
+};
+
+// Bytes per record of each format, 0 for formats this reader does not know.
+static const uint8_t g_record_size[6] = {8, 6, 3, 0, 10, 8};
+
+static inline uint16_t ReadU16(const uint8_t* bytes) {
+    return (uint16_t)((bytes[0] << 8) | bytes[1]);
+}
+
+static inline uint8_t RecordSize(const uint8_t format) {
+    return format < sizeof(g_record_size) ? g_record_size[format] : 0;
+}
+
+static inline bool IsPointFormat(const uint8_t format) {
+    return format != ILDA_FORMAT_PALETTE && RecordSize(format) != 0;
+}
+
+static inline size_t SectionSize(const uint8_t* header) {
+    return ILDA_HEADER_SIZE + (size_t)ReadU16(&header[24]) * RecordSize(header[7]);
+}
+
+// 8-bit colour to 12-bit PWM level, 255 -> 4095 exactly.
+static inline int16_t ColorLevel(const uint8_t value) {
+    return (int16_t)((value << 4) | (value >> 4));
+}
+
+// ILDA +-32767 about the centre to 12-bit DAC counts.
+static inline int16_t Position(const uint8_t* bytes) {
+    return (int16_t)(((int32_t)(int16_t)ReadU16(bytes) + 32768) >> 4);
+}
+
+static void LoadFrameHeader(const ilda_file_t* file, ilda_cursor_t* cursor) {
+    const uint8_t* header = &file->data[cursor->frame_offset];
+    cursor->format = header[7];
+    cursor->num_points = ReadU16(&header[24]);
+    cursor->point = 0;
+}
+
+bool IldaOpen(ilda_file_t* file, const uint8_t* data, const size_t size) {
+    *file = (ilda_file_t){data, size, 0, 0};
+
+    uint16_t frames = 0;
+    size_t first_frame = 0;
+    size_t offset = 0;
+    while (offset + ILDA_HEADER_SIZE <= size) {
+        const uint8_t* header = &data[offset];
+        if (memcmp(header, "ILDA", 4) != 0 || RecordSize(header[7]) == 0) {
+            return false;
+        }
+        if (ReadU16(&header[24]) == 0) {
+            break;  // End of file section
+        }
+        if (offset + SectionSize(header) > size) {
+            return false;
+        }
+        if (IsPointFormat(header[7])) {
+            first_frame = frames == 0 ? offset : first_frame;
+            ++frames;
+        }
+        offset += SectionSize(header);
+    }
+
+    file->num_frames = frames;
+    file->first_frame = first_frame;
+    return frames > 0;
+}
+
+void IldaSeekFrame(const ilda_file_t* file, ilda_cursor_t* cursor, const uint16_t frame) {
+    if (cursor->frame_offset < file->first_frame || cursor->frame > frame) {
+        cursor->frame_offset = file->first_frame;
+        cursor->frame = 0;
+    }
+    while (cursor->frame < frame) {
+        size_t offset = cursor->frame_offset + SectionSize(&file->data[cursor->frame_offset]);
+        while (!IsPointFormat(file->data[offset + 7])) {
+            offset += SectionSize(&file->data[offset]);
+        }
+        cursor->frame_offset = offset;
+        ++cursor->frame;
+    }
+    LoadFrameHeader(file, cursor);
+}
+
+bool IldaNextPoint(const ilda_file_t* file, ilda_cursor_t* cursor, ilda_point_t* point) {
+    if (cursor->point >= cursor->num_points) {
+        return false;
+    }
+    const uint8_t* record = &file->data[cursor->frame_offset + ILDA_HEADER_SIZE
+                                        + (size_t)cursor->point * RecordSize(cursor->format)];
+    ++cursor->point;
+
+    point->x = Position(&record[0]);
+    point->y = Position(&record[2]);
+
+    uint8_t status;
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+    switch (cursor->format) {
+        case ILDA_FORMAT_3D_INDEXED:
+        case ILDA_FORMAT_2D_INDEXED: {
+            const int at = cursor->format == ILDA_FORMAT_3D_INDEXED ? 6 : 4;
+            const uint8_t* color = g_ilda_palette[record[at + 1] % ILDA_PALETTE_SIZE];
+            status = record[at];
+            r = color[0];
+            g = color[1];
+            b = color[2];
+            break;
+        }
+        default: {
+            const int at = cursor->format == ILDA_FORMAT_3D_TRUE_COLOR ? 6 : 4;
+            status = record[at];
+            b = record[at + 1];
+            g = record[at + 2];
+            r = record[at + 3];
+            break;
+        }
+    }
+
+    point->blanked = (status & ILDA_STATUS_BLANKED) != 0;
+    point->last = (status & ILDA_STATUS_LAST) != 0;
+    point->r = point->blanked ? 0 : ColorLevel(r);
+    point->g = point->blanked ? 0 : ColorLevel(g);
+    point->b = point->blanked ? 0 : ColorLevel(b);
+    return true;
+}
@@ -0,0 +1,137 @@
+// Generated by resources/ilda/make_default_show.py, do not edit.
+#include "ilda.h"
+
+const uint8_t g_ilda_default_show[] = {
+    0x49, 0x4c, 0x44, 0x41, 0x00, 0x00, 0x00, 0x05, 0x70, 0x68, 0x6f, 0x74, 0x6f, 0x6e, 0x00, 0x00,
+    0x64, 0x6a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1c, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00,
+    0x00, 0x00, 0x4e, 0x20, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4e, 0x20, 0x00, 0x00, 0xc8, 0xff,
+    0xed, 0xa2, 0x19, 0x48, 0x00, 0x00, 0xc8, 0xff, 0xb5, 0xb3, 0x18, 0x24, 0x00, 0x00, 0xc8, 0xff,
+    0xe2, 0x48, 0xf6, 0x58, 0x00, 0x00, 0xc8, 0xff, 0xd2, 0x14, 0xc0, 0xcc, 0x00, 0x00, 0xc8, 0xff,
+    0x00, 0x00, 0xe0, 0xc0, 0x00, 0x00, 0xc8, 0xff, 0x2d, 0xec, 0xc0, 0xcc, 0x00, 0x00, 0xc8, 0xff,
+    0x1d, 0xb8, 0xf6, 0x58, 0x00, 0x00, 0xc8, 0xff, 0x4a, 0x4d, 0x18, 0x24, 0x00, 0x00, 0xc8, 0xff,
+    0x12, 0x5e, 0x19, 0x48, 0x00, 0x00, 0xc8, 0xff, 0x00, 0x00, 0x4e, 0x20, 0x00, 0x00, 0xc8, 0xff,
+    0x6d, 0x60, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x6d, 0x60, 0x00, 0x00, 0x00, 0xff, 0x80, 0x00,
+    0x6d, 0x60, 0x00, 0x00, 0x00, 0xff, 0x80, 0x00, 0x6d, 0x60, 0x00, 0x00, 0x00, 0xff, 0x80, 0x00,
+    0x00, 0x00, 0x6d, 0x60, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x6d, 0x60, 0x00, 0xff, 0x80, 0x00,
+    0x00, 0x00, 0x6d, 0x60, 0x00, 0xff, 0x80, 0x00, 0x00, 0x00, 0x6d, 0x60, 0x00, 0xff, 0x80, 0x00,
+    0x92, 0xa0, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x92, 0xa0, 0x00, 0x00, 0x00, 0xff, 0x80, 0x00,
+    0x92, 0xa0, 0x00, 0x00, 0x00, 0xff, 0x80, 0x00, 0x92, 0xa0, 0x00, 0x00, 0x00, 0xff, 0x80, 0x00,
+    0x00, 0x00, 0x92, 0xa0, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x92, 0xa0, 0x00, 0xff, 0x80, 0x00,
+    0x00, 0x00, 0x92, 0xa0, 0x00, 0xff, 0x80, 0x00, 0x00, 0x00, 0x92, 0xa0, 0x80, 0xff, 0x80, 0x00,
+    0x49, 0x4c, 0x44, 0x41, 0x00, 0x00, 0x00, 0x05, 0x70, 0x68, 0x6f, 0x74, 0x6f, 0x6e, 0x00, 0x00,
+    0x64, 0x6a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1c, 0x00, 0x01, 0x00, 0x08, 0x00, 0x00,
+    0xf3, 0xc7, 0x4d, 0x2a, 0x40, 0x00, 0x00, 0x00, 0xf3, 0xc7, 0x4d, 0x2a, 0x00, 0x00, 0xc8, 0xff,
+    0xe9, 0xe7, 0x16, 0x19, 0x00, 0x00, 0xc8, 0xff, 0xb2, 0xd6, 0x0c, 0x39, 0x00, 0x00, 0xc8, 0xff,
+    0xe4, 0x28, 0xf1, 0xd0, 0x00, 0x00, 0xc8, 0xff, 0xdc, 0x88, 0xba, 0x64, 0x00, 0x00, 0xc8, 0xff,
+    0x04, 0xe3, 0xe1, 0x22, 0x00, 0x00, 0xc8, 0xff, 0x37, 0x3e, 0xc8, 0xc2, 0x00, 0x00, 0xc8, 0xff,
+    0x1e, 0xde, 0xfb, 0x1d, 0x00, 0x00, 0xc8, 0xff, 0x45, 0x9c, 0x23, 0x78, 0x00, 0x00, 0xc8, 0xff,
+    0x0e, 0x30, 0x1b, 0xd8, 0x00, 0x00, 0xc8, 0xff, 0xf3, 0xc7, 0x4d, 0x2a, 0x00, 0x00, 0xc8, 0xff,
+    0x68, 0x06, 0xde, 0x34, 0x40, 0x00, 0x00, 0x00, 0x68, 0x06, 0xde, 0x34, 0x00, 0xff, 0x80, 0x00,
+    0x68, 0x06, 0xde, 0x34, 0x00, 0xff, 0x80, 0x00, 0x68, 0x06, 0xde, 0x34, 0x00, 0xff, 0x80, 0x00,
+    0x21, 0xcc, 0x68, 0x06, 0x40, 0x00, 0x00, 0x00, 0x21, 0xcc, 0x68, 0x06, 0x00, 0xff, 0x80, 0x00,
+    0x21, 0xcc, 0x68, 0x06, 0x00, 0xff, 0x80, 0x00, 0x21, 0xcc, 0x68, 0x06, 0x00, 0xff, 0x80, 0x00,
+    0x97, 0xfa, 0x21, 0xcc, 0x40, 0x00, 0x00, 0x00, 0x97, 0xfa, 0x21, 0xcc, 0x00, 0xff, 0x80, 0x00,
+    0x97, 0xfa, 0x21, 0xcc, 0x00, 0xff, 0x80, 0x00, 0x97, 0xfa, 0x21, 0xcc, 0x00, 0xff, 0x80, 0x00,
+    0xde, 0x34, 0x97, 0xfa, 0x40, 0x00, 0x00, 0x00, 0xde, 0x34, 0x97, 0xfa, 0x00, 0xff, 0x80, 0x00,
+    0xde, 0x34, 0x97, 0xfa, 0x00, 0xff, 0x80, 0x00, 0xde, 0x34, 0x97, 0xfa, 0x80, 0xff, 0x80, 0x00,
+    0x49, 0x4c, 0x44, 0x41, 0x00, 0x00, 0x00, 0x05, 0x70, 0x68, 0x6f, 0x74, 0x6f, 0x6e, 0x00, 0x00,
+    0x64, 0x6a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1c, 0x00, 0x02, 0x00, 0x08, 0x00, 0x00,
+    0xe7, 0xdc, 0x4a, 0x4d, 0x40, 0x00, 0x00, 0x00, 0xe7, 0xdc, 0x4a, 0x4d, 0x00, 0x00, 0xc8, 0xff,
+    0xe6, 0xb8, 0x12, 0x5e, 0x00, 0x00, 0xc8, 0xff, 0xb1, 0xe0, 0x00, 0x00, 0x00, 0x00, 0xc8, 0xff,
+    0xe6, 0xb8, 0xed, 0xa2, 0x00, 0x00, 0xc8, 0xff, 0xe7, 0xdc, 0xb5, 0xb3, 0x00, 0x00, 0xc8, 0xff,
+    0x09, 0xa8, 0xe2, 0x48, 0x00, 0x00, 0xc8, 0xff, 0x3f, 0x34, 0xd2, 0x14, 0x00, 0x00, 0xc8, 0xff,
+    0x1f, 0x40, 0x00, 0x00, 0x00, 0x00, 0xc8, 0xff, 0x3f, 0x34, 0x2d, 0xec, 0x00, 0x00, 0xc8, 0xff,
+    0x09, 0xa8, 0x1d, 0xb8, 0x00, 0x00, 0xc8, 0xff, 0xe7, 0xdc, 0x4a, 0x4d, 0x00, 0x00, 0xc8, 0xff,
+    0x58, 0x7c, 0xbf, 0xb6, 0x40, 0x00, 0x00, 0x00, 0x58, 0x7c, 0xbf, 0xb6, 0x00, 0xff, 0x80, 0x00,
+    0x58, 0x7c, 0xbf, 0xb6, 0x00, 0xff, 0x80, 0x00, 0x58, 0x7c, 0xbf, 0xb6, 0x00, 0xff, 0x80, 0x00,
+    0x40, 0x4a, 0x58, 0x7c, 0x40, 0x00, 0x00, 0x00, 0x40, 0x4a, 0x58, 0x7c, 0x00, 0xff, 0x80, 0x00,
+    0x40, 0x4a, 0x58, 0x7c, 0x00, 0xff, 0x80, 0x00, 0x40, 0x4a, 0x58, 0x7c, 0x00, 0xff, 0x80, 0x00,
+    0xa7, 0x84, 0x40, 0x4a, 0x40, 0x00, 0x00, 0x00, 0xa7, 0x84, 0x40, 0x4a, 0x00, 0xff, 0x80, 0x00,
+    0xa7, 0x84, 0x40, 0x4a, 0x00, 0xff, 0x80, 0x00, 0xa7, 0x84, 0x40, 0x4a, 0x00, 0xff, 0x80, 0x00,
+    0xbf, 0xb6, 0xa7, 0x84, 0x40, 0x00, 0x00, 0x00, 0xbf, 0xb6, 0xa7, 0x84, 0x00, 0xff, 0x80, 0x00,
+    0xbf, 0xb6, 0xa7, 0x84, 0x00, 0xff, 0x80, 0x00, 0xbf, 0xb6, 0xa7, 0x84, 0x80, 0xff, 0x80, 0x00,
+    0x49, 0x4c, 0x44, 0x41, 0x00, 0x00, 0x00, 0x05, 0x70, 0x68, 0x6f, 0x74, 0x6f, 0x6e, 0x00, 0x00,
+    0x64, 0x6a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1c, 0x00, 0x03, 0x00, 0x08, 0x00, 0x00,
+    0xdc, 0x88, 0x45, 0x9c, 0x40, 0x00, 0x00, 0x00, 0xdc, 0x88, 0x45, 0x9c, 0x00, 0x00, 0xc8, 0xff,
+    0xe4, 0x28, 0x0e, 0x30, 0x00, 0x00, 0xc8, 0xff, 0xb2, 0xd6, 0xf3, 0xc7, 0x00, 0x00, 0xc8, 0xff,
+    0xe9, 0xe7, 0xe9, 0xe7, 0x00, 0x00, 0xc8, 0xff, 0xf3, 0xc7, 0xb2, 0xd6, 0x00, 0x00, 0xc8, 0xff,
+    0x0e, 0x30, 0xe4, 0x28, 0x00, 0x00, 0xc8, 0xff, 0x45, 0x9c, 0xdc, 0x88, 0x00, 0x00, 0xc8, 0xff,
+    0x1e, 0xde, 0x04, 0xe3, 0x00, 0x00, 0xc8, 0xff, 0x37, 0x3e, 0x37, 0x3e, 0x00, 0x00, 0xc8, 0xff,
+    0x04, 0xe3, 0x1e, 0xde, 0x00, 0x00, 0xc8, 0xff, 0xdc, 0x88, 0x45, 0x9c, 0x00, 0x00, 0xc8, 0xff,
+    0x40, 0x4a, 0xa7, 0x84, 0x40, 0x00, 0x00, 0x00, 0x40, 0x4a, 0xa7, 0x84, 0x00, 0xff, 0x80, 0x00,
+    0x40, 0x4a, 0xa7, 0x84, 0x00, 0xff, 0x80, 0x00, 0x40, 0x4a, 0xa7, 0x84, 0x00, 0xff, 0x80, 0x00,
+    0x58, 0x7c, 0x40, 0x4a, 0x40, 0x00, 0x00, 0x00, 0x58, 0x7c, 0x40, 0x4a, 0x00, 0xff, 0x80, 0x00,
+    0x58, 0x7c, 0x40, 0x4a, 0x00, 0xff, 0x80, 0x00, 0x58, 0x7c, 0x40, 0x4a, 0x00, 0xff, 0x80, 0x00,
+    0xbf, 0xb6, 0x58, 0x7c, 0x40, 0x00, 0x00, 0x00, 0xbf, 0xb6, 0x58, 0x7c, 0x00, 0xff, 0x80, 0x00,
+    0xbf, 0xb6, 0x58, 0x7c, 0x00, 0xff, 0x80, 0x00, 0xbf, 0xb6, 0x58, 0x7c, 0x00, 0xff, 0x80, 0x00,
+    0xa7, 0x84, 0xbf, 0xb6, 0x40, 0x00, 0x00, 0x00, 0xa7, 0x84, 0xbf, 0xb6, 0x00, 0xff, 0x80, 0x00,
+    0xa7, 0x84, 0xbf, 0xb6, 0x00, 0xff, 0x80, 0x00, 0xa7, 0x84, 0xbf, 0xb6, 0x80, 0xff, 0x80, 0x00,
+    0x49, 0x4c, 0x44, 0x41, 0x00, 0x00, 0x00, 0x05, 0x70, 0x68, 0x6f, 0x74, 0x6f, 0x6e, 0x00, 0x00,
+    0x64, 0x6a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1c, 0x00, 0x04, 0x00, 0x08, 0x00, 0x00,
+    0xd2, 0x14, 0x3f, 0x34, 0x40, 0x00, 0x00, 0x00, 0xd2, 0x14, 0x3f, 0x34, 0x00, 0x00, 0xc8, 0xff,
+    0xe2, 0x48, 0x09, 0xa8, 0x00, 0x00, 0xc8, 0xff, 0xb5, 0xb3, 0xe7, 0xdc, 0x00, 0x00, 0xc8, 0xff,
+    0xed, 0xa2, 0xe6, 0xb8, 0x00, 0x00, 0xc8, 0xff, 0x00, 0x00, 0xb1, 0xe0, 0x00, 0x00, 0xc8, 0xff,
+    0x12, 0x5e, 0xe6, 0xb8, 0x00, 0x00, 0xc8, 0xff, 0x4a, 0x4d, 0xe7, 0xdc, 0x00, 0x00, 0xc8, 0xff,
+    0x1d, 0xb8, 0x09, 0xa8, 0x00, 0x00, 0xc8, 0xff, 0x2d, 0xec, 0x3f, 0x34, 0x00, 0x00, 0xc8, 0xff,
+    0x00, 0x00, 0x1f, 0x40, 0x00, 0x00, 0xc8, 0xff, 0xd2, 0x14, 0x3f, 0x34, 0x00, 0x00, 0xc8, 0xff,
+    0x21, 0xcc, 0x97, 0xfa, 0x40, 0x00, 0x00, 0x00, 0x21, 0xcc, 0x97, 0xfa, 0x00, 0xff, 0x80, 0x00,
+    0x21, 0xcc, 0x97, 0xfa, 0x00, 0xff, 0x80, 0x00, 0x21, 0xcc, 0x97, 0xfa, 0x00, 0xff, 0x80, 0x00,
+    0x68, 0x06, 0x21, 0xcc, 0x40, 0x00, 0x00, 0x00, 0x68, 0x06, 0x21, 0xcc, 0x00, 0xff, 0x80, 0x00,
+    0x68, 0x06, 0x21, 0xcc, 0x00, 0xff, 0x80, 0x00, 0x68, 0x06, 0x21, 0xcc, 0x00, 0xff, 0x80, 0x00,
+    0xde, 0x34, 0x68, 0x06, 0x40, 0x00, 0x00, 0x00, 0xde, 0x34, 0x68, 0x06, 0x00, 0xff, 0x80, 0x00,
+    0xde, 0x34, 0x68, 0x06, 0x00, 0xff, 0x80, 0x00, 0xde, 0x34, 0x68, 0x06, 0x00, 0xff, 0x80, 0x00,
+    0x97, 0xfa, 0xde, 0x34, 0x40, 0x00, 0x00, 0x00, 0x97, 0xfa, 0xde, 0x34, 0x00, 0xff, 0x80, 0x00,
+    0x97, 0xfa, 0xde, 0x34, 0x00, 0xff, 0x80, 0x00, 0x97, 0xfa, 0xde, 0x34, 0x80, 0xff, 0x80, 0x00,
+    0x49, 0x4c, 0x44, 0x41, 0x00, 0x00, 0x00, 0x05, 0x70, 0x68, 0x6f, 0x74, 0x6f, 0x6e, 0x00, 0x00,
+    0x64, 0x6a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1c, 0x00, 0x05, 0x00, 0x08, 0x00, 0x00,
+    0xc8, 0xc2, 0x37, 0x3e, 0x40, 0x00, 0x00, 0x00, 0xc8, 0xc2, 0x37, 0x3e, 0x00, 0x00, 0xc8, 0xff,
+    0xe1, 0x22, 0x04, 0xe3, 0x00, 0x00, 0xc8, 0xff, 0xba, 0x64, 0xdc, 0x88, 0x00, 0x00, 0xc8, 0xff,
+    0xf1, 0xd0, 0xe4, 0x28, 0x00, 0x00, 0xc8, 0xff, 0x0c, 0x39, 0xb2, 0xd6, 0x00, 0x00, 0xc8, 0xff,
+    0x16, 0x19, 0xe9, 0xe7, 0x00, 0x00, 0xc8, 0xff, 0x4d, 0x2a, 0xf3, 0xc7, 0x00, 0x00, 0xc8, 0xff,
+    0x1b, 0xd8, 0x0e, 0x30, 0x00, 0x00, 0xc8, 0xff, 0x23, 0x78, 0x45, 0x9c, 0x00, 0x00, 0xc8, 0xff,
+    0xfb, 0x1d, 0x1e, 0xde, 0x00, 0x00, 0xc8, 0xff, 0xc8, 0xc2, 0x37, 0x3e, 0x00, 0x00, 0xc8, 0xff,
+    0x00, 0x00, 0x92, 0xa0, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x92, 0xa0, 0x00, 0xff, 0x80, 0x00,
+    0x00, 0x00, 0x92, 0xa0, 0x00, 0xff, 0x80, 0x00, 0x00, 0x00, 0x92, 0xa0, 0x00, 0xff, 0x80, 0x00,
+    0x6d, 0x60, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x6d, 0x60, 0x00, 0x00, 0x00, 0xff, 0x80, 0x00,
+    0x6d, 0x60, 0x00, 0x00, 0x00, 0xff, 0x80, 0x00, 0x6d, 0x60, 0x00, 0x00, 0x00, 0xff, 0x80, 0x00,
+    0x00, 0x00, 0x6d, 0x60, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x6d, 0x60, 0x00, 0xff, 0x80, 0x00,
+    0x00, 0x00, 0x6d, 0x60, 0x00, 0xff, 0x80, 0x00, 0x00, 0x00, 0x6d, 0x60, 0x00, 0xff, 0x80, 0x00,
+    0x92, 0xa0, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00, 0x92, 0xa0, 0x00, 0x00, 0x00, 0xff, 0x80, 0x00,
+    0x92, 0xa0, 0x00, 0x00, 0x00, 0xff, 0x80, 0x00, 0x92, 0xa0, 0x00, 0x00, 0x80, 0xff, 0x80, 0x00,
+    0x49, 0x4c, 0x44, 0x41, 0x00, 0x00, 0x00, 0x05, 0x70, 0x68, 0x6f, 0x74, 0x6f, 0x6e, 0x00, 0x00,
+    0x64, 0x6a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1c, 0x00, 0x06, 0x00, 0x08, 0x00, 0x00,
+    0xc0, 0xcc, 0x2d, 0xec, 0x40, 0x00, 0x00, 0x00, 0xc0, 0xcc, 0x2d, 0xec, 0x00, 0x00, 0xc8, 0xff,
+    0xe0, 0xc0, 0x00, 0x00, 0x00, 0x00, 0xc8, 0xff, 0xc0, 0xcc, 0xd2, 0x14, 0x00, 0x00, 0xc8, 0xff,
+    0xf6, 0x58, 0xe2, 0x48, 0x00, 0x00, 0xc8, 0xff, 0x18, 0x24, 0xb5, 0xb3, 0x00, 0x00, 0xc8, 0xff,
+    0x19, 0x48, 0xed, 0xa2, 0x00, 0x00, 0xc8, 0xff, 0x4e, 0x20, 0x00, 0x00, 0x00, 0x00, 0xc8, 0xff,
+    0x19, 0x48, 0x12, 0x5e, 0x00, 0x00, 0xc8, 0xff, 0x18, 0x24, 0x4a, 0x4d, 0x00, 0x00, 0xc8, 0xff,
+    0xf6, 0x58, 0x1d, 0xb8, 0x00, 0x00, 0xc8, 0xff, 0xc0, 0xcc, 0x2d, 0xec, 0x00, 0x00, 0xc8, 0xff,
+    0xde, 0x34, 0x97, 0xfa, 0x40, 0x00, 0x00, 0x00, 0xde, 0x34, 0x97, 0xfa, 0x00, 0xff, 0x80, 0x00,
+    0xde, 0x34, 0x97, 0xfa, 0x00, 0xff, 0x80, 0x00, 0xde, 0x34, 0x97, 0xfa, 0x00, 0xff, 0x80, 0x00,
+    0x68, 0x06, 0xde, 0x34, 0x40, 0x00, 0x00, 0x00, 0x68, 0x06, 0xde, 0x34, 0x00, 0xff, 0x80, 0x00,
+    0x68, 0x06, 0xde, 0x34, 0x00, 0xff, 0x80, 0x00, 0x68, 0x06, 0xde, 0x34, 0x00, 0xff, 0x80, 0x00,
+    0x21, 0xcc, 0x68, 0x06, 0x40, 0x00, 0x00, 0x00, 0x21, 0xcc, 0x68, 0x06, 0x00, 0xff, 0x80, 0x00,
+    0x21, 0xcc, 0x68, 0x06, 0x00, 0xff, 0x80, 0x00, 0x21, 0xcc, 0x68, 0x06, 0x00, 0xff, 0x80, 0x00,
+    0x97, 0xfa, 0x21, 0xcc, 0x40, 0x00, 0x00, 0x00, 0x97, 0xfa, 0x21, 0xcc, 0x00, 0xff, 0x80, 0x00,
+    0x97, 0xfa, 0x21, 0xcc, 0x00, 0xff, 0x80, 0x00, 0x97, 0xfa, 0x21, 0xcc, 0x80, 0xff, 0x80, 0x00,
+    0x49, 0x4c, 0x44, 0x41, 0x00, 0x00, 0x00, 0x05, 0x70, 0x68, 0x6f, 0x74, 0x6f, 0x6e, 0x00, 0x00,
+    0x64, 0x6a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1c, 0x00, 0x07, 0x00, 0x08, 0x00, 0x00,
+    0xba, 0x64, 0x23, 0x78, 0x40, 0x00, 0x00, 0x00, 0xba, 0x64, 0x23, 0x78, 0x00, 0x00, 0xc8, 0xff,
+    0xe1, 0x22, 0xfb, 0x1d, 0x00, 0x00, 0xc8, 0xff, 0xc8, 0xc2, 0xc8, 0xc2, 0x00, 0x00, 0xc8, 0xff,
+    0xfb, 0x1d, 0xe1, 0x22, 0x00, 0x00, 0xc8, 0xff, 0x23, 0x78, 0xba, 0x64, 0x00, 0x00, 0xc8, 0xff,
+    0x1b, 0xd8, 0xf1, 0xd0, 0x00, 0x00, 0xc8, 0xff, 0x4d, 0x2a, 0x0c, 0x39, 0x00, 0x00, 0xc8, 0xff,
+    0x16, 0x19, 0x16, 0x19, 0x00, 0x00, 0xc8, 0xff, 0x0c, 0x39, 0x4d, 0x2a, 0x00, 0x00, 0xc8, 0xff,
+    0xf1, 0xd0, 0x1b, 0xd8, 0x00, 0x00, 0xc8, 0xff, 0xba, 0x64, 0x23, 0x78, 0x00, 0x00, 0xc8, 0xff,
+    0xbf, 0xb6, 0xa7, 0x84, 0x40, 0x00, 0x00, 0x00, 0xbf, 0xb6, 0xa7, 0x84, 0x00, 0xff, 0x80, 0x00,
+    0xbf, 0xb6, 0xa7, 0x84, 0x00, 0xff, 0x80, 0x00, 0xbf, 0xb6, 0xa7, 0x84, 0x00, 0xff, 0x80, 0x00,
+    0x58, 0x7c, 0xbf, 0xb6, 0x40, 0x00, 0x00, 0x00, 0x58, 0x7c, 0xbf, 0xb6, 0x00, 0xff, 0x80, 0x00,
+    0x58, 0x7c, 0xbf, 0xb6, 0x00, 0xff, 0x80, 0x00, 0x58, 0x7c, 0xbf, 0xb6, 0x00, 0xff, 0x80, 0x00,
+    0x40, 0x4a, 0x58, 0x7c, 0x40, 0x00, 0x00, 0x00, 0x40, 0x4a, 0x58, 0x7c, 0x00, 0xff, 0x80, 0x00,
+    0x40, 0x4a, 0x58, 0x7c, 0x00, 0xff, 0x80, 0x00, 0x40, 0x4a, 0x58, 0x7c, 0x00, 0xff, 0x80, 0x00,
+    0xa7, 0x84, 0x40, 0x4a, 0x40, 0x00, 0x00, 0x00, 0xa7, 0x84, 0x40, 0x4a, 0x00, 0xff, 0x80, 0x00,
+    0xa7, 0x84, 0x40, 0x4a, 0x00, 0xff, 0x80, 0x00, 0xa7, 0x84, 0x40, 0x4a, 0x80, 0xff, 0x80, 0x00,
+    0x49, 0x4c, 0x44, 0x41, 0x00, 0x00, 0x00, 0x05, 0x70, 0x68, 0x6f, 0x74, 0x6f, 0x6e, 0x00, 0x00,
+    0x64, 0x6a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00,
+};
+
+const size_t g_ilda_default_show_size = sizeof(g_ilda_default_show);
@@ -0,0 +1,70 @@
+#include <ch.h>
+#include <hal.h>
+
+#include "laser_pwm.h"
+
+#define LASER_PWM_TIMER_FREQ  72000000
+
+#define LASER_PIN_R  GPIO_PB3
+#define LASER_PIN_G  GPIO_PB6
+#define LASER_PIN_B  GPIO_PB9
+
+// Timer channels, zero based as used by pwmEnableChannelI().
+#define LASER_CHANNEL_R  1  // TIM2_CH2 (partial remap 1)
+#define LASER_CHANNEL_G  0  // TIM4_CH1
+#define LASER_CHANNEL_B  3  // TIM4_CH4
+
+/*
+ * The ChibiOS PWM driver enables CCR preload (OCxPE) and ARR preload, so
+ * duties written mid-cycle wait for the next update event.
+ */
+static const PWMConfig g_laser_pwm_r_config = {
+  .frequency = LASER_PWM_TIMER_FREQ,
+  .period = LASER_PWM_PERIOD,
+  .callback = NULL,
+  .channels = {
+    {PWM_OUTPUT_DISABLED, NULL},
+    {PWM_OUTPUT_ACTIVE_HIGH, NULL},
+    {PWM_OUTPUT_DISABLED, NULL},
+    {PWM_OUTPUT_DISABLED, NULL}
+  },
+  .cr2 = 0,
+  .dier = 0
+};
+
+static const PWMConfig g_laser_pwm_gb_config = {
+  .frequency = LASER_PWM_TIMER_FREQ,
+  .period = LASER_PWM_PERIOD,
+  .callback = NULL,
+  .channels = {
+    {PWM_OUTPUT_ACTIVE_HIGH, NULL},
+    {PWM_OUTPUT_DISABLED, NULL},
+    {PWM_OUTPUT_DISABLED, NULL},
+    {PWM_OUTPUT_ACTIVE_HIGH, NULL}
+  },
+  .cr2 = 0,
+  .dier = 0
+};
+
+void StartLaserPwm(void) {
+  palSetPadMode(GPIOB, LASER_PIN_R, PAL_MODE_STM32_ALTERNATE_PUSHPULL);
+  palSetPadMode(GPIOB, LASER_PIN_G, PAL_MODE_STM32_ALTERNATE_PUSHPULL);
+  palSetPadMode(GPIOB, LASER_PIN_B, PAL_MODE_STM32_ALTERNATE_PUSHPULL);
+
+  pwmStart(&PWMD2, &g_laser_pwm_r_config);
+  pwmStart(&PWMD4, &g_laser_pwm_gb_config);
+
+  chSysLock();
+  SetLaserPwmI(0, 0, 0);
+  chSysUnlock();
+}
+
+void SetLaserPwmI(const int16_t pwm_output_r, const int16_t pwm_output_g, const int16_t pwm_output_b) {
+  SetLaserDutyI(LaserDutyFromLevel(pwm_output_r), LaserDutyFromLevel(pwm_output_g), LaserDutyFromLevel(pwm_output_b));
+}
+
+void SetLaserDutyI(const uint16_t duty_r, const uint16_t duty_g, const uint16_t duty_b) {
+  pwmEnableChannelI(&PWMD2, LASER_CHANNEL_R, duty_r);
+  pwmEnableChannelI(&PWMD4, LASER_CHANNEL_G, duty_g);
+  pwmEnableChannelI(&PWMD4, LASER_CHANNEL_B, duty_b);
+}
@@ -0,0 +1,189 @@
+#include <ch.h>
+#include <hal.h>
+
+#include "dac_mcp4822.h"
+#include "laser_pwm.h"
+#include "output_clock.h"
+#include "point_ring.h"
+#include "profile.h"
+
+// TIM1 runs off the 72MHz APB2 timer clock, 4MHz gives 66 ticks at 60kpps.
+#define OUTPUT_CLOCK_TIMER_FREQ 4000000
+
+static void OutputClockCallback(GPTDriver* gptp);
+
+static const GPTConfig g_output_clock_config = {
+  .frequency = OUTPUT_CLOCK_TIMER_FREQ,
+  .callback = OutputClockCallback,
+  .cr2 = 0,
+  .dier = 0
+};
+
+/*
+ * Points flow from the engine thread to the tick ISR through a lock-free ring.
+ * The ISR signals g_space_sem when a block worth of room opens up.
+ */
+static point_ring_t g_point_ring;
+static binary_semaphore_t g_space_sem;
+
+/*
+ * Frame replay. The engine fills g_frame while no frame plays, then sets
+ * g_frame_requested. The ISR starts the loop once the ring has drained, and
+ * after a stop finishes the pass before going back to the ring.
+ */
+static packed_point_t g_frame[OUTPUT_FRAME_MAX_POINTS];
+static uint32_t g_frame_length;
+static uint32_t g_frame_index;
+static volatile bool g_frame_requested;
+static volatile bool g_frame_playing;
+
+// Point whose position the DAC is shifting in, its colour is set on the LDAC edge.
+static packed_point_t g_latch_point;
+// Ticks that found the last pair still on the wire, their point went out a tick late.
+static uint32_t g_dac_busy_ticks;
+
+static gptcnt_t RateToInterval(uint32_t rate_hz) {
+  rate_hz = rate_hz < OUTPUT_RATE_MIN_HZ ? OUTPUT_RATE_MIN_HZ :
+                      rate_hz > OUTPUT_RATE_MAX_HZ ? OUTPUT_RATE_MAX_HZ : rate_hz;
+  return (gptcnt_t)(OUTPUT_CLOCK_TIMER_FREQ / rate_hz);
+}
+
+/*
+ * Sample clock tick, latches one point. If the engine has fallen behind the
+ * galvos simply hold the last point, the ring counts the underrun.
+ */
+static inline bool NextPoint(packed_point_t* point) {
+  if (!g_frame_playing && g_frame_requested && PointRingCount(&g_point_ring) == 0) {
+    g_frame_index = 0;
+    g_frame_playing = true;
+  }
+  if (g_frame_playing) {
+    *point = g_frame[g_frame_index];
+    if (++g_frame_index == g_frame_length) {
+      g_frame_index = 0;
+      g_frame_playing = g_frame_requested;
+    }
+    return true;
+  }
+  return PointRingPop(&g_point_ring, point);
+}
+
+/*
+ * Nothing is taken from the ring or the frame while the DAC is still busy, so
+ * a tick that comes too soon after the last delays its point rather than
+ * losing it. While the clock runs only this ISR queues pairs, so an idle DAC
+ * stays idle until it does.
+ */
+static inline void OutputClockTick(void) {
+  if (!DacIdle()) {
+    ++g_dac_busy_ticks;
+    return;
+  }
+  packed_point_t point;
+  if (!NextPoint(&point)) {
+    return;
+  }
+  const uint16_t words[2] = {(uint16_t)point, (uint16_t)(point >> 16)};
+
+  chSysLockFromISR();
+  g_latch_point = point;
+  TransmitWordsI(words);
+  if (PointRingFree(&g_point_ring) == OUTPUT_BLOCK_SIZE) {
+    chBSemSignalI(&g_space_sem);
+  }
+  chSysUnlockFromISR();
+}
+
+/*
+ * DAC latch hook, preloads the colour of the point the LDAC edge just put out.
+ * The timers take it on their next update event rather than being forced to,
+ * so no PWM cycle is cut short. The colour follows the position by at most one
+ * PWM cycle, ~14us, well inside the time the galvos take to get there.
+ */
+static void LatchPointColourI(void) {
+  SetLaserDutyI(PackedPointDuty(g_latch_point, PACKED_POINT_R_SHIFT),
+                PackedPointDuty(g_latch_point, PACKED_POINT_G_SHIFT),
+                PackedPointDuty(g_latch_point, PACKED_POINT_B_SHIFT));
+}
+
+static void OutputClockCallback(GPTDriver* gptp) {
+  (void)gptp;
+  PROFILE_SCOPE(PROFILE_TICK) {
+    OutputClockTick();
+  }
+}
+
+void StartOutputClock(uint32_t rate_hz) {
+  PointRingInit(&g_point_ring);
+  chBSemObjectInit(&g_space_sem, true);
+  SetDacLatchHook(LatchPointColourI);
+  gptStart(&GPTD1, &g_output_clock_config);
+  gptStartContinuous(&GPTD1, RateToInterval(rate_hz));
+}
+
+void SetOutputRate(uint32_t rate_hz) {
+  gptChangeInterval(&GPTD1, RateToInterval(rate_hz));
+}
+
+void WaitOutputSpace(void) {
+  while (PointRingFree(&g_point_ring) < OUTPUT_BLOCK_SIZE) {
+    chBSemWait(&g_space_sem);
+  }
+}
+
+bool QueueOutputPoint(const engine_outputs_t* point) {
+  return PointRingPush(&g_point_ring, PackPoint(point));
+}
+
+bool QueueOutputBlock(const engine_output_block_t* points, const uint32_t n) {
+  static packed_point_t packed[OUTPUT_BLOCK_SIZE];
+  if (n > OUTPUT_BLOCK_SIZE) {
+    return false;
+  }
+  PackPointBlock(points, packed, n);
+  return PointRingPushBlock(&g_point_ring, packed, n);
+}
+
+bool BeginOutputFrame(void) {
+  if (g_frame_requested || g_frame_playing) {
+    return false;
+  }
+  g_frame_length = 0;
+  return true;
+}
+
+bool AppendOutputFrame(const engine_output_block_t* points, const uint32_t n) {
+  if (g_frame_length + n > OUTPUT_FRAME_MAX_POINTS) {
+    return false;
+  }
+  PackPointBlock(points, &g_frame[g_frame_length], n);
+  g_frame_length += n;
+  return true;
+}
+
+void PlayOutputFrame(void) {
+  if (g_frame_length == 0) {
+    return;
+  }
+  chSysLock();
+  g_frame_requested = true;
+  chSysUnlock();
+}
+
+void StopOutputFrame(void) {
+  chSysLock();
+  g_frame_requested = false;
+  chSysUnlock();
+}
+
+uint32_t GetOutputUnderruns(void) {
+  return g_point_ring.underruns;
+}
+
+uint32_t GetOutputOverruns(void) {
+  return g_point_ring.overruns;
+}
+
+uint32_t GetOutputDacBusyTicks(void) {
+  return g_dac_busy_ticks;
+}
@@ -0,0 +1,81 @@
+#include <ch.h>
+#include <hal.h>
+
+#include "adc_input.h"
+#include "dac_mcp4822.h"
+#include "laser_pwm.h"
+#include "output_clock.h"
+#include "platform.h"
+#include "profile.h"
+
+void PlatformStart(void) {
+  // Sets up DAC pins
+  InitDac();
+
+  /*
+   * Starts timer-triggered circular ADC conversion.
+   */
+  StartInputSampling(ADC_SAMPLE_RATE_DEFAULT_HZ);
+
+  /*
+   * Sleep 2s before disabling Serial JTAG (so there's a window to program it)
+   */
+  chThdSleepMilliseconds(2000);
+
+  // GPIO PB3 is by default used for SWD output. Turn it off so we can use PB3 as TIM2_CH2.
+  // SWJ_CFG is write-only and reads back as 0, so it is written with the remap.
+  AFIO->MAPR &= ~(AFIO_MAPR_SWJ_CFG_Msk | AFIO_MAPR_TIM2_REMAP_Msk);
+  AFIO->MAPR |= AFIO_MAPR_SWJ_CFG_DISABLE | AFIO_MAPR_TIM2_REMAP_PARTIALREMAP1;
+
+  StartLaserPwm();
+
+  /*
+   * The output clock latches points at a fixed rate, the engine runs ahead
+   * through the point ring and sleeps in WaitOutputSpace() once it is full.
+   */
+  StartOutputClock(OUTPUT_RATE_DEFAULT_HZ);
+}
+
+// The input thread has already analysed every block, a repeated one adds nothing to the features.
+bool PlatformReadInputBlock(engine_inputs_t* inputs, engine_audio_features_t* audio) {
+  GetInputBlock(inputs, audio);
+  return true;
+}
+
+void PlatformWriteOutputBlock(const engine_output_block_t* outputs) {
+  WaitOutputSpace();
+  // Timed after the wait so the slot measures work, not idle time.
+  PROFILE_SCOPE(PROFILE_OUTPUT) {
+    QueueOutputBlock(outputs, OUTPUT_BLOCK_SIZE);
+  }
+}
+
+bool PlatformBeginFrame(void) {
+  return BeginOutputFrame();
+}
+
+bool PlatformAppendFrame(const engine_output_block_t* outputs, const int n) {
+  return AppendOutputFrame(outputs, (uint32_t)n);
+}
+
+void PlatformPlayFrame(void) {
+  PlayOutputFrame();
+}
+
+void PlatformStopFrame(void) {
+  StopOutputFrame();
+}
+
+// The ISR plays the frame, the engine thread only has to look at the next input block.
+void PlatformWaitFrame(void) {
+  chThdSleepMicroseconds(1000000 / ADC_SAMPLE_RATE_DEFAULT_HZ * INPUT_BLOCK_FRAMES);
+}
+
+// DWT CYCCNT, enabled by the ChibiOS ARMv7-M port at start-up.
+uint32_t PlatformCycles(void) {
+  return (uint32_t)chSysGetRealtimeCounterX();
+}
+
+uint32_t PlatformCyclesPerSecond(void) {
+  return STM32_SYSCLK;
+}
@@ -0,0 +1,225 @@
+/*
+ * POSIX implementation of the platform layer. Inputs come from a CSV recording
+ * or a synthetic two-tone signal, oversampled and decimated as the target's
+ * audio inputs are, outputs are packed exactly as on the target
+ * and optionally written to CSV. Everything runs as fast as the host allows.
+ */
+#define _POSIX_C_SOURCE 199309L
+
+#include <math.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "audio_decimator.h"
+#include "platform.h"
+#include "platform_posix.h"
+#include "point_ring.h"
+#include "profile.h"
+
+#define SYNTH_TABLE_FRAMES  ADC_SAMPLE_RATE_DEFAULT_HZ  // One second
+#define SYNTH_TABLE_SCANS   (SYNTH_TABLE_FRAMES * AUDIO_OVERSAMPLE)
+#define SYNTH_CHANNELS      2
+#define SYNTH_FREQ_LEFT_HZ  440
+#define SYNTH_FREQ_RIGHT_HZ 660
+#define SYNTH_TWO_PI        6.283185307179586
+
+static posix_platform_config_t g_config;
+// Left and right interleaved, AUDIO_OVERSAMPLE scans per frame like the target's ADC buffer.
+static uint16_t g_synth_scans[SYNTH_TABLE_SCANS * SYNTH_CHANNELS];
+static uint32_t g_synth_idx = 0;
+static audio_decimator_t g_synth_left;
+static audio_decimator_t g_synth_right;
+static uint64_t g_points_written = 0;
+// The ADC side, see PlatformReadInputBlock().
+static engine_inputs_t g_input_frames[INPUT_BLOCK_FRAMES];
+static engine_audio_analyzer_t g_audio_analyzer;
+static uint64_t g_input_blocks = 0;
+static packed_point_t g_packed[OUTPUT_BLOCK_SIZE];
+static volatile packed_point_t g_sink_checksum = 0;
+
+// Frame replay, played from PlatformWaitFrame() where the target's ISR would.
+static int16_t g_frame_x[OUTPUT_FRAME_MAX_POINTS];
+static int16_t g_frame_y[OUTPUT_FRAME_MAX_POINTS];
+static int16_t g_frame_r[OUTPUT_FRAME_MAX_POINTS];
+static int16_t g_frame_g[OUTPUT_FRAME_MAX_POINTS];
+static int16_t g_frame_b[OUTPUT_FRAME_MAX_POINTS];
+static packed_point_t g_frame_packed[OUTPUT_FRAME_MAX_POINTS];
+static int g_frame_length = 0;
+static int g_frame_index = 0;
+static bool g_frame_playing = false;
+
+void PosixPlatformConfigure(const posix_platform_config_t* config) {
+    g_config = *config;
+}
+
+uint64_t PosixPlatformPointCount(void) {
+    return g_points_written;
+}
+
+uint64_t PosixPlatformInputBlocks(void) {
+    return g_input_blocks;
+}
+
+const engine_audio_analyzer_t* PosixPlatformAudioAnalyzer(void) {
+    return &g_audio_analyzer;
+}
+
+void PlatformStart(void) {
+    for (int i = 0; i < SYNTH_TABLE_SCANS; ++i) {
+        const double t = (double)i / SYNTH_TABLE_SCANS;
+        g_synth_scans[i * SYNTH_CHANNELS] =
+            (uint16_t)(ADC_IN_MIDPOINT + ADC_IN_MIDPOINT * sin(SYNTH_TWO_PI * SYNTH_FREQ_LEFT_HZ * t));
+        g_synth_scans[i * SYNTH_CHANNELS + 1] =
+            (uint16_t)(ADC_IN_MIDPOINT + ADC_IN_MIDPOINT * sin(SYNTH_TWO_PI * SYNTH_FREQ_RIGHT_HZ * t));
+    }
+    g_synth_idx = 0;
+    AudioDecimatorInit(&g_synth_left);
+    AudioDecimatorInit(&g_synth_right);
+    InitAudioAnalyzer(&g_audio_analyzer);
+    g_input_blocks = 0;
+    g_points_written = 0;
+}
+
+static bool ReadRecordedFrame(engine_inputs_t* frame) {
+    int values[5];
+    if (fscanf(g_config.input, " %d , %d , %d , %d , %d", &values[0], &values[1],
+               &values[2], &values[3], &values[4]) != 5) {
+        return false;
+    }
+    frame->audio_in_left = (int16_t)values[0];
+    frame->audio_in_right = (int16_t)values[1];
+    frame->cv_in_left = (int16_t)values[2];
+    frame->cv_in_middle = (int16_t)values[3];
+    frame->cv_in_right = (int16_t)values[4];
+    return true;
+}
+
+// The next block from the recording or the synthetic signal, false once the recording ends.
+static bool ReadInputFrames(engine_inputs_t* inputs) {
+    for (int i = 0; i < INPUT_BLOCK_FRAMES; ++i) {
+        if (g_config.input != NULL) {
+            if (!ReadRecordedFrame(&inputs[i])) {
+                return false;
+            }
+        } else {
+            const uint16_t* scans = &g_synth_scans[g_synth_idx * AUDIO_OVERSAMPLE * SYNTH_CHANNELS];
+            inputs[i] = g_config.synthetic;
+            inputs[i].audio_in_left = AudioDecimate(&g_synth_left, &scans[0], SYNTH_CHANNELS);
+            inputs[i].audio_in_right = AudioDecimate(&g_synth_right, &scans[1], SYNTH_CHANNELS);
+            g_synth_idx = (g_synth_idx + 1) % SYNTH_TABLE_FRAMES;
+        }
+    }
+    return true;
+}
+
+/*
+ * The points written are the host's clock, as the output clock is the
+ * target's: the ADC lands a block every INPUT_BLOCK_FRAMES frames of their
+ * time. Every block due by then is read and analysed, as the target's input
+ * thread would, and the engine gets the last. A block the output stages
+ * stretch over several output blocks skips input blocks, like on the target.
+ */
+bool PlatformReadInputBlock(engine_inputs_t* inputs, engine_audio_features_t* audio) {
+    if (g_config.num_points != 0 && g_points_written >= g_config.num_points) {
+        return false;
+    }
+    const uint64_t due = g_points_written * ADC_SAMPLE_RATE_DEFAULT_HZ / OUTPUT_RATE_DEFAULT_HZ / INPUT_BLOCK_FRAMES + 1;
+    while (g_input_blocks < due) {
+        if (!ReadInputFrames(g_input_frames)) {
+            return false;
+        }
+        AnalyzeAudioBlock(&g_audio_analyzer, g_input_frames, INPUT_BLOCK_FRAMES);
+        ++g_input_blocks;
+    }
+    for (int i = 0; i < INPUT_BLOCK_FRAMES; ++i) {
+        inputs[i] = g_input_frames[i];
+    }
+    *audio = g_audio_analyzer.features;
+    return true;
+}
+
+static void SinkPoints(const int16_t* x, const int16_t* y, const int16_t* r, const int16_t* g, const int16_t* b,
+                       const packed_point_t* packed, const int n) {
+    packed_point_t checksum = g_sink_checksum;
+    for (int i = 0; i < n; ++i) {
+        checksum ^= packed[i];
+    }
+    g_sink_checksum = checksum;
+
+    if (g_config.output != NULL) {
+        for (int i = 0; i < n; ++i) {
+            fprintf(g_config.output, "%d,%d,%d,%d,%d\n", x[i], y[i], r[i], g[i], b[i]);
+        }
+    }
+    g_points_written += (uint64_t)n;
+}
+
+void PlatformWriteOutputBlock(const engine_output_block_t* outputs) {
+    // Same encoding work as the target's QueueOutputBlock().
+    PROFILE_SCOPE(PROFILE_OUTPUT) {
+        PackPointBlock(outputs, g_packed, OUTPUT_BLOCK_SIZE);
+    }
+    SinkPoints(outputs->x, outputs->y, outputs->r, outputs->g, outputs->b, g_packed, OUTPUT_BLOCK_SIZE);
+}
+
+// Plays n frame points from the current position, wrapping at the end of the loop.
+static void PlayFramePoints(int n) {
+    while (n > 0) {
+        const int run = g_frame_length - g_frame_index < n ? g_frame_length - g_frame_index : n;
+        const int i = g_frame_index;
+        SinkPoints(&g_frame_x[i], &g_frame_y[i], &g_frame_r[i], &g_frame_g[i], &g_frame_b[i], &g_frame_packed[i], run);
+        g_frame_index = (g_frame_index + run) % g_frame_length;
+        n -= run;
+    }
+}
+
+bool PlatformBeginFrame(void) {
+    g_frame_length = 0;
+    return true;
+}
+
+bool PlatformAppendFrame(const engine_output_block_t* outputs, const int n) {
+    if (g_frame_length + n > OUTPUT_FRAME_MAX_POINTS) {
+        return false;
+    }
+    PackPointBlock(outputs, &g_frame_packed[g_frame_length], (uint32_t)n);
+    for (int i = 0; i < n; ++i) {
+        g_frame_x[g_frame_length + i] = outputs->x[i];
+        g_frame_y[g_frame_length + i] = outputs->y[i];
+        g_frame_r[g_frame_length + i] = outputs->r[i];
+        g_frame_g[g_frame_length + i] = outputs->g[i];
+        g_frame_b[g_frame_length + i] = outputs->b[i];
+    }
+    g_frame_length += n;
+    return true;
+}
+
+void PlatformPlayFrame(void) {
+    g_frame_index = 0;
+    g_frame_playing = g_frame_length > 0;
+}
+
+// The target ISR finishes the pass before going back to the stream, so does this.
+void PlatformStopFrame(void) {
+    if (g_frame_playing && g_frame_index != 0) {
+        PlayFramePoints(g_frame_length - g_frame_index);
+    }
+    g_frame_playing = false;
+}
+
+void PlatformWaitFrame(void) {
+    if (g_frame_playing) {
+        PlayFramePoints(INPUT_BLOCK_FRAMES);
+    }
+}
+
+// Nanoseconds from CLOCK_MONOTONIC.
+uint32_t PlatformCycles(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec);
+}
+
+uint32_t PlatformCyclesPerSecond(void) {
+    return 1000000000u;
+}
@@ -0,0 +1,62 @@
+#include "point_ring.h"
+
+void PointRingInit(point_ring_t* ring) {
+    atomic_init(&ring->head, 0);
+    atomic_init(&ring->tail, 0);
+    ring->overruns = 0;
+    ring->underruns = 0;
+}
+
+bool PointRingPush(point_ring_t* ring, const packed_point_t point) {
+    const uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    const uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if ((uint32_t)(head - tail) >= POINT_RING_SIZE) {
+        ++ring->overruns;
+        return false;
+    }
+    ring->points[head & POINT_RING_MASK] = point;
+    atomic_store_explicit(&ring->head, head + 1u, memory_order_release);
+    return true;
+}
+
+bool PointRingPushBlock(point_ring_t* ring, const packed_point_t* points, const uint32_t n) {
+    const uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    const uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if ((uint32_t)(head - tail) + n > POINT_RING_SIZE) {
+        ++ring->overruns;
+        return false;
+    }
+    for (uint32_t i = 0; i < n; ++i) {
+        ring->points[(head + i) & POINT_RING_MASK] = points[i];
+    }
+    atomic_store_explicit(&ring->head, head + n, memory_order_release);
+    return true;
+}
+
+bool PointRingPop(point_ring_t* ring, packed_point_t* point) {
+    const uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    const uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    if (head == tail) {
+        ++ring->underruns;
+        return false;
+    }
+    *point = ring->points[tail & POINT_RING_MASK];
+    atomic_store_explicit(&ring->tail, tail + 1u, memory_order_release);
+    return true;
+}
+
+uint32_t PointRingCount(point_ring_t* ring) {
+    const uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    const uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    return (uint32_t)(head - tail);
+}
+
+void PackPointBlock(const engine_output_block_t* outputs, packed_point_t* points, const uint32_t n) {
+    for (uint32_t i = 0; i < n; ++i) {
+        points[i] = (packed_point_t)DacCommandWord(outputs->x[i], DAC_CMD_CH1)
+                  | ((packed_point_t)DacCommandWord(outputs->y[i], DAC_CMD_CH2) << 16)
+                  | ((packed_point_t)LaserDutyFromLevel(outputs->r[i]) << PACKED_POINT_R_SHIFT)
+                  | ((packed_point_t)LaserDutyFromLevel(outputs->g[i]) << PACKED_POINT_G_SHIFT)
+                  | ((packed_point_t)LaserDutyFromLevel(outputs->b[i]) << PACKED_POINT_B_SHIFT);
+    }
+}
@@ -0,0 +1,38 @@
+#include <stddef.h>
+
+#include "profile.h"
+
+#if ENABLE_PROFILING
+
+static profile_stats_t g_profile_stats[PROFILE_NUM_SLOTS];
+
+// Each slot has a single writer (one thread or one ISR), so no locking.
+void ProfileRecord(const unsigned slot, const uint32_t cycles) {
+    if (slot >= PROFILE_NUM_SLOTS) {
+        return;
+    }
+    profile_stats_t* stats = &g_profile_stats[slot];
+    if (stats->count == 0 || cycles < stats->min) {
+        stats->min = cycles;
+    }
+    if (cycles > stats->max) {
+        stats->max = cycles;
+    }
+    ++stats->count;
+    stats->total += cycles;
+
+    const unsigned bin = cycles == 0 ? 0 : 31 - (unsigned)__builtin_clz(cycles);
+    ++stats->histogram[bin < PROFILE_HIST_BINS ? bin : PROFILE_HIST_BINS - 1];
+}
+
+const profile_stats_t* ProfileGetStats(const unsigned slot) {
+    return slot < PROFILE_NUM_SLOTS ? &g_profile_stats[slot] : NULL;
+}
+
+void ProfileReset(void) {
+    for (unsigned i = 0; i < PROFILE_NUM_SLOTS; ++i) {
+        g_profile_stats[i] = (profile_stats_t){0};
+    }
+}
+
+#endif
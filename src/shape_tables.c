@@ -0,0 +1,169 @@
+// Generated by resources/shapes/make_shape_tables.py, do not edit.
+#include "shape_tables.h"
+
+// round(32767 * (cos, sin)(2 * PI * i / 512)) for i in 0..512, in flash.
+const shape_point_t g_shape_circle[SHAPE_CIRCLE_SIZE + 1] = {
+    { 32767,      0}, { 32765,    402}, { 32757,    804}, { 32745,   1206},
+    { 32728,   1608}, { 32705,   2009}, { 32678,   2410}, { 32646,   2811},
+    { 32609,   3212}, { 32567,   3612}, { 32521,   4011}, { 32469,   4410},
+    { 32412,   4808}, { 32351,   5205}, { 32285,   5602}, { 32213,   5998},
+    { 32137,   6393}, { 32057,   6786}, { 31971,   7179}, { 31880,   7571},
+    { 31785,   7962}, { 31685,   8351}, { 31580,   8739}, { 31470,   9126},
+    { 31356,   9512}, { 31237,   9896}, { 31113,  10278}, { 30985,  10659},
+    { 30852,  11039}, { 30714,  11417}, { 30571,  11793}, { 30424,  12167},
+    { 30273,  12539}, { 30117,  12910}, { 29956,  13279}, { 29791,  13645},
+    { 29621,  14010}, { 29447,  14372}, { 29268,  14732}, { 29085,  15090},
+    { 28898,  15446}, { 28706,  15800}, { 28510,  16151}, { 28310,  16499},
+    { 28105,  16846}, { 27896,  17189}, { 27683,  17530}, { 27466,  17869},
+    { 27245,  18204}, { 27019,  18537}, { 26790,  18868}, { 26556,  19195},
+    { 26319,  19519}, { 26077,  19841}, { 25832,  20159}, { 25582,  20475},
+    { 25329,  20787}, { 25072,  21096}, { 24811,  21403}, { 24547,  21705},
+    { 24279,  22005}, { 24007,  22301}, { 23731,  22594}, { 23452,  22884},
+    { 23170,  23170}, { 22884,  23452}, { 22594,  23731}, { 22301,  24007},
+    { 22005,  24279}, { 21705,  24547}, { 21403,  24811}, { 21096,  25072},
+    { 20787,  25329}, { 20475,  25582}, { 20159,  25832}, { 19841,  26077},
+    { 19519,  26319}, { 19195,  26556}, { 18868,  26790}, { 18537,  27019},
+    { 18204,  27245}, { 17869,  27466}, { 17530,  27683}, { 17189,  27896},
+    { 16846,  28105}, { 16499,  28310}, { 16151,  28510}, { 15800,  28706},
+    { 15446,  28898}, { 15090,  29085}, { 14732,  29268}, { 14372,  29447},
+    { 14010,  29621}, { 13645,  29791}, { 13279,  29956}, { 12910,  30117},
+    { 12539,  30273}, { 12167,  30424}, { 11793,  30571}, { 11417,  30714},
+    { 11039,  30852}, { 10659,  30985}, { 10278,  31113}, {  9896,  31237},
+    {  9512,  31356}, {  9126,  31470}, {  8739,  31580}, {  8351,  31685},
+    {  7962,  31785}, {  7571,  31880}, {  7179,  31971}, {  6786,  32057},
+    {  6393,  32137}, {  5998,  32213}, {  5602,  32285}, {  5205,  32351},
+    {  4808,  32412}, {  4410,  32469}, {  4011,  32521}, {  3612,  32567},
+    {  3212,  32609}, {  2811,  32646}, {  2410,  32678}, {  2009,  32705},
+    {  1608,  32728}, {  1206,  32745}, {   804,  32757}, {   402,  32765},
+    {     0,  32767}, {  -402,  32765}, {  -804,  32757}, { -1206,  32745},
+    { -1608,  32728}, { -2009,  32705}, { -2410,  32678}, { -2811,  32646},
+    { -3212,  32609}, { -3612,  32567}, { -4011,  32521}, { -4410,  32469},
+    { -4808,  32412}, { -5205,  32351}, { -5602,  32285}, { -5998,  32213},
+    { -6393,  32137}, { -6786,  32057}, { -7179,  31971}, { -7571,  31880},
+    { -7962,  31785}, { -8351,  31685}, { -8739,  31580}, { -9126,  31470},
+    { -9512,  31356}, { -9896,  31237}, {-10278,  31113}, {-10659,  30985},
+    {-11039,  30852}, {-11417,  30714}, {-11793,  30571}, {-12167,  30424},
+    {-12539,  30273}, {-12910,  30117}, {-13279,  29956}, {-13645,  29791},
+    {-14010,  29621}, {-14372,  29447}, {-14732,  29268}, {-15090,  29085},
+    {-15446,  28898}, {-15800,  28706}, {-16151,  28510}, {-16499,  28310},
+    {-16846,  28105}, {-17189,  27896}, {-17530,  27683}, {-17869,  27466},
+    {-18204,  27245}, {-18537,  27019}, {-18868,  26790}, {-19195,  26556},
+    {-19519,  26319}, {-19841,  26077}, {-20159,  25832}, {-20475,  25582},
+    {-20787,  25329}, {-21096,  25072}, {-21403,  24811}, {-21705,  24547},
+    {-22005,  24279}, {-22301,  24007}, {-22594,  23731}, {-22884,  23452},
+    {-23170,  23170}, {-23452,  22884}, {-23731,  22594}, {-24007,  22301},
+    {-24279,  22005}, {-24547,  21705}, {-24811,  21403}, {-25072,  21096},
+    {-25329,  20787}, {-25582,  20475}, {-25832,  20159}, {-26077,  19841},
+    {-26319,  19519}, {-26556,  19195}, {-26790,  18868}, {-27019,  18537},
+    {-27245,  18204}, {-27466,  17869}, {-27683,  17530}, {-27896,  17189},
+    {-28105,  16846}, {-28310,  16499}, {-28510,  16151}, {-28706,  15800},
+    {-28898,  15446}, {-29085,  15090}, {-29268,  14732}, {-29447,  14372},
+    {-29621,  14010}, {-29791,  13645}, {-29956,  13279}, {-30117,  12910},
+    {-30273,  12539}, {-30424,  12167}, {-30571,  11793}, {-30714,  11417},
+    {-30852,  11039}, {-30985,  10659}, {-31113,  10278}, {-31237,   9896},
+    {-31356,   9512}, {-31470,   9126}, {-31580,   8739}, {-31685,   8351},
+    {-31785,   7962}, {-31880,   7571}, {-31971,   7179}, {-32057,   6786},
+    {-32137,   6393}, {-32213,   5998}, {-32285,   5602}, {-32351,   5205},
+    {-32412,   4808}, {-32469,   4410}, {-32521,   4011}, {-32567,   3612},
+    {-32609,   3212}, {-32646,   2811}, {-32678,   2410}, {-32705,   2009},
+    {-32728,   1608}, {-32745,   1206}, {-32757,    804}, {-32765,    402},
+    {-32767,      0}, {-32765,   -402}, {-32757,   -804}, {-32745,  -1206},
+    {-32728,  -1608}, {-32705,  -2009}, {-32678,  -2410}, {-32646,  -2811},
+    {-32609,  -3212}, {-32567,  -3612}, {-32521,  -4011}, {-32469,  -4410},
+    {-32412,  -4808}, {-32351,  -5205}, {-32285,  -5602}, {-32213,  -5998},
+    {-32137,  -6393}, {-32057,  -6786}, {-31971,  -7179}, {-31880,  -7571},
+    {-31785,  -7962}, {-31685,  -8351}, {-31580,  -8739}, {-31470,  -9126},
+    {-31356,  -9512}, {-31237,  -9896}, {-31113, -10278}, {-30985, -10659},
+    {-30852, -11039}, {-30714, -11417}, {-30571, -11793}, {-30424, -12167},
+    {-30273, -12539}, {-30117, -12910}, {-29956, -13279}, {-29791, -13645},
+    {-29621, -14010}, {-29447, -14372}, {-29268, -14732}, {-29085, -15090},
+    {-28898, -15446}, {-28706, -15800}, {-28510, -16151}, {-28310, -16499},
+    {-28105, -16846}, {-27896, -17189}, {-27683, -17530}, {-27466, -17869},
+    {-27245, -18204}, {-27019, -18537}, {-26790, -18868}, {-26556, -19195},
+    {-26319, -19519}, {-26077, -19841}, {-25832, -20159}, {-25582, -20475},
+    {-25329, -20787}, {-25072, -21096}, {-24811, -21403}, {-24547, -21705},
+    {-24279, -22005}, {-24007, -22301}, {-23731, -22594}, {-23452, -22884},
+    {-23170, -23170}, {-22884, -23452}, {-22594, -23731}, {-22301, -24007},
+    {-22005, -24279}, {-21705, -24547}, {-21403, -24811}, {-21096, -25072},
+    {-20787, -25329}, {-20475, -25582}, {-20159, -25832}, {-19841, -26077},
+    {-19519, -26319}, {-19195, -26556}, {-18868, -26790}, {-18537, -27019},
+    {-18204, -27245}, {-17869, -27466}, {-17530, -27683}, {-17189, -27896},
+    {-16846, -28105}, {-16499, -28310}, {-16151, -28510}, {-15800, -28706},
+    {-15446, -28898}, {-15090, -29085}, {-14732, -29268}, {-14372, -29447},
+    {-14010, -29621}, {-13645, -29791}, {-13279, -29956}, {-12910, -30117},
+    {-12539, -30273}, {-12167, -30424}, {-11793, -30571}, {-11417, -30714},
+    {-11039, -30852}, {-10659, -30985}, {-10278, -31113}, { -9896, -31237},
+    { -9512, -31356}, { -9126, -31470}, { -8739, -31580}, { -8351, -31685},
+    { -7962, -31785}, { -7571, -31880}, { -7179, -31971}, { -6786, -32057},
+    { -6393, -32137}, { -5998, -32213}, { -5602, -32285}, { -5205, -32351},
+    { -4808, -32412}, { -4410, -32469}, { -4011, -32521}, { -3612, -32567},
+    { -3212, -32609}, { -2811, -32646}, { -2410, -32678}, { -2009, -32705},
+    { -1608, -32728}, { -1206, -32745}, {  -804, -32757}, {  -402, -32765},
+    {     0, -32767}, {   402, -32765}, {   804, -32757}, {  1206, -32745},
+    {  1608, -32728}, {  2009, -32705}, {  2410, -32678}, {  2811, -32646},
+    {  3212, -32609}, {  3612, -32567}, {  4011, -32521}, {  4410, -32469},
+    {  4808, -32412}, {  5205, -32351}, {  5602, -32285}, {  5998, -32213},
+    {  6393, -32137}, {  6786, -32057}, {  7179, -31971}, {  7571, -31880},
+    {  7962, -31785}, {  8351, -31685}, {  8739, -31580}, {  9126, -31470},
+    {  9512, -31356}, {  9896, -31237}, { 10278, -31113}, { 10659, -30985},
+    { 11039, -30852}, { 11417, -30714}, { 11793, -30571}, { 12167, -30424},
+    { 12539, -30273}, { 12910, -30117}, { 13279, -29956}, { 13645, -29791},
+    { 14010, -29621}, { 14372, -29447}, { 14732, -29268}, { 15090, -29085},
+    { 15446, -28898}, { 15800, -28706}, { 16151, -28510}, { 16499, -28310},
+    { 16846, -28105}, { 17189, -27896}, { 17530, -27683}, { 17869, -27466},
+    { 18204, -27245}, { 18537, -27019}, { 18868, -26790}, { 19195, -26556},
+    { 19519, -26319}, { 19841, -26077}, { 20159, -25832}, { 20475, -25582},
+    { 20787, -25329}, { 21096, -25072}, { 21403, -24811}, { 21705, -24547},
+    { 22005, -24279}, { 22301, -24007}, { 22594, -23731}, { 22884, -23452},
+    { 23170, -23170}, { 23452, -22884}, { 23731, -22594}, { 24007, -22301},
+    { 24279, -22005}, { 24547, -21705}, { 24811, -21403}, { 25072, -21096},
+    { 25329, -20787}, { 25582, -20475}, { 25832, -20159}, { 26077, -19841},
+    { 26319, -19519}, { 26556, -19195}, { 26790, -18868}, { 27019, -18537},
+    { 27245, -18204}, { 27466, -17869}, { 27683, -17530}, { 27896, -17189},
+    { 28105, -16846}, { 28310, -16499}, { 28510, -16151}, { 28706, -15800},
+    { 28898, -15446}, { 29085, -15090}, { 29268, -14732}, { 29447, -14372},
+    { 29621, -14010}, { 29791, -13645}, { 29956, -13279}, { 30117, -12910},
+    { 30273, -12539}, { 30424, -12167}, { 30571, -11793}, { 30714, -11417},
+    { 30852, -11039}, { 30985, -10659}, { 31113, -10278}, { 31237,  -9896},
+    { 31356,  -9512}, { 31470,  -9126}, { 31580,  -8739}, { 31685,  -8351},
+    { 31785,  -7962}, { 31880,  -7571}, { 31971,  -7179}, { 32057,  -6786},
+    { 32137,  -6393}, { 32213,  -5998}, { 32285,  -5602}, { 32351,  -5205},
+    { 32412,  -4808}, { 32469,  -4410}, { 32521,  -4011}, { 32567,  -3612},
+    { 32609,  -3212}, { 32646,  -2811}, { 32678,  -2410}, { 32705,  -2009},
+    { 32728,  -1608}, { 32745,  -1206}, { 32757,   -804}, { 32765,   -402},
+    { 32767,      0},
+};
+
+// round(32767 * (cos, sin)(2 * PI * i / 120)) for i in 0..119, in flash.
+const shape_point_t g_shape_circle_starry[SHAPE_STARRY_POINTS] = {
+    { 32767,      0}, { 32722,   1715}, { 32587,   3425}, { 32364,   5126},
+    { 32051,   6813}, { 31650,   8481}, { 31163,  10126}, { 30591,  11743},
+    { 29934,  13328}, { 29196,  14876}, { 28377,  16383}, { 27481,  17846},
+    { 26509,  19260}, { 25465,  20621}, { 24351,  21925}, { 23170,  23170},
+    { 21925,  24351}, { 20621,  25465}, { 19260,  26509}, { 17846,  27481},
+    { 16384,  28377}, { 14876,  29196}, { 13328,  29934}, { 11743,  30591},
+    { 10126,  31163}, {  8481,  31650}, {  6813,  32051}, {  5126,  32364},
+    {  3425,  32587}, {  1715,  32722}, {     0,  32767}, { -1715,  32722},
+    { -3425,  32587}, { -5126,  32364}, { -6813,  32051}, { -8481,  31650},
+    {-10126,  31163}, {-11743,  30591}, {-13328,  29934}, {-14876,  29196},
+    {-16383,  28377}, {-17846,  27481}, {-19260,  26509}, {-20621,  25465},
+    {-21925,  24351}, {-23170,  23170}, {-24351,  21925}, {-25465,  20621},
+    {-26509,  19260}, {-27481,  17846}, {-28377,  16383}, {-29196,  14876},
+    {-29934,  13328}, {-30591,  11743}, {-31163,  10126}, {-31650,   8481},
+    {-32051,   6813}, {-32364,   5126}, {-32587,   3425}, {-32722,   1715},
+    {-32767,      0}, {-32722,  -1715}, {-32587,  -3425}, {-32364,  -5126},
+    {-32051,  -6813}, {-31650,  -8481}, {-31163, -10126}, {-30591, -11743},
+    {-29934, -13328}, {-29196, -14876}, {-28377, -16383}, {-27481, -17846},
+    {-26509, -19260}, {-25465, -20621}, {-24351, -21925}, {-23170, -23170},
+    {-21925, -24351}, {-20621, -25465}, {-19260, -26509}, {-17846, -27481},
+    {-16384, -28377}, {-14876, -29196}, {-13328, -29934}, {-11743, -30591},
+    {-10126, -31163}, { -8481, -31650}, { -6813, -32051}, { -5126, -32364},
+    { -3425, -32587}, { -1715, -32722}, {     0, -32767}, {  1715, -32722},
+    {  3425, -32587}, {  5126, -32364}, {  6813, -32051}, {  8481, -31650},
+    { 10126, -31163}, { 11743, -30591}, { 13328, -29934}, { 14876, -29196},
+    { 16384, -28377}, { 17846, -27481}, { 19260, -26509}, { 20621, -25465},
+    { 21925, -24351}, { 23170, -23170}, { 24351, -21925}, { 25465, -20621},
+    { 26509, -19260}, { 27481, -17846}, { 28377, -16383}, { 29196, -14876},
+    { 29934, -13328}, { 30591, -11743}, { 31163, -10126}, { 31650,  -8481},
+    { 32051,  -6813}, { 32364,  -5126}, { 32587,  -3425}, { 32722,  -1715},
+};
@@ -0,0 +1,145 @@
+#include "engine.h"
+#include "shape_tables.h"
+#include "spectrum.h"
+
+// ADC offsets from the midpoint to Q15, the widest of +-2047 counts comes to half scale.
+#define SPECTRUM_INPUT_SHIFT    3
+#define SPECTRUM_CIRCLE_STRIDE  (SHAPE_CIRCLE_SIZE / SPECTRUM_FFT_SIZE)
+#define SPECTRUM_ROUND          (1 << 14)
+
+_Static_assert(SPECTRUM_FFT_BITS == 8, "BitReverse() reverses 8 bits");
+_Static_assert(SHAPE_CIRCLE_SIZE % SPECTRUM_FFT_SIZE == 0, "Twiddles and window are read from g_shape_circle");
+
+// round(2 ^ (7 * band / 16)), made to increase by at least one bin.
+const uint8_t g_spectrum_band_edges[SPECTRUM_NUM_BANDS + 1] = {
+    1, 2, 3, 4, 5, 6, 7, 8, 11, 15, 21, 28, 38, 52, 70, 95, 128
+};
+
+static inline uint16_t BitReverse(uint16_t value) {
+    value = (uint16_t)(((value & 0xF0u) >> 4) | ((value & 0x0Fu) << 4));
+    value = (uint16_t)(((value & 0xCCu) >> 2) | ((value & 0x33u) << 2));
+    return (uint16_t)(((value & 0xAAu) >> 1) | ((value & 0x55u) << 1));
+}
+
+// Magnitude to its level in the SPECTRUM_RANGE_LOG2 octaves below full scale, by a piecewise linear log2.
+static q15_t SpectrumLevel(const uint32_t magnitude) {
+    if (magnitude == 0) {
+        return 0;
+    }
+    const int32_t above_floor = Log2Q8(magnitude) - ((SPECTRUM_FULL_SCALE_LOG2 - SPECTRUM_RANGE_LOG2) << 8);
+    if (above_floor <= 0) {
+        return 0;
+    }
+    return SatQ15((above_floor << 15) / (SPECTRUM_RANGE_LOG2 << 8));
+}
+
+void SpectrumAnalyzerInit(spectrum_analyzer_t* analyzer) {
+    *analyzer = (spectrum_analyzer_t){0};
+    analyzer->stage = SPECTRUM_FFT_BITS + 1;
+}
+
+void SpectrumAnalyzerPush(spectrum_analyzer_t* analyzer, const int16_t left, const int16_t right) {
+    // Periodic Hann window, (1 - cos) / 2.
+    const uint16_t n = analyzer->captured;
+    const int32_t window = (Q15_ONE - g_shape_circle[n * SPECTRUM_CIRCLE_STRIDE].x + 1) >> 1;
+    const int32_t re = (int32_t)(left - ADC_IN_MIDPOINT) << SPECTRUM_INPUT_SHIFT;
+    const int32_t im = (int32_t)(right - ADC_IN_MIDPOINT) << SPECTRUM_INPUT_SHIFT;
+    spectrum_complex_t* slot = &analyzer->buffer[analyzer->capture][BitReverse(n)];
+    slot->re = (int16_t)((re * window + SPECTRUM_ROUND) >> 15);
+    slot->im = (int16_t)((im * window + SPECTRUM_ROUND) >> 15);
+    if (++analyzer->captured < SPECTRUM_FFT_SIZE) {
+        return;
+    }
+
+    if (analyzer->stage <= SPECTRUM_FFT_BITS) {
+        SpectrumAnalyzerRun(analyzer, SPECTRUM_JOB_WORK);
+        ++analyzer->overruns;
+    }
+    analyzer->capture ^= 1;
+    analyzer->captured = 0;
+    analyzer->stage = 0;
+    analyzer->index = 0;
+    for (int channel = 0; channel < SPECTRUM_NUM_CHANNELS; ++channel) {
+        for (int band = 0; band < SPECTRUM_NUM_BANDS; ++band) {
+            analyzer->peak[channel][band] = 0;
+        }
+    }
+}
+
+// Butterflies [first, first + count) of one stage, each output halved.
+static void FftButterflies(spectrum_complex_t* data, const int stage, const int first, const int count) {
+    const int half = 1 << stage;
+    const int twiddle_step = SHAPE_CIRCLE_SIZE >> (stage + 1);
+    for (int butterfly = first; butterfly < first + count; ++butterfly) {
+        const int j = butterfly & (half - 1);
+        const int i0 = ((butterfly >> stage) << (stage + 1)) | j;
+        const int i1 = i0 + half;
+        // x1 times exp(-i * angle), the circle holds (cos, sin) of +angle.
+        const shape_point_t w = g_shape_circle[j * twiddle_step];
+        const spectrum_complex_t x0 = data[i0];
+        const spectrum_complex_t x1 = data[i1];
+        const int32_t t_re = ((int32_t)w.x * x1.re + (int32_t)w.y * x1.im + SPECTRUM_ROUND) >> 15;
+        const int32_t t_im = ((int32_t)w.x * x1.im - (int32_t)w.y * x1.re + SPECTRUM_ROUND) >> 15;
+        data[i0].re = (int16_t)((x0.re + t_re + 1) >> 1);
+        data[i0].im = (int16_t)((x0.im + t_im + 1) >> 1);
+        data[i1].re = (int16_t)((x0.re - t_re + 1) >> 1);
+        data[i1].im = (int16_t)((x0.im - t_im + 1) >> 1);
+    }
+}
+
+/*
+ * Splits bin k of the packed transform z into the two channels,
+ * L = (z[k] + conj(z[N - k])) / 2 and R = (z[k] - conj(z[N - k])) / 2i,
+ * and keeps each band's loudest bin.
+ */
+static void SplitBin(spectrum_analyzer_t* analyzer, const spectrum_complex_t* data, const int k) {
+    const spectrum_complex_t z = data[k];
+    const spectrum_complex_t mirror = data[SPECTRUM_FFT_SIZE - k];
+    const uint32_t left = SpectrumMagnitude(z.re + mirror.re, z.im - mirror.im) >> 1;
+    const uint32_t right = SpectrumMagnitude(z.im + mirror.im, z.re - mirror.re) >> 1;
+
+    int band = 0;
+    while (k >= g_spectrum_band_edges[band + 1]) {
+        ++band;
+    }
+    uint16_t* peak = &analyzer->peak[0][band];
+    *peak = left > *peak ? (uint16_t)left : *peak;
+    peak = &analyzer->peak[1][band];
+    *peak = right > *peak ? (uint16_t)right : *peak;
+}
+
+bool SpectrumAnalyzerRun(spectrum_analyzer_t* analyzer, int work) {
+    spectrum_complex_t* data = analyzer->buffer[analyzer->capture ^ 1];
+    while (work > 0 && analyzer->stage < SPECTRUM_FFT_BITS) {
+        const int left = SPECTRUM_FFT_SIZE / 2 - analyzer->index;
+        const int count = work < left ? work : left;
+        FftButterflies(data, analyzer->stage, analyzer->index, count);
+        work -= count;
+        analyzer->index = (uint16_t)(analyzer->index + count);
+        if (analyzer->index == SPECTRUM_FFT_SIZE / 2) {
+            ++analyzer->stage;
+            // Bin 0 is DC, in no band.
+            analyzer->index = analyzer->stage == SPECTRUM_FFT_BITS ? 1 : 0;
+        }
+    }
+    if (analyzer->stage != SPECTRUM_FFT_BITS) {
+        return false;
+    }
+
+    while (work > 0 && analyzer->index < SPECTRUM_FFT_SIZE / 2) {
+        SplitBin(analyzer, data, analyzer->index);
+        ++analyzer->index;
+        --work;
+    }
+    if (analyzer->index < SPECTRUM_FFT_SIZE / 2) {
+        return false;
+    }
+    for (int channel = 0; channel < SPECTRUM_NUM_CHANNELS; ++channel) {
+        for (int band = 0; band < SPECTRUM_NUM_BANDS; ++band) {
+            analyzer->level[channel][band] = SpectrumLevel(analyzer->peak[channel][band]);
+        }
+    }
+    ++analyzer->stage;
+    ++analyzer->spectra;
+    return true;
+}